@@ -8,6 +8,7 @@ AssocMatrix::AssocMatrix(int N) {
   Nnz = 0;
   rowassign = new int[N];
   colassign = new int[N];
+  rowcap = colcap = N;
   std:: fill (rowassign, rowassign+N, -1);
   std:: fill (colassign, colassign+N, -1);
 }
@@ -18,10 +19,24 @@ AssocMatrix::AssocMatrix(int N, int M) {
   Nnz = 0;
   rowassign = new int[Ncols];
   colassign = new int[Nrows];
+  rowcap = Ncols;
+  colcap = Nrows;
   std:: fill (rowassign, rowassign+Ncols, -1);
   std:: fill (colassign, colassign+Nrows, -1);
 }
 
+AssocMatrix::AssocMatrix(const AssocMatrix& x) {
+  Nrows = x.Nrows;
+  Ncols = x.Ncols;
+  Nnz = x.Nnz;
+  rowassign = new int[Ncols];
+  colassign = new int[Nrows];
+  rowcap = Ncols;
+  colcap = Nrows;
+  std:: copy (x.rowassign, x.rowassign+Ncols, rowassign);
+  std:: copy (x.colassign, x.colassign+Nrows, colassign);
+}
+
 // destructor
 AssocMatrix::~AssocMatrix() {
   delete [] colassign;
@@ -70,6 +85,7 @@ void AssocMatrix::transpose() {
   int* temp2 = rowassign;
   rowassign  = colassign;
   colassign  = temp2;
+  std:: swap (rowcap, colcap);
 };
 
 void AssocMatrix::blank() {
@@ -79,6 +95,73 @@ void AssocMatrix::blank() {
     Nnz = 0;
 };
 
+void AssocMatrix::resize(int N, int M) {
+  if (M > rowcap) {
+    delete [] rowassign;
+    rowassign = new int[M];
+    rowcap = M;
+  }
+  if (N > colcap) {
+    delete [] colassign;
+    colassign = new int[N];
+    colcap = N;
+  }
+  Nrows = N;
+  Ncols = M;
+  blank();
+}
+
+void AssocMatrix::regrow(int*& a, int& cap, int used, int size) {
+  if (size <= cap) return;
+  int *b = new int[std:: max(size, 2*cap)];
+  std:: copy (a, a+used, b);
+  delete [] a;
+  a = b;
+  cap = std:: max(size, 2*cap);
+}
+
+void AssocMatrix::add_rows(int count) {
+  regrow (colassign, colcap, Nrows, Nrows+count);
+  std:: fill (colassign+Nrows, colassign+Nrows+count, -1);
+  Nrows += count;
+}
+
+void AssocMatrix::add_cols(int count) {
+  regrow (rowassign, rowcap, Ncols, Ncols+count);
+  std:: fill (rowassign+Ncols, rowassign+Ncols+count, -1);
+  Ncols += count;
+}
+
+// The removed rows free their columns, and the rows above them are
+// shifted down, both in colassign and in the row numbers of rowassign.
+void AssocMatrix::remove_rows(int first, int count) {
+  int i, j, last = first+count;
+  for (i = first; i < last; i++) {
+    if (colassign[i] != -1) {
+      rowassign[colassign[i]] = -1;
+      Nnz--;
+    }
+  }
+  std:: copy (colassign+last, colassign+Nrows, colassign+first);
+  Nrows -= count;
+  for (j = 0; j < Ncols; j++)
+    if (rowassign[j] >= last) rowassign[j] -= count;
+}
+
+void AssocMatrix::remove_cols(int first, int count) {
+  int i, j, last = first+count;
+  for (j = first; j < last; j++) {
+    if (rowassign[j] != -1) {
+      colassign[rowassign[j]] = -1;
+      Nnz--;
+    }
+  }
+  std:: copy (rowassign+last, rowassign+Ncols, rowassign+first);
+  Ncols -= count;
+  for (i = 0; i < Nrows; i++)
+    if (colassign[i] >= last) colassign[i] -= count;
+}
+
 void AssocMatrix::clear_pair (int in_row, int in_col) {
   int tmp_col, tmp_row, o_row, o_col;
   tmp_row = rowassign[in_col];
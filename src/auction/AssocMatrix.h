@@ -25,6 +25,12 @@ class AssocMatrix {
    */
   AssocMatrix(int N, int M);
 
+  /** 
+   * Copy constructor.
+   * @param x Association Matrix to copy
+   */
+  AssocMatrix(const AssocMatrix& x);
+
   /** Association Matrix Destructor */
   virtual ~AssocMatrix();
 
@@ -128,8 +134,56 @@ class AssocMatrix {
   /** Unassociate all the elements.*/
   void blank();
 
+  /**
+   * Resize the matrix, and unassociate all the elements.  Storage is
+   * only reallocated if the matrix grows beyond any previous size.
+   * @param N Number of rows in Association Matrix
+   * @param M Number of columns in Association Matrix
+   */
+  void resize(int N, int M);
+
+  /**
+   * Add unassociated rows after the last one, keeping all the
+   * associations.  Storage grows by doubling, so that rows may be
+   * added one at a time.
+   * @param count Number of rows to add
+   */
+  void add_rows(int count);
+
+  /**
+   * Add unassociated columns after the last one, as add_rows.
+   * @param count Number of columns to add
+   */
+  void add_cols(int count);
+
+  /**
+   * Remove a range of rows.  Their associations are cleared (so their
+   * columns become free), the others are kept, and the rows after the
+   * range are renumbered down by count.
+   * @param first First row to remove
+   * @param count Number of rows to remove
+   */
+  void remove_rows(int first, int count);
+
+  /**
+   * Remove a range of columns, as remove_rows.
+   * @param first First column to remove
+   * @param count Number of columns to remove
+   */
+  void remove_cols(int first, int count);
+
  protected:
 
+  /**
+   * Reallocate an array to hold at least size entries (and at least
+   * twice its old capacity), keeping its first used entries.
+   * @param a Array to reallocate
+   * @param cap Allocated length of a, updated
+   * @param used Number of entries to keep
+   * @param size Number of entries needed
+   */
+  static void regrow(int*& a, int& cap, int used, int size);
+
   /**
    * Delete a row and column from the matrix.  
    * We exploit that the association matrix is stored as two vectors (one
@@ -167,6 +221,10 @@ class AssocMatrix {
  private:
   int *rowassign; //!< stores the column indicies of each row
   int *colassign; //!< stores the row indicies of each column  
+  int rowcap;     //!< allocated length of rowassign
+  int colcap;     //!< allocated length of colassign
+
+  AssocMatrix& operator= (const AssocMatrix&); //!< Not implemented
     
 }; 
 
@@ -1,6 +1,22 @@
+#include <functional>
+#include <thread>
+#include <cmath>
+#include <limits>
 #include "AuctAlg.h"
+#include "AuctHeap.h"
+#include "AuctCallback.h"
+#include "AuctBarrier.h"
+#include "AuctTransport.h"
 
-using namespace mtl;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The class constants may be bound to references (std::fill takes
+// NOENTRY by one), so they are defined here too.
+const int AuctAlg::NOENTRY;
+const int AuctAlg::INDEXWIDTH;
+const int AuctAlg::WARBIDS;
 
 // Compute the associated total payoff
 int AuctAlg::totalpay (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S) {
@@ -41,7 +57,7 @@ int AuctAlg::totalpay (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S) {
 
 // Implement the auction algorithm
 AuctMetric AuctAlg::auctionF (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
-		    AuctParm& Prms)
+		    AuctParm& Prms, AuctWorkspace& W)
 {
   int N = Sh.nrows(), M = Sh.ncols(), NNZ = Sh.nnz();
   int Nf=Sh.nfullrows(), Mf=Sh.nfullcols();
@@ -55,6 +71,7 @@ AuctMetric AuctAlg::auctionF (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
   if (MESSG) cerr << "Using multiple rows/cols? : " << MULTI << endl;
 
   AuctMetric metric;
+  int allocs = W.nallocs();
 
   // Check consistency of inputs.
   if (!Pay.is_consistent(Sh) || !S.is_consistent(Sh)) {
@@ -73,175 +90,2080 @@ AuctMetric AuctAlg::auctionF (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
 
   // Set-up the Auction Metrics return class
   metric.set_rowmults((Nf != N));  metric.set_colmults((Mf != M));
-  metric.set_escaling(EScale);   metric.set_paydensity((NNZ/M*N));
+  metric.set_escaling(EScale);
+  metric.set_paydensity((double)NNZ / ((double)N * M));
   metric.set_sparsified(Pay.dense_to_sparse());
 
-  // Rescale and quantize payoff matrix to integer.  The scaling is
-  // done in a temporary matrix of doubles (ScA), which is cast to
-  // integer in a copy command.
+  // Copy the (already quantized) payoff into the workspace, oriented
+  // so that there are no more rows than columns, and rescaled so that
+  // epsilon = 1 is optimal.
   //
-  InMat input (N, M, NNZ, Pay.get_valpt(), Pay.get_rowpt(),
-	       Pay.get_indpt());
-
   bool reorient_flag = (Nf > Mf) ? true : false;
   metric.set_reoriented(reorient_flag);
-  if (reorient_flag) std::swap(N,M);
-  IMat A(N,M);
-
   if (reorient_flag) {
     if (MESSG) cerr << "Reorienting payoff matrix" << endl;
-    Sh.transpose();
-    S.transpose();
-    AuctAlg::ctransp(input, A);
-    mtl::scale(A, (std:: min(N, M)+1));
-  } else {
-    A.fast_copy(input);
-    mtl::scale(A, (std:: min(N, M)+1));
+    AuctAlg::transpose(Sh, S);
   }
+  NNZ = AuctAlg::load_payoff(Pay, M, reorient_flag, std:: min(N, M)+1, W);
+  if (reorient_flag) std::swap(N,M);
+  AuctCSR<int> A (N, M, W.get(AuctWorkspace::PAYPTR),
+		  W.get(AuctWorkspace::PAYIND), W.get(AuctWorkspace::PAYVAL));
 
   if (DEBUG) cerr << "A has "<< A.nrows() << " rows and "
 		  << A.ncols() << " cols." << endl;
-  if (DEBUG) cerr << "input has "<< input.nrows() << " rows and "
-		  << input.ncols() << " cols." << endl;
+
+  // Once the time has run out, the optional steps of the setup are
+  // skipped, and so is the bidding (see AuctParm::set_timelimit).
+
+  // With wide column groups, the multiple association cycle finds the
+  // least price of a group from an index, rather than a scan of it.
+  bool indexed = S.indexed();
+  int widest = 1;
+  for (int grp = 0; MULTI && grp < M; grp++)
+    widest = std:: max(widest, Sh.get_colmult(grp));
+  if (widest >= INDEXWIDTH) S.set_indexed(true);
+
+  // The largest number of associations the pattern of A allows.  Short
+  // of min(Nf, Mf), the auction stops there.  The rows the last search
+  // reached are those some largest association leaves short.
+  int reach = std:: min(Nf, Mf);
+  bool short_reach = false;
+  if (Prms.precheck() && !past_deadline()) {
+    reach = AuctAlg::max_cardinality(A, Sh, W);
+    metric.set_nreachable(reach);
+    short_reach = (reach < std:: min(Nf, Mf));
+    int *dist = W.get(AuctWorkspace::MCDIST);
+    for (int row = 0; row < N && short_reach; row++)
+      if (dist[row] >= 0) metric.add_shortrow(row);
+    if (MESSG && short_reach)
+      cerr << "Only " << reach << " associations are reachable, "
+	   << metric.nshortrows() << " rows may be left short" << endl;
+  }
+
+  // The single association auction may bid on a reordered copy of A,
+  // with S renumbered to match until it is handed back.
+  AuctReorder R;
+  bool reorder = Prms.reorder() && !MULTI && !past_deadline();
+  if (reorder) {
+    double span = AuctReorder::span(A);
+    A = R.build(A, W);
+    R.apply(S, W);
+    metric.set_colspan(span, AuctReorder::span(A));
+    if (MESSG) cerr << "Reordered payoff: column span " << span << " to "
+		    << metric.colspan() << endl;
+  }
+
+  // The single association cycle may bid on a compacted copy of A,
+  // which the setup and the greedy fill leave alone.  Each association
+  // may lose its rounding.
+  AuctCompact C;
+  bool compact = Prms.compact() && !MULTI && !past_deadline();
+  double qgap = 0;
+  if (compact) {
+    int qerr = C.build(A, std:: min(N, M)+1, W);
+    metric.set_quanterror(qerr * Prms.get_res());
+    qgap = std:: min(Nf, Mf) * metric.quanterror();
+    if (MESSG) cerr << "Compacted payoff: " << C.bytes_per_entry(NNZ)
+		    << " bytes per entry, rounding " << qerr << endl;
+  }
+
+  // The single association cycle may bid from look-back candidates,
+  // which hold while the prices only rise.  The phases leave the prices
+  // alone, but the hidden bids lower those of free columns, so the
+  // candidates are forgotten whenever there are free columns after.
+  AuctLookback L;
+  if (!MULTI && !compact) L.build(N, Prms.lookback(), W);
+
+  // Identical rows bid one another's prices up an epsilon at a time.  A
+  // phase which takes WARBIDS bids a row is taken for such a price war,
+  // and the identical rows are then collapsed into multiplicities for
+  // the rest of the auction, each set bidding as one in the multiple
+  // association cycle.  S is in the collapsed order only while bidding.
+  AuctCollapse G;
+  bool warcheck = Prms.collapse() && !MULTI && !compact && !short_reach;
 
   // Loop over auction rounds until associated
   int assoc_thresh = std:: min(Nf, Mf);
   metric.set_nmaxassoc(assoc_thresh);
+  assoc_thresh = std:: min(assoc_thresh, reach);
   int cycles=0;
   int epsstart;
   int epsfac   = Prms.get_epsfac();
+  int phasecycles, bids, decision;
   epsstart = (Prms.epsrelative())
     ? (int)(std:: min(N,M) * Prms.get_epsstart() / Prms.get_res())
     : (int)Prms.get_epsstart();
+  // Adaptive: start at the widest row range, in payoff units, so that
+  // the first phase resolves the gross competition and no more.
+  int range = AuctAlg::payoff_range(A);
+  if (EScale && Prms.epsadaptive() && Prms.epsrelative())
+    epsstart = range / (std:: min(N,M)+1);
   if (epsstart < 2 || epsfac < 2) epsstart = 1;
 
+  // Warm-start prices are brought down to start from zero, and kept
+  // within a row range (and a payoff unit) of each other; S is
+  // oriented, so its prices are the objects'.
+  int *warm = W.reserve(AuctWorkspace::SCRATCH, S.ncols());
+  S.get_prices(warm);
+  if (AuctAlg::bound_prices(warm, S.ncols(), range + std:: min(N,M)+1))
+    S.set_prices(warm);
+
+  // A square single association auction starts each phase from a
+  // greedy association, and a cold one is first priced by a column
+  // reduction.  Not an asymmetric one: its free columns must keep the
+  // lowest prices, which only the hidden bids after the cycles see to.
+  bool seed = Prms.seed() && !MULTI && N == M;
+  int seeded = 0;
+  if (seed && !past_deadline() && *std::max_element(warm, warm+M) == 0)
+    AuctAlg::seed_prices(A, S, W);
+
+  // The auction stops early if the cycles or the time run out, or if
+  // the anytime callback asks it to.  The last complete phase is kept,
+  // to be returned instead of a partial assignment.
+  bool stop = past_deadline(), finished = false, snapped = false;
+  int snapeps = 0;
+  double gapunit = Prms.get_res() / (std:: min(N, M)+1); // payoff per eps
+
   if (EScale) {
-    int eps;
-    for (eps=epsstart; eps > 1 && cycles < maxcycles; eps=eps/epsfac) {
+    int eps = epsstart;
+    while (eps > 1 && !stop) {
       Prms.set_epsilon(eps);
       S.blank();
+      if (seed) seeded += AuctAlg::greedy_start(A, S);
+      if (G.collapsed()) G.apply(S, W);
       if (MESSG) cerr << "Starting epsilon cycle: " << eps << endl;
-      while (S.nassoc() < assoc_thresh && cycles < maxcycles) {
-	while (S.nassoc() < assoc_thresh && cycles < maxcycles) {
+      if (trace) trace->begin(AuctTrace::PHASE, eps, assoc_thresh,
+			      AuctAlg::spread(S));
+      phasecycles = cycles;
+      bids = 0;
+      while (S.nassoc() < assoc_thresh && cycles < maxcycles && !expired) {
+	if (trace) trace->begin(AuctTrace::CYCLES, cycles,
+				assoc_thresh - S.nassoc());
+	while (S.nassoc() < assoc_thresh && cycles < maxcycles && !expired) {
 	  cycles++;
+	  bids += assoc_thresh - S.nassoc();
 	  if (DEBUG) cout << "Cycle: " << cycles << endl;
+	  if (warcheck && bids > WARBIDS * assoc_thresh) {
+	    warcheck = false;
+	    AuctAlg::collapse_rows(A, S, G, Prms, metric, W);
+	  }
 	  if (MULTI) {
-	    AuctAlg::auct_cycle_SM(A, Sh, S, Prms);
+	    AuctAlg::auct_cycle_SM(A, Sh, S, Prms, W);
+	  } else if (G.collapsed()) {
+	    AuctAlg::auct_cycle_SM(G.payoff(), G.shape(), S, Prms, W);
+	  } else if (compact) {
+	    AuctAlg::auct_cycle_SPC(C, S, Prms);
+	  } else if (L.ncand()) {
+	    AuctAlg::auct_cycle_SPL(A, S, Prms, L);
 	  } else {
 	    AuctAlg::auct_cycle_SP1(A, Sh, S, Prms);
 	  }
 	}
+	if (trace) {
+	  trace->end(AuctTrace::CYCLES, cycles, assoc_thresh - S.nassoc(),
+		     AuctAlg::spread(S));
+	  trace->begin(AuctTrace::HIDDEN_BID, eps, assoc_thresh - S.nassoc());
+	}
 	S.hidden_bid(Sh, Prms);
+	if (S.nassoc() < S.ncols()) L.invalidate();
+	if (trace) trace->end(AuctTrace::HIDDEN_BID, eps,
+			      assoc_thresh - S.nassoc(), AuctAlg::spread(S));
       }
-    }
-
-    // An opportunity to ditch if the number of cycles has hit the maximum
-    if (cycles >= maxcycles) {
-      metric.set_ncycles(cycles); metric.set_nauction_assoc(S.nassoc());
-      metric.set_timed_out(true);
-      AuctAlg::greedy_fill (A, Sh, S, Prms);
-      metric.set_ntotal_assoc(S.nassoc());
-      if (reorient_flag) {
-	Sh.transpose();
-	S.transpose();
+      if (G.collapsed()) G.undo(S, W);
+      phasecycles = cycles - phasecycles;
+      if (trace) trace->end(AuctTrace::PHASE, eps, assoc_thresh - S.nassoc(),
+			    AuctAlg::spread(S));
+
+      if (S.nassoc() < assoc_thresh) {
+	AuctAlg::end_phase(metric, Prms, eps, phasecycles, bids, epsfac,
+			   AuctMetric::EPS_STOPPED, S.nassoc(), cycles);
+	stop = true;
+	break;
       }
-      return metric;
+      decision = AuctMetric::EPS_FIXED;
+      if (Prms.epsadaptive())
+	decision = AuctAlg::adapt_epsfac(eps, bids, assoc_thresh, epsfac);
+      AuctAlg::end_phase(metric, Prms, eps, phasecycles, bids, epsfac,
+			 decision, S.nassoc(), cycles);
+      if (MESSG && decision != AuctMetric::EPS_FIXED)
+	cerr << "Phase took " << phasecycles << " cycles, " << bids
+	     << " bids: next factor " << epsfac << endl;
+
+      snapped = true;
+      snapeps = eps;
+      stop = !AuctAlg::phase_done(Sh, S, Prms, W, reorient_flag,
+				  short_reach ? -1
+				  : assoc_thresh * eps * gapunit + qgap,
+				  reorder ? &R : 0);
+      stop = stop || cycles >= maxcycles || expired;
+      eps = (decision == AuctMetric::EPS_SKIP) ? 1 : eps/epsfac;
     }
   }
 
   // The last cycle at epsilon = 1.
-  if (EScale) {
-    Prms.set_epsilon(1);
-  } else {
-    Prms.set_epsilon(epsstart);
-  }
-  if (MESSG) cerr << "Starting epsilon cycle: " << Prms.get_epsilon() << endl;
-  S.blank();
-  while (S.nassoc() < assoc_thresh && cycles < maxcycles) {
-    while (S.nassoc() < assoc_thresh && cycles < maxcycles) {
-      cycles++;
-      if (DEBUG) cout << "Cycle: " << cycles << endl;
+  if (!stop) {
+    if (EScale) {
+      Prms.set_epsilon(1);
+    } else {
+      Prms.set_epsilon(epsstart);
+    }
+    if (MESSG) cerr << "Starting epsilon cycle: " << Prms.get_epsilon() << endl;
+    S.blank();
+    if (seed) seeded += AuctAlg::greedy_start(A, S);
+    if (G.collapsed()) G.apply(S, W);
+    if (trace) trace->begin(AuctTrace::PHASE, Prms.get_epsilon(),
+			    assoc_thresh, AuctAlg::spread(S));
+    phasecycles = cycles;
+    bids = 0;
+    while (S.nassoc() < assoc_thresh && cycles < maxcycles && !expired) {
+      if (trace) trace->begin(AuctTrace::CYCLES, cycles,
+			      assoc_thresh - S.nassoc());
+      while (S.nassoc() < assoc_thresh && cycles < maxcycles && !expired) {
+	cycles++;
+	bids += assoc_thresh - S.nassoc();
+	if (DEBUG) cout << "Cycle: " << cycles << endl;
+	if (warcheck && bids > WARBIDS * assoc_thresh) {
+	  warcheck = false;
+	  AuctAlg::collapse_rows(A, S, G, Prms, metric, W);
+	}
 	if (MULTI) {
-	  AuctAlg::auct_cycle_SM(A, Sh, S, Prms);
+	  AuctAlg::auct_cycle_SM(A, Sh, S, Prms, W);
+	} else if (G.collapsed()) {
+	  AuctAlg::auct_cycle_SM(G.payoff(), G.shape(), S, Prms, W);
+	} else if (compact) {
+	  AuctAlg::auct_cycle_SPC(C, S, Prms);
+	} else if (L.ncand()) {
+	  AuctAlg::auct_cycle_SPL(A, S, Prms, L);
 	} else {
 	  AuctAlg::auct_cycle_SP1(A, Sh, S, Prms);
 	}
+      }
+      if (trace) trace->end(AuctTrace::CYCLES, cycles,
+			    assoc_thresh - S.nassoc(), AuctAlg::spread(S));
+      if (EScale) {
+	if (trace) trace->begin(AuctTrace::HIDDEN_BID, Prms.get_epsilon(),
+				assoc_thresh - S.nassoc());
+	S.hidden_bid(Sh, Prms);
+	if (S.nassoc() < S.ncols()) L.invalidate();
+	if (trace) trace->end(AuctTrace::HIDDEN_BID, Prms.get_epsilon(),
+			      assoc_thresh - S.nassoc(), AuctAlg::spread(S));
+      }
     }
-    if (EScale) S.hidden_bid(Sh, Prms);
+    if (G.collapsed()) G.undo(S, W);
+    finished = (S.nassoc() >= assoc_thresh);
+    if (trace) trace->end(AuctTrace::PHASE, Prms.get_epsilon(),
+			  assoc_thresh - S.nassoc(), AuctAlg::spread(S));
+    AuctAlg::end_phase(metric, Prms, Prms.get_epsilon(), cycles - phasecycles,
+		       bids, 1, finished ? AuctMetric::EPS_FINAL
+		       : AuctMetric::EPS_STOPPED, S.nassoc(), cycles);
   }
 
-  if (DEBUG) AuctAlg::checkecs(A, Sh, S, Prms);
+  if (DEBUG && finished) AuctAlg::checkecs(A, Sh, S, Prms, W);
 
   metric.set_ncycles(cycles);
   metric.set_nauction_assoc(S.nassoc());
-
-  // Again, greedy fill if we timed out
-  if (cycles >= maxcycles) {
+  metric.set_nseeded(seeded);
+  metric.set_nlookback(L.nhits());
+
+  // If we stopped early, go back to the last complete phase if there
+  // was one, and greedy fill whatever is still unassociated.
+  if (finished) {
+    metric.set_gap((Prms.get_epsilon() > 1)
+		   ? assoc_thresh * Prms.get_epsilon() * gapunit + qgap : qgap);
+  } else {
     metric.set_timed_out(true);
+    metric.set_expired(expired);
+    if (MESSG) cerr << "Auction stopped after " << cycles << " cycles" << endl;
+    if (snapped && S.nassoc() < assoc_thresh) {
+      AuctAlg::restore_phase(S, W);
+      Prms.set_epsilon(snapeps);
+    }
     AuctAlg::greedy_fill (A, Sh, S, Prms);
+    metric.set_gap(snapped ? assoc_thresh * snapeps * gapunit + qgap : -1);
+  }
+
+  // Short of min(Nf, Mf), the bound on the gap does not hold.
+  if (short_reach) metric.set_gap(-1);
+
+  if (reorder) R.undo(S, W);
+  S.set_indexed(indexed);
+  if (reorient_flag) AuctAlg::transpose(Sh, S);
+  if (finished && Prms.get_callback())
+    Prms.get_callback()->improved(Sh, S, metric.gap());
+
+  metric.set_ntotal_assoc(S.nassoc());
+  metric.set_nallocs(W.nallocs() - allocs);
+  return metric;
+}
+
+// The complete assignment of a phase is copied into the workspace, so
+// that it survives the blank at the start of the next phase, and is
+// then handed to the callback, in the user's orientation.
+bool AuctAlg::phase_done (AuctShape& Sh, AuctAssoc& S, AuctParm& Prms,
+			  AuctWorkspace& W, bool reoriented, double gap,
+			  AuctReorder* R) {
+  bool more = true;
+
+  S.get_columns(W.reserve(AuctWorkspace::SNAPCOL, S.nrows()));
+  S.get_prices(W.reserve(AuctWorkspace::SNAPPRICE, S.ncols()));
+  S.get_profits(W.reserve(AuctWorkspace::SNAPPROF, S.nrows()));
+
+  if (Prms.get_callback()) {
+    if (R) R->undo(S, W);
+    if (reoriented) AuctAlg::transpose(Sh, S);
+    more = Prms.get_callback()->improved(Sh, S, gap);
+    if (reoriented) AuctAlg::transpose(Sh, S);
+    if (R) R->apply(S, W);
+  }
+  return more;
+}
+
+void AuctAlg::end_phase (AuctMetric& metric, AuctParm& Prms, double eps,
+			  int phasecycles, int bids, int epsfac, int decision,
+			  int nassoc, int cycles) {
+  metric.add_phase(eps, phasecycles, bids, epsfac, decision);
+  if (Prms.get_perf())
+    Prms.get_perf()->lap("epsilon " + std::to_string((long)eps));
+  if (Prms.get_callback())
+    Prms.get_callback()->progress(metric.nphases()-1, eps, nassoc, cycles);
+}
+
+void AuctAlg::restore_phase (AuctAssoc& S, AuctWorkspace& W) {
+  int *cols = W.get(AuctWorkspace::SNAPCOL);
+
+  S.blank();
+  for (int row = 0; row < S.nrows(); row++)
+    if (cols[row] != -1) S.add(row, cols[row]);
+  S.set_prices(W.get(AuctWorkspace::SNAPPRICE));
+  S.set_profits(W.get(AuctWorkspace::SNAPPROF));
+}
+
+void AuctAlg::start_clock (AuctParm& Prms) {
+  trace = Prms.get_trace();
+  if (Prms.get_perf()) Prms.get_perf()->mark();
+  expired = false;
+  timed = (Prms.get_timelimit() > 0);
+  cancelflag = Prms.get_cancel();
+  clockcount = 0;
+  clockperiod = (timed || cancelflag) ? Prms.get_clockrows() : 0;
+  deadline = std::chrono::steady_clock::now() +
+    std::chrono::microseconds((long)(1000 * Prms.get_timelimit()));
+}
+
+void AuctAlg::transpose (AuctShape& Sh, AuctAssoc& S) {
+  if (trace) trace->begin(AuctTrace::TRANSPOSE, Sh.nrows());
+  Sh.transpose();
+  S.transpose();
+  if (trace) trace->end(AuctTrace::TRANSPOSE, Sh.ncols());
+}
+
+double AuctAlg::spread (AuctAssoc& S) {
+  if (S.ncols() == 0) return 0;
+  int lo = S.Price(0), hi = S.Price(0);
+  for (int j = 1; j < S.ncols(); j++) {
+    lo = std:: min(lo, S.Price(j));
+    hi = std:: max(hi, S.Price(j));
   }
+  return (double)hi - lo;
+}
+
 
+
+// Floating point auction.  As auctionF, but on the unscaled values, so
+// that epsilon is in payoff units.  It starts at a fraction of the
+// widest row range, and stops at the tolerance divided by the number
+// of associations.  The bidders are the rows, or the columns if there
+// are fewer of them.
+AuctMetric AuctAlg::auctionFP (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+			       AuctParm& Prms, AuctWorkspace& W)
+{
+  int N = Sh.nrows(), M = Sh.ncols();
+  int maxcycles = Prms.get_maxcycles();
+  bool EScale = Prms.EScale(), DEBUG = Prms.DEBUG(), MESSG = Prms.MESSG();
+  AuctMetric metric;
+  int allocs = W.nallocs();
+
+  Sh.ifcompute();
+  if (!Pay.has_fvalues() || Sh.nfullrows() != N || Sh.nfullcols() != M) {
+    if (MESSG) cerr << "Floating point auction needs single associations "
+		    << "and a floating point payoff" << endl;
+    if (!Pay.has_values()) return metric;
+    return auctionF (Pay, Sh, S, Prms, W);
+  }
+  if (!Pay.is_consistent(Sh) || !S.is_consistent(Sh) || N == 0 || M == 0) {
+    return metric;  // return with zero cycles
+  }
+
+  bool reorient_flag = (N > M) ? true : false;
+  metric.set_escaling(EScale);
+  metric.set_sparsified(Pay.dense_to_sparse());
+  metric.set_reoriented(reorient_flag);
+  if (MESSG && reorient_flag) cerr << "Reorienting payoff matrix" << endl;
+
+  AuctAlg::load_fpayoff(Pay, M, reorient_flag, W);
+  int nbid = reorient_flag ? M : N, nobj = reorient_flag ? N : M;
+  int *ptr = W.get(AuctWorkspace::PAYPTR), *ind = W.get(AuctWorkspace::PAYIND);
+  double *val = W.dget(AuctWorkspace::DPAYVAL);
+  double *price = W.dreserve(AuctWorkspace::DPRICE, nobj);
+  int *bidobj = W.reserve(AuctWorkspace::BIDOBJ, nbid);
+  int *objbid = W.reserve(AuctWorkspace::OBJBID, nobj);
+  int b, k;
+
+  // The widest range of values in a row sets the starting epsilon.
+  // The final epsilon gives the tolerance, but is kept well above the
+  // rounding error of the prices, which may reach a few times the
+  // largest payoff (bids with no second choice go that high).
+  double range = 0, maxabs = 0, lo, hi;
+  for (b = 0; b < nbid; b++) {
+    if (ptr[b] == ptr[b+1]) continue;
+    lo = hi = val[ptr[b]];
+    for (k = ptr[b]; k < ptr[b+1]; k++) {
+      lo = std:: min(lo, val[k]);
+      hi = std:: max(hi, val[k]);
+      maxabs = std:: max(maxabs, std::fabs(val[k]));
+    }
+    range = std:: max(range, hi - lo);
+  }
+  double neglarge = -2 * (maxabs + range) - 1;
+  double tol = (Prms.get_tolerance() > 0) ? Prms.get_tolerance() : 1e-9 * maxabs;
+  double epsfinal = std:: max(tol / nbid, 1e-12 * (4 * (maxabs + range) + 1));
+  int epsfac = std:: max(Prms.get_epsfac(), 2);
+  double eps = EScale ? std:: max(range / epsfac, epsfinal) : epsfinal;
+
+  int assoc_thresh = std:: min(N, M), nassoc = 0;
+  metric.set_nmaxassoc(assoc_thresh);
+  int cycles = 0, phasecycles, bids;
+  bool finished = false, snapped = false;
+  double snapeps = 0;
+
+  std::fill (price, price+nobj, 0.0);
+  for (;;) {
+    std::fill (bidobj, bidobj+nbid, -1);
+    std::fill (objbid, objbid+nobj, -1);
+    nassoc = 0;
+    if (MESSG) cerr << "Starting epsilon cycle: " << eps << endl;
+    if (trace) trace->begin(AuctTrace::PHASE, eps, assoc_thresh,
+			    AuctAlg::spread(price, nobj));
+    phasecycles = cycles;
+    bids = 0;
+    while (nassoc < assoc_thresh && cycles < maxcycles && !expired) {
+      if (trace) trace->begin(AuctTrace::CYCLES, cycles, assoc_thresh - nassoc);
+      while (nassoc < assoc_thresh && cycles < maxcycles && !expired) {
+	cycles++;
+	bids += assoc_thresh - nassoc;
+	if (DEBUG) cout << "Cycle: " << cycles << endl;
+	AuctAlg::auct_cycle_raw(nbid, ptr, ind, val, price, bidobj, objbid,
+				nassoc, eps, neglarge);
+      }
+      if (trace) trace->end(AuctTrace::CYCLES, cycles, assoc_thresh - nassoc,
+			    AuctAlg::spread(price, nobj));
+      if (nobj > nbid) {
+	if (trace) trace->begin(AuctTrace::HIDDEN_BID, eps, assoc_thresh - nassoc);
+	AuctAlg::hidden_bid_raw(nbid, nobj, price, bidobj, objbid, nassoc, eps, W);
+	if (trace) trace->end(AuctTrace::HIDDEN_BID, eps, assoc_thresh - nassoc,
+			      AuctAlg::spread(price, nobj));
+      }
+    }
+    phasecycles = cycles - phasecycles;
+    if (trace) trace->end(AuctTrace::PHASE, eps, assoc_thresh - nassoc,
+			  AuctAlg::spread(price, nobj));
+
+    if (nassoc < assoc_thresh) {
+      AuctAlg::end_phase(metric, Prms, eps, phasecycles, bids, epsfac,
+			 AuctMetric::EPS_STOPPED, nassoc, cycles);
+      break;
+    }
+    if (eps <= epsfinal) {
+      AuctAlg::end_phase(metric, Prms, eps, phasecycles, bids, 1,
+			 AuctMetric::EPS_FINAL, nassoc, cycles);
+      finished = true;
+      break;
+    }
+    AuctAlg::end_phase(metric, Prms, eps, phasecycles, bids, epsfac,
+		       AuctMetric::EPS_FIXED, nassoc, cycles);
+
+    // Keep the phase's assignment, in case we run out of cycles or time.
+    std::copy (bidobj, bidobj+nbid, W.reserve(AuctWorkspace::SNAPCOL, nbid));
+    snapped = true;
+    snapeps = eps;
+    if (Prms.get_callback()) {
+      AuctAlg::raw_to_assoc(nbid, bidobj, reorient_flag, S);
+      if (!Prms.get_callback()->improved(Sh, S, assoc_thresh * eps)) break;
+    }
+    if (cycles >= maxcycles || expired) break;
+    eps = std:: max(eps / epsfac, epsfinal);
+  }
+
+  metric.set_ncycles(cycles);
+  metric.set_nauction_assoc(nassoc);
+  if (finished) {
+    metric.set_gap(assoc_thresh * epsfinal);
+  } else {
+    metric.set_timed_out(true);
+    metric.set_expired(expired);
+    if (MESSG) cerr << "Auction stopped after " << cycles << " cycles" << endl;
+    if (snapped && nassoc < assoc_thresh) {
+      std::copy (W.get(AuctWorkspace::SNAPCOL),
+		 W.get(AuctWorkspace::SNAPCOL)+nbid, bidobj);
+      std::fill (objbid, objbid+nobj, -1);
+      for (b = 0; b < nbid; b++) if (bidobj[b] != -1) objbid[bidobj[b]] = b;
+    }
+    AuctAlg::greedy_raw(nbid, ptr, ind, val, bidobj, objbid);
+    metric.set_gap(snapped ? assoc_thresh * snapeps : -1);
+  }
+
+  AuctAlg::raw_to_assoc(nbid, bidobj, reorient_flag, S);
+  if (finished && Prms.get_callback())
+    Prms.get_callback()->improved(Sh, S, metric.gap());
+
+  metric.set_ntotal_assoc(S.nassoc());
+  metric.set_nallocs(W.nallocs() - allocs);
+  return metric;
+}
+
+// The associations of the raw auction (bidder to object) are put into
+// S in the user's orientation, where the objects are the rows if the
+// auction was reoriented.
+void AuctAlg::raw_to_assoc (int nbid, int* bidobj, bool reoriented,
+			    AuctAssoc& S) {
+  S.blank();
+  for (int b = 0; b < nbid; b++) {
+    if (bidobj[b] == -1) continue;
+    if (reoriented) S.add(bidobj[b], b);
+    else S.add(b, bidobj[b]);
+  }
+}
+
+
+// Jonker-Volgenant engine.  The payoff is spread out into a dense row
+// for each payoff row (the copies of a row share it), with an entry
+// for each copy of its columns, oriented so that there are no more
+// bidders than objects.
+AuctMetric AuctAlg::auctionJV (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+			       AuctParm& Prms, AuctWorkspace& W)
+{
+  int N = Sh.nrows(), M = Sh.ncols();
+  bool MESSG = Prms.MESSG();
+  AuctMetric metric;
+  int allocs = W.nallocs();
+
+  Sh.ifcompute();
+  int Nf = Sh.nfullrows(), Mf = Sh.nfullcols();
+  if (!Pay.is_consistent(Sh) || !S.is_consistent(Sh) || Nf == 0 || Mf == 0) {
+    return metric;  // return with zero cycles
+  }
+
+  bool reorient_flag = (Nf > Mf) ? true : false;
+  metric.set_rowmults((Nf != N));  metric.set_colmults((Mf != M));
+  metric.set_escaling(false);
+  metric.set_sparsified(Pay.dense_to_sparse());
+  metric.set_reoriented(reorient_flag);
   if (reorient_flag) {
-    Sh.transpose();
-    S.transpose();
+    if (MESSG) cerr << "Reorienting payoff matrix" << endl;
+    AuctAlg::transpose(Sh, S);
+  }
+  int NNZ = AuctAlg::load_payoff(Pay, M, reorient_flag, std:: min(N, M)+1, W);
+  if (reorient_flag) std::swap(N,M);
+  metric.set_paydensity((double)NNZ / ((double)N * M));
+  int *ptr = W.get(AuctWorkspace::PAYPTR), *ind = W.get(AuctWorkspace::PAYIND);
+  int *val = W.get(AuctWorkspace::PAYVAL);
+  int nbid = Sh.nfullrows(), nobj = Sh.nfullcols();
+
+  int *dense = W.reserve(AuctWorkspace::JVCOST, N * nobj);
+  int *rowof = W.reserve(AuctWorkspace::SCRATCH, nbid);
+  int *bidobj = W.reserve(AuctWorkspace::BIDOBJ, nbid);
+  int *objbid = W.reserve(AuctWorkspace::OBJBID, nobj);
+  double *profit = W.dreserve(AuctWorkspace::DPROFIT, nbid);
+  double *price = W.dreserve(AuctWorkspace::DPRICE, nobj);
+  int i, j, k, b, best, nassoc = 0;
+
+  std::fill (dense, dense + N*nobj, NOENTRY);
+  for (i = 0; i < N; i++)
+    for (k = ptr[i]; k < ptr[i+1]; k++)
+      for (j = Sh.get_colptr(ind[k]); j < Sh.get_colptr(ind[k]+1); j++)
+	dense[i*nobj + j] = val[k];
+  for (b = 0; b < nbid; b++) rowof[b] = Sh.get_rowmap(b);
+  std::fill (bidobj, bidobj+nbid, -1);
+  std::fill (objbid, objbid+nobj, -1);
+  std::fill (profit, profit+nbid, 0.0);
+  std::fill (price, price+nobj, 0.0);
+
+  // Column reduction (square problems only, as the free objects of an
+  // asymmetric one must keep the lowest prices): each object is priced
+  // at its largest payoff, which leaves every profit at most 0, and
+  // goes to a free copy of that row, whose profit is then exactly 0.
+  if (nbid == nobj && !past_deadline()) {
+    for (j = 0; j < nobj; j++) {
+      best = -1;
+      for (i = 0; i < N; i++) {
+	if (dense[i*nobj + j] == NOENTRY) continue;
+	if (best == -1 || dense[i*nobj + j] > dense[best*nobj + j]) best = i;
+      }
+      if (best == -1) continue;
+      price[j] = dense[best*nobj + j];
+      for (b = Sh.get_rowptr(best); b < Sh.get_rowptr(best+1); b++) {
+	if (bidobj[b] == -1) {
+	  bidobj[b] = j;
+	  objbid[j] = b;
+	  nassoc++;
+	  break;
+	}
+      }
+    }
+  }
+  int reduced = nassoc;
+
+  if (MESSG) cerr << "JV: " << reduced << " of " << nbid
+		  << " associated by column reduction" << endl;
+  long scans = 0;
+  int assoc_thresh = std:: min(nbid, nobj);
+  if (trace) trace->begin(AuctTrace::PHASE, 0, assoc_thresh - nassoc,
+			  AuctAlg::spread(price, nobj));
+  nassoc = AuctAlg::jv_dense(nbid, nobj, rowof, dense, bidobj, objbid,
+			     profit, price, W, scans);
+  if (trace) trace->end(AuctTrace::PHASE, 0, assoc_thresh - nassoc,
+			AuctAlg::spread(price, nobj));
+  metric.set_nmaxassoc(assoc_thresh);
+  metric.set_ncycles(nassoc - reduced);
+  metric.set_nauction_assoc(nassoc);
+  AuctAlg::end_phase(metric, Prms, 0, nassoc - reduced, (int)scans, 1,
+		     expired ? AuctMetric::EPS_STOPPED : AuctMetric::EPS_FINAL,
+		     nassoc, nassoc - reduced);
+
+  // Stopped early: the bidders still free are greedily filled in.
+  if (expired) {
+    metric.set_timed_out(true);
+    metric.set_expired(true);
+    if (MESSG) cerr << "JV stopped after " << nassoc - reduced
+		    << " augmentations" << endl;
+    if (trace) trace->begin(AuctTrace::GREEDY_FILL);
+    for (b = 0; b < nbid; b++) {
+      if (bidobj[b] != -1) continue;
+      int *a = dense + rowof[b]*nobj;
+      best = -1;
+      for (j = 0; j < nobj; j++) {
+	if (a[j] == NOENTRY || objbid[j] != -1) continue;
+	if (best == -1 || a[j] > a[best]) best = j;
+      }
+      if (best == -1) continue;
+      bidobj[b] = best;
+      objbid[best] = b;
+    }
+    if (trace) trace->end(AuctTrace::GREEDY_FILL,
+			  nbid - std::count(bidobj, bidobj+nbid, -1));
+  }
+  metric.set_gap((nassoc == assoc_thresh) ? 0 : -1);
+
+  AuctAlg::raw_to_assoc(nbid, bidobj, false, S);
+  for (j = 0; j < nobj; j++)
+    S.set_Price(j, (int)std:: max(std:: min(price[j], 2147483647.0),
+				  -2147483647.0));
+  for (b = 0; b < nbid; b++)
+    S.set_Prof(b, (int)std:: max(std:: min(profit[b], 2147483647.0),
+				 -2147483647.0));
+
+  if (reorient_flag) AuctAlg::transpose(Sh, S);
+  if (!expired && Prms.get_callback())
+    Prms.get_callback()->improved(Sh, S, metric.gap());
+
+  metric.set_ntotal_assoc(S.nassoc());
+  metric.set_nallocs(W.nallocs() - allocs);
+  return metric;
+}
+
+// Shortest augmenting paths (as in Jonker and Volgenant, 1987), with
+// the free bidder's search run as Dijkstra's method over the objects.
+// The reduced payoff of an entry, profit + price - payoff, is never
+// negative, and is 0 for an association.  Each object's distance is
+// the shortest path to it from the free bidder, and the search stops
+// at the nearest free object.  The scanned objects then have their
+// prices raised, and their bidders' profits lowered, by how much
+// nearer they were than it, which keeps the reduced payoffs >= 0 and
+// makes those along the path 0, and the path is flipped.  An object
+// is only ever scanned once it is associated, so the free objects keep
+// price 0, the lowest, as the asymmetric problem needs.
+int AuctAlg::jv_dense (int nbid, int nobj, int* rowof, int* val,
+		       int* bidobj, int* objbid, double* profit,
+		       double* price, AuctWorkspace& W, long& scans) {
+  int *pred = W.reserve(AuctWorkspace::JVPRED, nobj);
+  int *todo = W.reserve(AuctWorkspace::JVTODO, nobj);
+  int *rows = W.reserve(AuctWorkspace::JVROWS, nbid);
+  double *dist = W.dreserve(AuctWorkspace::DDIST, nobj);
+  const double INF = std::numeric_limits<double>::infinity();
+  int cur, b, j, t, low, ntodo, nrows, sink, nassoc = 0;
+  int *a;
+  double d, lowest, minval;
+
+  for (b = 0; b < nbid; b++) if (bidobj[b] != -1) nassoc++;
+
+  for (cur = 0; cur < nbid; cur++) {
+    if (bidobj[cur] != -1) continue;
+    if (out_of_time()) break;
+
+    // Start the free bidder at its best profit, so that its reduced
+    // payoffs are >= 0, with the best of them 0.
+    a = val + rowof[cur]*nobj;
+    d = -INF;
+    for (j = 0; j < nobj; j++)
+      if (a[j] != NOENTRY) d = std:: max(d, a[j] - price[j]);
+    if (d == -INF) continue;  // empty row
+    profit[cur] = d;
+
+    for (j = 0; j < nobj; j++) {
+      todo[j] = j;
+      dist[j] = INF;
+    }
+    ntodo = nobj;
+    nrows = 0;
+    minval = 0;
+    sink = -1;
+    b = cur;
+    while (sink == -1) {
+      rows[nrows++] = b;
+      scans++;
+      a = val + rowof[b]*nobj;
+      lowest = INF;
+      low = -1;
+      for (t = 0; t < ntodo; t++) {
+	j = todo[t];
+	if (a[j] != NOENTRY) {
+	  d = minval + profit[b] + price[j] - a[j];
+	  if (d < dist[j]) {
+	    dist[j] = d;
+	    pred[j] = b;
+	  }
+	}
+	if (dist[j] < lowest || (dist[j] == lowest && objbid[j] == -1)) {
+	  lowest = dist[j];
+	  low = t;
+	}
+      }
+      if (lowest == INF) break;  // no free object can be reached
+
+      // Move the nearest object to the scanned end of todo.
+      minval = lowest;
+      j = todo[low];
+      todo[low] = todo[--ntodo];
+      todo[ntodo] = j;
+      if (objbid[j] == -1) sink = j;
+      else b = objbid[j];
+    }
+    if (sink == -1) continue;
+
+    profit[cur] -= minval;
+    for (t = 1; t < nrows; t++)
+      profit[rows[t]] -= minval - dist[bidobj[rows[t]]];
+    for (t = ntodo; t < nobj; t++)
+      price[todo[t]] += minval - dist[todo[t]];
+
+    for (j = sink; ; j = t) {
+      b = pred[j];
+      objbid[j] = b;
+      t = bidobj[b];
+      bidobj[b] = j;
+      if (b == cur) break;
+    }
+    nassoc++;
+  }
+  return nassoc;
+}
+
+// Sparse JV engine.  The bidders' entries are read from the payoff's
+// own arrays (or, if it has more rows than columns, from its transpose
+// in the workspace), in payoff units, and the copies of a row or
+// column share them.  The prices found are scaled to the auction's
+// units at the end.
+AuctMetric AuctAlg::auctionJVsp (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+				 AuctParm& Prms, AuctWorkspace& W)
+{
+  int N = Sh.nrows(), M = Sh.ncols();
+  bool MESSG = Prms.MESSG();
+  AuctMetric metric;
+  int allocs = W.nallocs();
+
+  Sh.ifcompute();
+  int Nf = Sh.nfullrows(), Mf = Sh.nfullcols();
+  if (!Pay.is_consistent(Sh) || !S.is_consistent(Sh) || Nf == 0 || Mf == 0) {
+    return metric;  // return with zero cycles
+  }
+
+  bool reorient_flag = (Nf > Mf) ? true : false;
+  int NNZ = Pay.get_rowpt()[N] - Pay.get_base();
+  int scale = std:: min(N, M)+1;
+  metric.set_rowmults((Nf != N));  metric.set_colmults((Mf != M));
+  metric.set_escaling(false);
+  metric.set_sparsified(Pay.dense_to_sparse());
+  metric.set_reoriented(reorient_flag);
+  metric.set_paydensity((double)NNZ / ((double)N * M));
+  int *ptr = Pay.get_rowpt(), *ind = Pay.get_indpt(), *val = Pay.get_valpt();
+  int base = Pay.get_base();
+  if (reorient_flag) {
+    if (MESSG) cerr << "Reorienting payoff matrix" << endl;
+    AuctAlg::transpose(Sh, S);
+    AuctAlg::load_payoff(Pay, M, true, 1, W);
+    ptr = W.get(AuctWorkspace::PAYPTR);
+    ind = W.get(AuctWorkspace::PAYIND);
+    val = W.get(AuctWorkspace::PAYVAL);
+    base = 0;
+  }
+  int nbid = Sh.nfullrows(), nobj = Sh.nfullcols();
+
+  int *rowof = W.reserve(AuctWorkspace::SCRATCH, nbid);
+  int *bidobj = W.reserve(AuctWorkspace::BIDOBJ, nbid);
+  int *objbid = W.reserve(AuctWorkspace::OBJBID, nobj);
+  double *profit = W.dreserve(AuctWorkspace::DPROFIT, nbid);
+  double *price = W.dreserve(AuctWorkspace::DPRICE, nobj);
+  int j, b, k, best;
+
+  for (b = 0; b < nbid; b++) rowof[b] = Sh.get_rowmap(b);
+  std::fill (bidobj, bidobj+nbid, -1);
+  std::fill (objbid, objbid+nobj, -1);
+  std::fill (profit, profit+nbid, 0.0);
+  std::fill (price, price+nobj, 0.0);
+
+  long scans = 0;
+  int assoc_thresh = std:: min(nbid, nobj);
+  if (trace) trace->begin(AuctTrace::PHASE, 0, assoc_thresh,
+			  AuctAlg::spread(price, nobj));
+  int nassoc = AuctAlg::jv_sparse(nbid, nobj, rowof, ptr, ind, val, base, Sh,
+				  bidobj, objbid, profit, price, W, scans);
+  if (trace) trace->end(AuctTrace::PHASE, 0, assoc_thresh - nassoc,
+			AuctAlg::spread(price, nobj));
+  metric.set_nmaxassoc(assoc_thresh);
+  metric.set_ncycles(nassoc);
+  metric.set_nauction_assoc(nassoc);
+  AuctAlg::end_phase(metric, Prms, 0, nassoc, (int)scans, 1,
+		     expired ? AuctMetric::EPS_STOPPED : AuctMetric::EPS_FINAL,
+		     nassoc, nassoc);
+
+  // Stopped early: the bidders still free are greedily filled in.
+  if (expired) {
+    metric.set_timed_out(true);
+    metric.set_expired(true);
+    if (MESSG) cerr << "JV stopped after " << nassoc
+		    << " augmentations" << endl;
+    if (trace) trace->begin(AuctTrace::GREEDY_FILL);
+    for (b = 0; b < nbid; b++) {
+      if (bidobj[b] != -1) continue;
+      best = -1;
+      for (k = ptr[rowof[b]]-base; k < ptr[rowof[b]+1]-base; k++) {
+	for (j = Sh.get_colptr(ind[k]-base); j < Sh.get_colptr(ind[k]-base+1);
+	     j++) {
+	  if (objbid[j] == -1 && (best == -1 || val[k] > val[best])) {
+	    best = k;
+	    bidobj[b] = j;
+	  }
+	}
+      }
+      if (best != -1) objbid[bidobj[b]] = b;
+    }
+    if (trace) trace->end(AuctTrace::GREEDY_FILL,
+			  nbid - std::count(bidobj, bidobj+nbid, -1));
+  }
+  metric.set_gap((nassoc == assoc_thresh) ? 0 : -1);
+
+  AuctAlg::raw_to_assoc(nbid, bidobj, false, S);
+  for (j = 0; j < nobj; j++)
+    S.set_Price(j, (int)std:: max(std:: min(scale * price[j], 2147483647.0),
+				  -2147483647.0));
+  for (b = 0; b < nbid; b++)
+    S.set_Prof(b, (int)std:: max(std:: min(scale * profit[b], 2147483647.0),
+				 -2147483647.0));
+
+  if (reorient_flag) AuctAlg::transpose(Sh, S);
+  if (!expired && Prms.get_callback())
+    Prms.get_callback()->improved(Sh, S, metric.gap());
+
+  metric.set_ntotal_assoc(S.nassoc());
+  metric.set_nallocs(W.nallocs() - allocs);
+  return metric;
+}
+
+// As jv_dense, with the objects kept in a heap on their distance, so
+// that only those reached are looked at.  An object is taken from the
+// heap once its distance is final, so every object nearer than the
+// free one the search stops at has been scanned, and those reached
+// but not scanned are no nearer, so that the duals are updated, and
+// the distances put back to infinity, from the list of objects reached.
+int AuctAlg::jv_sparse (int nbid, int nobj, int* rowof, int* ptr, int* ind,
+			int* val, int base, AuctShape& Sh, int* bidobj,
+			int* objbid, double* profit, double* price,
+			AuctWorkspace& W, long& scans) {
+  int *pred = W.reserve(AuctWorkspace::JVPRED, nobj);
+  int *reached = W.reserve(AuctWorkspace::JVTODO, nobj);
+  int *pos = W.reserve(AuctWorkspace::JVPOS, nobj);
+  double *dist = W.dreserve(AuctWorkspace::DDIST, nobj);
+  const double INF = std::numeric_limits<double>::infinity();
+  int cur, b, j, k, c, t, nreached, sink, nassoc = 0;
+  double d, minval;
+  AuctHeap heap;
+
+  std::fill (dist, dist+nobj, INF);
+  std::fill (pos, pos+nobj, -1);
+  heap.attach(W.reserve(AuctWorkspace::JVHEAP, nobj), pos, dist);
+
+  for (cur = 0; cur < nbid; cur++) {
+    if (out_of_time()) break;
+
+    // Start the free bidder at its best profit.
+    d = -INF;
+    for (k = ptr[rowof[cur]]-base; k < ptr[rowof[cur]+1]-base; k++)
+      for (j = Sh.get_colptr(ind[k]-base); j < Sh.get_colptr(ind[k]-base+1);
+	   j++)
+	d = std:: max(d, val[k] - price[j]);
+    if (d == -INF) continue;  // empty row
+    profit[cur] = d;
+
+    nreached = 0;
+    minval = 0;
+    sink = -1;
+    b = cur;
+    for (;;) {
+      scans++;
+      for (k = ptr[rowof[b]]-base; k < ptr[rowof[b]+1]-base; k++) {
+	c = ind[k]-base;
+	for (j = Sh.get_colptr(c); j < Sh.get_colptr(c+1); j++) {
+	  d = minval + profit[b] + price[j] - val[k];
+	  if (d < dist[j]) {
+	    if (dist[j] == INF) reached[nreached++] = j;
+	    dist[j] = d;
+	    pred[j] = b;
+	    heap.push(j);
+	  }
+	}
+      }
+      if (heap.empty()) break;  // no free object can be reached
+      j = heap.pop();
+      minval = dist[j];
+      if (objbid[j] == -1) {
+	sink = j;
+	break;
+      }
+      b = objbid[j];
+    }
+    heap.clear();
+
+    if (sink != -1) {
+      profit[cur] -= minval;
+      for (t = 0; t < nreached; t++) {
+	j = reached[t];
+	if (dist[j] >= minval) continue;
+	price[j] += minval - dist[j];
+	profit[objbid[j]] -= minval - dist[j];
+      }
+      for (j = sink; ; j = t) {
+	b = pred[j];
+	objbid[j] = b;
+	t = bidobj[b];
+	bidobj[b] = j;
+	if (b == cur) break;
+      }
+      nassoc++;
+    }
+    for (t = 0; t < nreached; t++) dist[reached[t]] = INF;
+  }
+  return nassoc;
+}
+
+// The engine (see AuctParm::set_engine).  The auction is estimated at
+// a pass over the expanded payoff for each epsilon-scaling phase, of
+// which there are as many as it takes the epsilon factor to bring the
+// starting epsilon down to 1.  Payoffs with few distinct values (a
+// range small next to the number of bidders) have many ties, which
+// the auction settles by price wars, and which take it up to twice as
+// long.  So do sparse payoffs, whose bidders have few objects to turn
+// to, so that a bid is passed along a long chain of them: the passes
+// are taken to grow with the number of bidders over the entries of
+// each.  JV is estimated at a pass over the dense payoff for each of
+// about sqrt(bidders) long augmentations, and the paths are longer
+// when entries are missing.  The sparse JV engine is estimated at a
+// pass over the expanded payoff, and a heap operation per entry, for
+// each of those augmentations.
+int AuctAlg::choose_engine (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+			    AuctParm& Prms, int& why, double& auct,
+			    double& jv, double& jvsp) {
+  int engine = Prms.get_engine();
+  auct = jv = jvsp = 0;
+  why = AuctMetric::WHY_REQUESTED;
+  if (engine == AuctParm::ENGINE_AUCTION) return engine;
+  if (Prms.floating() || Prms.get_prunek() > 0 || Prms.get_nthreads() > 1 ||
+      (Prms.get_transport() && Prms.get_transport()->size() > 1)) {
+    why = AuctMetric::WHY_OPTIONS;
+    return AuctParm::ENGINE_AUCTION;
+  }
+
+  Sh.ifcompute();
+  int N = Sh.nrows(), M = Sh.ncols();
+  int Nf = Sh.nfullrows(), Mf = Sh.nfullcols();
+  if (N == 0 || M == 0 || !Pay.has_values()) {
+    why = AuctMetric::WHY_DENSITY;
+    return AuctParm::ENGINE_AUCTION;
+  }
+
+  // Prices or profits left by an earlier auction (or set by the
+  // caller) warm-start the auction; the JV engines start from zero.
+  // Not with multiplicities, whose warm starts can end in price wars.
+  bool warm = false;
+  for (int t = 0; t < S.ncols() && !warm; t++) warm = (S.Price(t) != 0);
+  for (int t = 0; t < S.nrows() && !warm; t++) warm = (S.Prof(t) != 0);
+  if (warm && Nf == N && Mf == M) {
+    why = AuctMetric::WHY_WARM;
+    return AuctParm::ENGINE_AUCTION;
+  }
+  int *ptr = Pay.get_rowpt(), *v = Pay.get_valpt(), base = Pay.get_base();
+  int i, k, lo, hi, range = 0;
+  for (i = 0; i < Pay.nrows(); i++) {
+    if (ptr[i] == ptr[i+1]) continue;
+    lo = hi = v[ptr[i]-base];
+    for (k = ptr[i]-base; k < ptr[i+1]-base; k++) {
+      lo = std:: min(lo, v[k]);
+      hi = std:: max(hi, v[k]);
+    }
+    range = std:: max(range, hi - lo);
+  }
+  int NNZ = ptr[Pay.nrows()] - base;
+  double nbid = std:: min(Nf, Mf), nobj = std:: max(Nf, Mf);
+  double cells = (double)((Nf > Mf) ? M : N) * nobj;
+  double density = (double)NNZ / ((double)N * M);
+
+  // Starting epsilon, as auctionF computes it.
+  int epsfac = Prms.get_epsfac();
+  double epsstart = Prms.epsrelative()
+    ? std:: min(N,M) * Prms.get_epsstart() / Prms.get_res()
+    : Prms.get_epsstart();
+  if (Prms.EScale() && Prms.epsadaptive() && Prms.epsrelative())
+    epsstart = range;
+  double phases = 1;
+  if (Prms.EScale() && epsstart >= 2 && epsfac >= 2)
+    phases += std::ceil(std::log(epsstart) / std::log((double)epsfac));
+
+  double entries = NNZ * ((double)Nf / N) * ((double)Mf / M);
+  auct = Prms.get_auctcost() * entries * phases
+    * (1 + nbid / (nbid + 4.0 * range))
+    * (1 + (1 - density) * nbid * nbid / (12 * entries));
+  jv = Prms.get_jvcost() * nbid * nobj * std::sqrt(nbid) * (2 - density);
+  jvsp = Prms.get_jvspcost() * entries * std::sqrt(nbid)
+    * (1 + std::log2(nobj));
+
+  if (engine == AuctParm::ENGINE_JVSP) return engine;
+  why = AuctMetric::WHY_COST;
+  int cheapest = (jvsp < auct) ? AuctParm::ENGINE_JVSP
+    : AuctParm::ENGINE_AUCTION;
+  if (cells > 2147483647.0) {
+    if (engine == AuctParm::ENGINE_JV) {
+      why = AuctMetric::WHY_DENSITY;
+      return AuctParm::ENGINE_AUCTION;
+    }
+    return cheapest;
+  }
+  if (engine == AuctParm::ENGINE_JV) return engine;
+  if (density < Prms.get_jvdensity()) return cheapest;
+  return (jv < std:: min(auct, jvsp)) ? AuctParm::ENGINE_JV : cheapest;
+}
+
+
+// Distributed auction.  The bidders (rows, or columns if there are
+// fewer) are split evenly over the processes of the transport, and
+// each process only bids for its own.  Every process keeps all the
+// prices: after each cycle, the prices it raised are sent to all the
+// others, and each object goes to the highest bid (ties to the higher
+// numbered bidder), so that all the processes agree.  The hidden bid,
+// the schedule and the result are then the same everywhere.
+AuctMetric AuctAlg::auctionD (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+			      AuctParm& Prms, AuctWorkspace& W)
+{
+  AuctTransport& T = *Prms.get_transport();
+  int N = Sh.nrows(), M = Sh.ncols();
+  int maxcycles = Prms.get_maxcycles();
+  bool EScale = Prms.EScale(), MESSG = Prms.MESSG() && T.rank() == 0;
+  AuctMetric metric;
+  int allocs = W.nallocs();
+
+  Sh.ifcompute();
+  if (Sh.nfullrows() != N || Sh.nfullcols() != M) {
+    if (MESSG) cerr << "Distributed auction needs single associations" << endl;
+    return auctionF (Pay, Sh, S, Prms, W);
+  }
+  if (!Pay.is_consistent(Sh) || !S.is_consistent(Sh) || N == 0 || M == 0) {
+    return metric;  // return with zero cycles
+  }
+  if (N == 1 && M == 1) EScale = false;
+
+  bool reorient_flag = (N > M) ? true : false;
+  metric.set_escaling(EScale);
+  metric.set_sparsified(Pay.dense_to_sparse());
+  metric.set_reoriented(reorient_flag);
+  if (MESSG && reorient_flag) cerr << "Reorienting payoff matrix" << endl;
+
+  AuctAlg::load_payoff(Pay, M, reorient_flag, std:: min(N, M)+1, W);
+  int nbid = reorient_flag ? M : N, nobj = reorient_flag ? N : M;
+  int *ptr = W.get(AuctWorkspace::PAYPTR), *ind = W.get(AuctWorkspace::PAYIND);
+  int *val = W.get(AuctWorkspace::PAYVAL);
+  AuctCSR<int> A (nbid, nobj, ptr, ind, val);
+  int *price = W.reserve(AuctWorkspace::SCRATCH, nobj);
+  int *bidobj = W.reserve(AuctWorkspace::BIDOBJ, nbid);
+  int *owner = W.reserve(AuctWorkspace::OBJBID, nobj);
+  int neglarge = -Prms.get_MAXINT();
+  int lo = (int)((long)nbid * T.rank() / T.size());
+  int hi = (int)((long)nbid * (T.rank()+1) / T.size());
+
+  if (reorient_flag) S.get_profits(price);
+  else S.get_prices(price);
+
+  std::vector<int> msg, changed;
+  std::vector<std::vector<int> > recv;
+  // A lost process stops the auction, as the time limit would, and
+  // the metric is marked failed.
+  bool lost = false;
+  auto exchange = [&] () {
+    if (!lost && !T.allgather(msg, recv)) lost = expired = true;
+    return !lost;
+  };
+  // The largest of an int over all the processes.
+  auto agree_max = [&] (int x) {
+    msg.assign(1, x);
+    if (!exchange()) return x;
+    for (int q = 0; q < T.size(); q++) x = std:: max(x, recv[q][0]);
+    return x;
+  };
+
+  // A cycle bids for this process's unassigned bidders against its
+  // copy of the prices, sends the raised prices (and whether this
+  // process is out of time), and merges those of the others.
+  int epsilon = 1, nassoc = 0;
+  auto cycle = [&] () {
+    int bestj, nextj, bestv, nextv, v, b, k, j, q, p, o;
+    bool late = (clockperiod != 0 && check_clock());
+    changed.clear();
+    for (b = lo; b < hi; b++) {
+      if (bidobj[b] != -1) continue;
+      bestj = nextj = -1;
+      bestv = nextv = neglarge;
+      for (k = ptr[b]; k < ptr[b+1]; k++) {
+	v = val[k] - price[ind[k]];
+	if (bestj == -1 || v > bestv) {
+	  nextj = bestj;  nextv = bestv;
+	  bestj = ind[k]; bestv = v;
+	} else if (nextj == -1 || v > nextv) {
+	  nextj = ind[k]; nextv = v;
+	}
+      }
+      if (bestj == -1) continue;   // empty row
+      if (owner[bestj] == -1) nassoc++;
+      else bidobj[owner[bestj]] = -1;
+      owner[bestj] = b;
+      bidobj[b] = bestj;
+      price[bestj] += std::max(bestv - nextv, 0) + epsilon;
+      changed.push_back(bestj);
+    }
+    std::sort (changed.begin(), changed.end());
+    changed.erase (std::unique(changed.begin(), changed.end()), changed.end());
+    msg.assign(1, late ? 1 : 0);
+    for (k = 0; k < (int)changed.size(); k++) {
+      msg.push_back(changed[k]);
+      msg.push_back(price[changed[k]]);
+      msg.push_back(owner[changed[k]]);
+    }
+    if (!exchange()) return;
+
+    for (q = 0; q < T.size(); q++) {
+      late = late || recv[q][0];
+      if (q == T.rank()) continue;
+      for (k = 1; k+2 < (int)recv[q].size(); k += 3) {
+	j = recv[q][k];  p = recv[q][k+1];  o = recv[q][k+2];
+	if (owner[j] == -1) nassoc++;
+	if (p > price[j] || (p == price[j] && o > owner[j])) {
+	  if (owner[j] >= lo && owner[j] < hi) bidobj[owner[j]] = -1;
+	  price[j] = p;
+	  owner[j] = o;
+	}
+      }
+    }
+    if (late) expired = true;
+  };
+  auto get_assoc = [&] () {
+    std::fill (bidobj, bidobj+nbid, -1);
+    for (int j = 0; j < nobj; j++) if (owner[j] != -1) bidobj[owner[j]] = j;
+  };
+
+  // Epsilon-scaling, as in auctionF.  The widest row range is taken
+  // over all the processes, which may each have only their own rows.
+  int assoc_thresh = std:: min(N, M);
+  metric.set_nmaxassoc(assoc_thresh);
+  int epsfac = Prms.get_epsfac();
+  int epsstart = (Prms.epsrelative())
+    ? (int)(std:: min(N,M) * Prms.get_epsstart() / Prms.get_res())
+    : (int)Prms.get_epsstart();
+  int range = agree_max(AuctAlg::payoff_range(A));
+  if (EScale && Prms.epsadaptive() && Prms.epsrelative())
+    epsstart = range / (std:: min(N,M)+1);
+  if (epsstart < 2 || epsfac < 2) epsstart = 1;
+  AuctAlg::bound_prices(price, nobj, range + std:: min(N,M)+1);
+  double gapunit = Prms.get_res() / (std:: min(N, M)+1);
+
+  int cycles = 0, phasecycles, bids, decision;
+  bool finished = false, snapped = false, last, more;
+  int snapeps = 0;
+  epsilon = EScale ? epsstart : std:: max(epsstart, 1);
+  for (;;) {
+    last = (!EScale || epsilon <= 1);
+    std::fill (owner, owner+nobj, -1);
+    std::fill (bidobj, bidobj+nbid, -1);
+    nassoc = 0;
+    if (MESSG) cerr << "Starting epsilon cycle: " << epsilon << endl;
+    if (trace) trace->begin(AuctTrace::PHASE, epsilon, assoc_thresh,
+			    AuctAlg::spread(price, nobj));
+    phasecycles = cycles;
+    bids = 0;
+    while (nassoc < assoc_thresh && cycles < maxcycles && !expired) {
+      if (trace) trace->begin(AuctTrace::CYCLES, cycles, assoc_thresh - nassoc);
+      while (nassoc < assoc_thresh && cycles < maxcycles && !expired) {
+	cycles++;
+	bids += assoc_thresh - nassoc;
+	cycle();
+      }
+      if (trace) trace->end(AuctTrace::CYCLES, cycles, assoc_thresh - nassoc,
+			    AuctAlg::spread(price, nobj));
+      if (EScale && !expired) {
+	if (trace) trace->begin(AuctTrace::HIDDEN_BID, epsilon,
+				assoc_thresh - nassoc);
+	get_assoc();
+	AuctAlg::hidden_bid_raw(nbid, nobj, price, bidobj, owner, nassoc, epsilon,
+				W);
+	if (trace) trace->end(AuctTrace::HIDDEN_BID, epsilon,
+			      assoc_thresh - nassoc, AuctAlg::spread(price, nobj));
+      }
+    }
+    phasecycles = cycles - phasecycles;
+    if (trace) trace->end(AuctTrace::PHASE, epsilon, assoc_thresh - nassoc,
+			  AuctAlg::spread(price, nobj));
+
+    if (nassoc < assoc_thresh || lost) {
+      AuctAlg::end_phase(metric, Prms, epsilon, phasecycles, bids, epsfac,
+			 AuctMetric::EPS_STOPPED, nassoc, cycles);
+      break;
+    }
+    if (last) {
+      AuctAlg::end_phase(metric, Prms, epsilon, phasecycles, bids, 1,
+			 AuctMetric::EPS_FINAL, nassoc, cycles);
+      finished = true;
+      break;
+    }
+    decision = AuctMetric::EPS_FIXED;
+    if (Prms.epsadaptive())
+      decision = AuctAlg::adapt_epsfac(epsilon, bids, assoc_thresh, epsfac);
+    AuctAlg::end_phase(metric, Prms, epsilon, phasecycles, bids, epsfac,
+		       decision, nassoc, cycles);
+
+    // Keep the phase's assignment, in case we run out of cycles or time.
+    // Each process has its own callback, and all stop if any asks to.
+    get_assoc();
+    std::copy (bidobj, bidobj+nbid, W.reserve(AuctWorkspace::SNAPCOL, nbid));
+    snapped = true;
+    snapeps = epsilon;
+    more = true;
+    if (Prms.get_callback()) {
+      AuctAlg::raw_to_assoc(nbid, bidobj, reorient_flag, S);
+      more = Prms.get_callback()->improved(Sh, S, assoc_thresh * epsilon * gapunit);
+    }
+    if (agree_max(more ? 0 : 1)) break;
+    if (cycles >= maxcycles || expired) break;
+    epsilon = (decision == AuctMetric::EPS_SKIP) ? 1 : std:: max(epsilon/epsfac, 1);
   }
 
+  get_assoc();
+  metric.set_ncycles(cycles);
+  metric.set_nauction_assoc(nassoc);
+  if (finished) {
+    metric.set_gap((epsilon > 1) ? assoc_thresh * epsilon * gapunit : 0);
+  } else {
+    // No process has the whole payoff, so the assignment is not filled.
+    metric.set_timed_out(true);
+    metric.set_expired(expired && !lost);
+    metric.set_failed(lost);
+    if (MESSG) cerr << "Auction stopped after " << cycles << " cycles" << endl;
+    if (snapped && nassoc < assoc_thresh)
+      std::copy (W.get(AuctWorkspace::SNAPCOL),
+		 W.get(AuctWorkspace::SNAPCOL)+nbid, bidobj);
+    metric.set_gap(snapped && !lost ? assoc_thresh * snapeps * gapunit : -1);
+  }
+
+  AuctAlg::raw_to_assoc(nbid, bidobj, reorient_flag, S);
+  if (reorient_flag) S.set_profits(price);
+  else S.set_prices(price);
+  if (finished && Prms.get_callback())
+    Prms.get_callback()->improved(Sh, S, metric.gap());
+
   metric.set_ntotal_assoc(S.nassoc());
+  metric.set_nallocs(W.nallocs() - allocs);
   return metric;
 }
 
+// Sharded auction.  The bidders (rows, or columns if there are fewer)
+// are split into one contiguous shard per thread, with about the same
+// number of non-zeros in each.  Every cycle, all the shards bid at once
+// against the shared prices, and then each drops the bidders who were
+// outbid.  The thread which called the auction runs the first shard,
+// and between cycles takes the same steps as auctionF: the hidden
+// bid, epsilon-scaling and the stopping rules.
+AuctMetric AuctAlg::auctionMT (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+			       AuctParm& Prms, AuctWorkspace& W)
+{
+  int N = Sh.nrows(), M = Sh.ncols();
+  int maxcycles = Prms.get_maxcycles();
+  bool EScale = Prms.EScale(), MESSG = Prms.MESSG();
+  AuctMetric metric;
+  int allocs = W.nallocs(), shardallocs = 0;
 
+  Sh.ifcompute();
+  if (Sh.nfullrows() != N || Sh.nfullcols() != M) {
+    if (MESSG) cerr << "Sharded auction needs single associations" << endl;
+    return auctionF (Pay, Sh, S, Prms, W);
+  }
+  if (!Pay.is_consistent(Sh) || !S.is_consistent(Sh) || N == 0 || M == 0) {
+    return metric;  // return with zero cycles
+  }
+  if (N == 1 && M == 1) EScale = false;
 
-// This function transposes a compressed, row-oriented matrix, x,
-// and puts the output into y.
-void AuctAlg::ctransp (InMat& x, IMat& y) {
+  bool reorient_flag = (N > M) ? true : false;
+  metric.set_escaling(EScale);
+  metric.set_sparsified(Pay.dense_to_sparse());
+  metric.set_reoriented(reorient_flag);
+  if (MESSG && reorient_flag) cerr << "Reorienting payoff matrix" << endl;
+
+  int NNZ = AuctAlg::load_payoff(Pay, M, reorient_flag, std:: min(N, M)+1, W);
+  int nbid = reorient_flag ? M : N, nobj = reorient_flag ? N : M;
+  int *ptr = W.get(AuctWorkspace::PAYPTR), *ind = W.get(AuctWorkspace::PAYIND);
+  int *val = W.get(AuctWorkspace::PAYVAL);
+  AuctCSR<int> A (nbid, nobj, ptr, ind, val);
+  int *price = W.reserve(AuctWorkspace::SCRATCH, nobj);
+  int *bidobj = W.reserve(AuctWorkspace::BIDOBJ, nbid);
+  int *objbid = W.reserve(AuctWorkspace::OBJBID, nobj);
+  int neglarge = -Prms.get_MAXINT();
+  int assoc_thresh = std:: min(N, M), nassoc = 0;
+  int b, j, t;
+
+  int nthr = std:: max(1, std:: min(Prms.get_nthreads(), nbid));
+  if (nthr > shardcap) {
+    delete [] shards;
+    shards = new AuctShard[nthr];
+    shardcap = nthr;
+  }
+  if (nobj > pricecap) {
+    delete [] packed;
+    packed = new AuctShard::PackedPrice[nobj];
+    pricecap = nobj;
+  }
+  for (t = 0; t < nthr; t++) shardallocs -= shards[t].nallocs();
+
+  // The prices in S (column prices, or row profits if reoriented) are
+  // the starting prices, so a warm start works as with auctionF.
+  int range = AuctAlg::payoff_range(A);
+  if (reorient_flag) S.get_profits(price);
+  else S.get_prices(price);
+  AuctAlg::bound_prices(price, nobj, range + std:: min(N,M)+1);
+  for (j = 0; j < nobj; j++) packed[j].store(AuctShard::pack(price[j], -1));
+
+  // Shard t has the bidders from first[t] up to first[t+1].
+  std::vector<int> first(nthr+1), count(nthr);
+  first[0] = 0;
+  first[nthr] = nbid;
+  for (t = 1; t < nthr; t++) {
+    first[t] = std::lower_bound (ptr, ptr+nbid+1, (int)((long)NNZ * t / nthr))
+      - ptr;
+    first[t] = std:: max(first[t], first[t-1]);
+  }
 
-  typedef mtl::matrix<int, mtl::rectangle<>, mtl::compressed<int, mtl::external,
-	  mtl::index_from_zero>, mtl::row_major>::type IMatExt;
+  // A cycle is a job for all the shards: LOAD their payoff, RESET
+  // their associations, BID and then CHECK, or only CHECK.
+  enum { LOAD, RESET, BID, CHECK, QUIT };
+  int job = LOAD, epsilon = 1;
+  AuctBarrier barrier(nthr);
+  std::function<void(int)> work = [&] (int t) {
+    count[t] = 0;
+    switch (job) {
+    case LOAD:  shards[t].load(first[t], first[t+1], ptr, ind, val);  break;
+    case RESET: shards[t].reset();  break;
+    case BID:   shards[t].bid(packed, epsilon, neglarge);  barrier.wait();
+      [[fallthrough]];	// and then check
+    case CHECK: count[t] = shards[t].check(packed);  break;
+    }
+  };
+  std::vector<std::thread> workers;
+  for (t = 1; t < nthr; t++) {
+    workers.push_back(std::thread([&, t] () {
+      for (;;) {
+	barrier.wait();
+	if (job == QUIT) break;
+	work(t);
+	barrier.wait();
+      }
+    }));
+  }
+  auto cycle = [&] (int what) {
+    int n = 0;
+    job = what;
+    if (nthr > 1) barrier.wait();
+    work(0);
+    if (nthr > 1) barrier.wait();
+    for (int t = 0; t < nthr; t++) n += count[t];
+    return n;
+  };
+  cycle(LOAD);
+
+  // The hidden bid is made on unpacked copies of the prices.
+  auto hidden_bid = [&] (int& nassoc) {
+    for (int j = 0; j < nobj; j++) {
+      price[j] = AuctShard::price_of(packed[j].load());
+      objbid[j] = AuctShard::bidder_of(packed[j].load());
+    }
+    std::fill (bidobj, bidobj+nbid, -1);
+    for (int j = 0; j < nobj; j++) if (objbid[j] != -1) bidobj[objbid[j]] = j;
+    if (trace) trace->begin(AuctTrace::HIDDEN_BID, epsilon, assoc_thresh - nassoc);
+    AuctAlg::hidden_bid_raw(nbid, nobj, price, bidobj, objbid, nassoc, epsilon, W);
+    for (int j = 0; j < nobj; j++)
+      packed[j].store(AuctShard::pack(price[j], objbid[j]));
+    nassoc = cycle(CHECK);
+    if (trace) trace->end(AuctTrace::HIDDEN_BID, epsilon, assoc_thresh - nassoc,
+			  AuctAlg::spread(price, nobj));
+  };
+  auto get_assoc = [&] () {
+    std::fill (bidobj, bidobj+nbid, -1);
+    for (int j = 0; j < nobj; j++) {
+      price[j] = AuctShard::price_of(packed[j].load());
+      objbid[j] = AuctShard::bidder_of(packed[j].load());
+      if (objbid[j] != -1) bidobj[objbid[j]] = j;
+    }
+  };
+  auto timeout = [&] () { return past_deadline(); };
+  auto packed_spread = [&] () {
+    for (int j = 0; j < nobj; j++)
+      price[j] = AuctShard::price_of(packed[j].load());
+    return AuctAlg::spread(price, nobj);
+  };
+
+  // Epsilon-scaling, as in auctionF.
+  metric.set_nmaxassoc(assoc_thresh);
+  int epsfac = Prms.get_epsfac();
+  int epsstart = (Prms.epsrelative())
+    ? (int)(std:: min(N,M) * Prms.get_epsstart() / Prms.get_res())
+    : (int)Prms.get_epsstart();
+  if (EScale && Prms.epsadaptive() && Prms.epsrelative())
+    epsstart = range / (std:: min(N,M)+1);
+  if (epsstart < 2 || epsfac < 2) epsstart = 1;
+  if (!EScale) epsstart = std:: max(epsstart, 1);
+  double gapunit = Prms.get_res() / (std:: min(N, M)+1);
+
+  int cycles = 0, phasecycles, bids, decision;
+  bool finished = false, snapped = false, last;
+  int snapeps = 0;
+  epsilon = EScale ? epsstart : std:: max(epsstart, 1);
+  for (;;) {
+    last = (!EScale || epsilon <= 1);
+    for (j = 0; j < nobj; j++)
+      packed[j].store(AuctShard::pack(AuctShard::price_of(packed[j].load()), -1));
+    nassoc = cycle(RESET);
+    if (MESSG) cerr << "Starting epsilon cycle: " << epsilon << endl;
+    if (trace) trace->begin(AuctTrace::PHASE, epsilon, assoc_thresh - nassoc,
+			    packed_spread());
+    phasecycles = cycles;
+    bids = 0;
+    while (nassoc < assoc_thresh && cycles < maxcycles && !expired) {
+      if (trace) trace->begin(AuctTrace::CYCLES, cycles, assoc_thresh - nassoc);
+      while (nassoc < assoc_thresh && cycles < maxcycles && !timeout()) {
+	cycles++;
+	bids += assoc_thresh - nassoc;
+	nassoc = cycle(BID);
+      }
+      if (trace) trace->end(AuctTrace::CYCLES, cycles, assoc_thresh - nassoc,
+			    packed_spread());
+      if (EScale) hidden_bid(nassoc);
+    }
+    phasecycles = cycles - phasecycles;
+    if (trace) trace->end(AuctTrace::PHASE, epsilon, assoc_thresh - nassoc,
+			  packed_spread());
+
+    if (nassoc < assoc_thresh) {
+      AuctAlg::end_phase(metric, Prms, epsilon, phasecycles, bids, epsfac,
+			 AuctMetric::EPS_STOPPED, nassoc, cycles);
+      break;
+    }
+    if (last) {
+      AuctAlg::end_phase(metric, Prms, epsilon, phasecycles, bids, 1,
+			 AuctMetric::EPS_FINAL, nassoc, cycles);
+      finished = true;
+      break;
+    }
+    decision = AuctMetric::EPS_FIXED;
+    if (Prms.epsadaptive())
+      decision = AuctAlg::adapt_epsfac(epsilon, bids, assoc_thresh, epsfac);
+    AuctAlg::end_phase(metric, Prms, epsilon, phasecycles, bids, epsfac,
+		       decision, nassoc, cycles);
+
+    // Keep the phase's assignment, in case we run out of cycles or time.
+    get_assoc();
+    std::copy (bidobj, bidobj+nbid, W.reserve(AuctWorkspace::SNAPCOL, nbid));
+    snapped = true;
+    snapeps = epsilon;
+    if (Prms.get_callback()) {
+      AuctAlg::raw_to_assoc(nbid, bidobj, reorient_flag, S);
+      if (!Prms.get_callback()->improved(Sh, S, assoc_thresh * epsilon * gapunit))
+	break;
+    }
+    if (cycles >= maxcycles || expired) break;
+    epsilon = (decision == AuctMetric::EPS_SKIP) ? 1 : std:: max(epsilon/epsfac, 1);
+  }
 
-  int N = x.nrows(), M = x.ncols(), NNZ = x.nnz();
+  job = QUIT;
+  if (nthr > 1) barrier.wait();
+  for (t = 0; t < (int)workers.size(); t++) workers[t].join();
+  get_assoc();
 
-  InMat::iterator k;
-  InMat::OneD::iterator *iter, *iter_end, tk;
-  iter = new InMat::OneD::iterator[N];
-  iter_end = new InMat::OneD::iterator[N];
+  metric.set_ncycles(cycles);
+  metric.set_nauction_assoc(nassoc);
+  if (finished) {
+    metric.set_gap((epsilon > 1) ? assoc_thresh * epsilon * gapunit : 0);
+  } else {
+    metric.set_timed_out(true);
+    metric.set_expired(expired);
+    if (MESSG) cerr << "Auction stopped after " << cycles << " cycles" << endl;
+    if (snapped && nassoc < assoc_thresh) {
+      std::copy (W.get(AuctWorkspace::SNAPCOL),
+		 W.get(AuctWorkspace::SNAPCOL)+nbid, bidobj);
+      std::fill (objbid, objbid+nobj, -1);
+      for (b = 0; b < nbid; b++) if (bidobj[b] != -1) objbid[bidobj[b]] = b;
+    }
+    AuctAlg::greedy_raw(nbid, ptr, ind, val, bidobj, objbid);
+    metric.set_gap(snapped ? assoc_thresh * snapeps * gapunit : -1);
+  }
+
+  AuctAlg::raw_to_assoc(nbid, bidobj, reorient_flag, S);
+  if (reorient_flag) S.set_profits(price);
+  else S.set_prices(price);
+  if (finished && Prms.get_callback())
+    Prms.get_callback()->improved(Sh, S, metric.gap());
+
+  for (t = 0; t < nthr; t++) shardallocs += shards[t].nallocs();
+  metric.set_ntotal_assoc(S.nassoc());
+  metric.set_nallocs(W.nallocs() - allocs + shardallocs);
+  return metric;
+}
 
-  int *ind, *npt, *nval, *nind;
-  int curpt = 0;
-  int i,j;
 
-  ind = new int [N];
-  npt = new int [M+1];
-  nval = new int [NNZ];
-  nind = new int [NNZ];
+// Pruned auction.  The best prunek entries of each bidder are kept, the
+// auction is run on those, and entries which turn out to matter are
+// put back until the result satisfies e-CS on the whole payoff.
+AuctMetric AuctAlg::auctionP (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+			      AuctParm& Prms, AuctWorkspace& W)
+{
+  int N = Sh.nrows(), k = Prms.get_prunek();
+  int M = Sh.ncols(), row, p, b, i, kth, nnz, kept, widest = 0;
+  int cycles = 0, nreadmit = 0, npruned = 0, fullnnz = Sh.nnz();
+  int allocs = W.nallocs();
 
-  for (j=0; j<N; j++) ind[j] = -1;
+  if (Sh.nfullrows() != N || Sh.nfullcols() != M || !Pay.is_consistent(Sh)) {
+    return auctionF (Pay, Sh, S, Prms, W);
+  }
 
-  for (k=x.begin(); k<x.end(); k++) {
-    tk = (*k).begin();
-    if (tk < (*k).end()) {
-      iter[tk.row()]=tk;
-      iter_end[tk.row()] = (*k).end();
-      ind[tk.row()] =tk.column();
+  // The bidders are the rows, or the columns if the auction will be
+  // reoriented.  Group the entries by bidder.
+  bool byrow = (N <= M);
+  int nbid = byrow ? N : M, nobj = byrow ? M : N;
+  nnz = Pay.get_rowptr(N)-1;             // AuctPay indexes from 1
+  int *keep   = W.reserve(AuctWorkspace::PRKEEP, nnz);
+  int *bidptr = W.reserve(AuctWorkspace::PRBPTR, nbid+1);
+  int *bident = W.reserve(AuctWorkspace::PRBENT, nnz);
+  int *object = W.reserve(AuctWorkspace::PROBJ, nnz);
+  std::fill (keep, keep+nnz, 1);
+  std::fill (bidptr, bidptr+nbid+1, 0);
+  for (row = 0; row < N; row++)
+    for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++)
+      bidptr[(byrow ? row : Pay.get_col(p)-1) + 1]++;
+  for (b = 0; b < nbid; b++) {
+    widest = std:: max(widest, bidptr[b+1]);
+    bidptr[b+1] += bidptr[b];
+  }
+  // The next entry of each bidder, and then the values of one bidder.
+  int *next = W.reserve(AuctWorkspace::SCRATCH, std:: max(nbid, widest));
+  int *bidvals = next;
+  std::copy (bidptr, bidptr+nbid, next);
+  for (row = 0; row < N; row++) {
+    for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++) {
+      bident[next[byrow ? row : Pay.get_col(p)-1]++] = p;
+      object[p] = byrow ? Pay.get_col(p)-1 : row;
     }
   }
 
-  for (i=0; i<M; i++) {
-    npt[i] = curpt;
-    for (j=0; j<N; j++) {
-      if (ind[j] == i) {
-	nval[curpt] = *iter[j];
-	nind[curpt] = iter[j].row();
-	curpt++;
-	iter[j]++;
-	ind[j] = (iter[j] < iter_end[j]) ? iter[j].column() : -1;
+  // Keep the entries at or above the k-th best value of each bidder.
+  // Once the time has run out, the rest are kept whole, and the
+  // auction on them returns at once.
+  for (b = 0; b < nbid; b++) {
+    if (out_of_time()) break;
+    if (bidptr[b+1] - bidptr[b] <= k) continue;
+    for (i = bidptr[b]; i < bidptr[b+1]; i++)
+      bidvals[i-bidptr[b]] = Pay.get_value(bident[i]);
+    std::nth_element(bidvals, bidvals+k-1, bidvals+bidptr[b+1]-bidptr[b],
+		     std::greater<int>());
+    kth = bidvals[k-1];
+    for (i = bidptr[b]; i < bidptr[b+1]; i++)
+      keep[bident[i]] = Pay.get_value(bident[i]) >= kth;
+  }
+
+  // A maximum matching of the full payoff is kept as well, so that
+  // pruning never makes the problem less feasible than it was.
+  if (!past_deadline())
+    keep_matching (bidptr, bident, object, nbid, nobj, keep, W);
+
+  // The pruned payoff is a view of the workspace, with the rows and
+  // columns of Sh, which stands for its shape while it is bid upon.
+  int *pptr = W.reserve(AuctWorkspace::PRPTR, N+1);
+  int *pind = W.reserve(AuctWorkspace::PRIND, nnz);
+  int *pval = W.reserve(AuctWorkspace::PRVAL, nnz);
+  AuctParm P(Prms);
+  AuctMetric metric;
+  int added = 1;
+  while (added > 0) {
+    for (row = 0, kept = 0; row < N; row++) {
+      pptr[row] = kept;
+      for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++) {
+	if (!keep[p]) continue;
+	pind[kept] = Pay.get_col(p)-1;
+	pval[kept++] = Pay.get_value(p);
       }
     }
+    pptr[N] = kept;
+    AuctPay SubPay(Sh, pptr, pind, pval, 0);
+    metric = auctionF (SubPay, Sh, S, P, W);
+    cycles += metric.ncycles();
+    if (metric.timed_out()) break;
+    added = readmit (Pay, S, P, keep, metric.reoriented(), W);
+    nreadmit += added;
+    if (P.MESSG() && added > 0)
+      cerr << "Re-admitting " << added << " pruned entries" << endl;
+
+    // The prices in S satisfy e-CS for the entries already kept, so
+    // the next round may start directly at epsilon = 1.
+    if (P.EScale()) {
+      P.set_epsrelative(false);
+      P.set_epsstart(1);
+    }
+  }
+  Prms.set_epsilon(P.get_epsilon());
+  Sh.set_nnz(fullnnz);
+
+  // Stopped early, the assignment was only filled from the entries
+  // kept, and the gap only bounds it on those.  Fill it from the full
+  // payoff, oriented as auctionF would; the gap is then unknown.
+  for (p = 0; p < nnz; p++) if (!keep[p]) npruned++;
+  if (metric.timed_out() && npruned > 0) {
+    if (!byrow) AuctAlg::transpose(Sh, S);
+    AuctAlg::load_payoff(Pay, M, !byrow, std:: min(N, M)+1, W);
+    AuctCSR<int> A (nbid, nobj, W.get(AuctWorkspace::PAYPTR),
+		    W.get(AuctWorkspace::PAYIND), W.get(AuctWorkspace::PAYVAL));
+    AuctAlg::greedy_fill (A, Sh, S, Prms);
+    if (!byrow) AuctAlg::transpose(Sh, S);
+    metric.set_gap(-1);
+    metric.set_ntotal_assoc(S.nassoc());
   }
-  npt[M] = curpt;
+  metric.set_ncycles(cycles);
+  metric.set_npruned(npruned);
+  metric.set_nreadmitted(nreadmit);
+  metric.set_nallocs(W.nallocs() - allocs);
+  metric.set_paydensity((double)nnz / ((double)N * M));
+  metric.set_sparsified(Pay.dense_to_sparse());
+  return metric;
+}
+
+// Augmenting paths (Kuhn's algorithm), searched depth-first with an
+// explicit stack.  Each bidder on the stack is tried against its
+// entries in turn; when a free object is reached, every bidder on the
+// stack moves to the object its last tried entry points at.
+void AuctAlg::keep_matching (int* bidptr, int* bident, int* object,
+			     int nbid, int nobj, int* keep, AuctWorkspace& W) {
+
+  int b, u, w, i, obj, k, top;
+  int *bidmate = W.reserve(AuctWorkspace::PRMATE, nbid);
+  int *objmate = W.reserve(AuctWorkspace::PROMATE, nobj);
+  int *pos     = W.reserve(AuctWorkspace::PRPOS, nbid);
+  int *seen    = W.reserve(AuctWorkspace::PRSEEN, nbid);
+  int *stack   = W.reserve(AuctWorkspace::PRSTACK, nbid);
+  std::fill (bidmate, bidmate+nbid, -1);
+  std::fill (objmate, objmate+nobj, -1);
+  std::fill (seen, seen+nbid, -1);
+
+  // Cheap assignment first: any bidder with a free object takes it.
+  for (b = 0; b < nbid; b++) {
+    for (i = bidptr[b]; i < bidptr[b+1]; i++) {
+      obj = object[bident[i]];
+      if (objmate[obj] == -1) {
+	objmate[obj] = b;
+	bidmate[b] = i;
+	break;
+      }
+    }
+  }
+
+  for (b = 0; b < nbid; b++) {
+    if (bidmate[b] != -1) continue;
+    top = 0;
+    stack[top++] = b;
+    seen[b] = b;
+    pos[b] = bidptr[b];
+    while (top > 0) {
+      u = stack[top-1];
+      if (pos[u] == bidptr[u+1]) {
+	top--;
+	continue;
+      }
+      i = pos[u]++;
+      w = objmate[object[bident[i]]];
+      if (w == -1) {
+	for (k = top-1; k >= 0; k--) {
+	  u = stack[k];
+	  bidmate[u] = pos[u]-1;
+	  objmate[object[bident[bidmate[u]]]] = u;
+	}
+	break;
+      }
+      if (seen[w] != b) {
+	seen[w] = b;
+	pos[w] = bidptr[w];
+	stack[top++] = w;
+      }
+    }
+  }
+
+  for (b = 0; b < nbid; b++) if (bidmate[b] != -1) keep[bident[bidmate[b]]] = 1;
+}
+
+// The bidders are the rows, or the columns if the auction was
+// reoriented, and their prices are then found in the profits of S.
+// Each bidder's profit is taken from its association, and a pruned
+// entry is re-admitted if it beats that by more than epsilon.
+int AuctAlg::readmit (AuctPay& Pay, AuctAssoc& S, AuctParm& Prms,
+		      int* keep, bool reoriented, AuctWorkspace& W) {
+
+  int N = S.nrows(), M = S.ncols();
+  int scale = std:: min(N, M)+1, epsilon = Prms.get_epsilon();
+  int row, col, p, bidder, price, maxval = 0, nadded = 0;
+  int nbid = reoriented ? M : N, nobj = reoriented ? N : M;
+  int *profit = W.reserve(AuctWorkspace::PRPROF, nbid);
+  int *assoc  = W.reserve(AuctWorkspace::PRASSOC, nbid);
+  std::fill (assoc, assoc+nbid, 0);
+
+  for (row = 0; row < N; row++) {
+    for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++) {
+      col = Pay.get_col(p)-1;
+      maxval = std:: max(maxval, scale * Pay.get_value(p));
+      if (keep[p] && S.col(row) == col) {
+	bidder = reoriented ? col : row;
+	price  = reoriented ? S.Prof(row) : S.Price(col);
+	profit[bidder] = scale * Pay.get_value(p) - price;
+	assoc[bidder]  = 1;
+      }
+    }
+  }
+
+  for (row = 0; row < N; row++) {
+    for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++) {
+      if (keep[p]) continue;
+      col = Pay.get_col(p)-1;
+      bidder = reoriented ? col : row;
+      price  = reoriented ? S.Prof(row) : S.Price(col);
+      if (!assoc[bidder] ||
+	  scale * Pay.get_value(p) - price > profit[bidder] + epsilon) {
+	keep[p] = 1;
+	nadded++;
+      }
+    }
+  }
+
+  // A bidder left with a single kept entry bids its object up towards
+  // MAXINT.  Cap the object prices at the largest payoff, so that the
+  // next round need not climb to them one epsilon at a time.
+  if (nadded > 0) {
+    int *prices = W.reserve(AuctWorkspace::SCRATCH, nobj);
+    if (reoriented) S.get_profits(prices);
+    else S.get_prices(prices);
+    for (p = 0; p < nobj; p++)
+      prices[p] = std:: min(prices[p], maxval);
+    if (reoriented) S.set_profits(prices);
+    else S.set_prices(prices);
+  }
+  return nadded;
+}
 
-  IMatExt temp (M, N, NNZ, nval, npt, nind);
-  mtl::copy (temp, y);
+
+// The widest spread of values within any one row.  Rows with a
+// single entry have nothing to choose between, and do not count.
+int AuctAlg::payoff_range (AuctCSR<int>& A) {
+  int range = 0, lo, hi, i, k;
+
+  for (i = 0; i < A.nrows(); i++) {
+    AuctCSR<int>::Row r = A.row(i);
+    if (r.size == 0) continue;
+    lo = hi = r.val[0];
+    for (k = 1; k < r.size; k++) {
+      lo = std:: min(lo, r.val[k]);
+      hi = std:: max(hi, r.val[k]);
+    }
+    range = std:: max(range, hi - lo);
+  }
+  return range;
+}
+
+// Hopcroft-Karp on the payoff's pattern, with each row and column
+// group of the shape taking as many associations as its multiplicity
+// (and each entry as many as the smaller of the two): a maximum flow
+// found by shortest augmenting paths, phase by phase, which is
+// Hopcroft-Karp itself when every multiplicity is one.  A greedy pass
+// first associates whatever it can; when that is everything, as it
+// is for any dense payoff, there is nothing to search and the
+// entry-sized arrays are not allocated.
+int AuctAlg::max_cardinality (AuctCSR<int>& A, AuctShape& Sh,
+			      AuctWorkspace& W) {
+  int N = A.nrows(), M = A.ncols(), NNZ = A.nnz();
+  int *ptr = A.rowptr(), *ind = A.colind();
+  int *rrem = W.reserve(AuctWorkspace::MCREM, N+M), *crem = rrem + N;
+  int *dist = W.reserve(AuctWorkspace::MCDIST, N+M), *cdist = dist + N;
+  int i, j, k, b, head, tail, level, top, f, total = 0;
+
+  for (i = 0; i < N; i++) rrem[i] = Sh.get_rowmult(i);
+  for (j = 0; j < M; j++) crem[j] = Sh.get_colmult(j);
+  for (i = 0; i < N; i++)
+    for (k = ptr[i]; k < ptr[i+1] && rrem[i] > 0; k++) {
+      f = std:: min(rrem[i], crem[ind[k]]);
+      rrem[i] -= f;
+      crem[ind[k]] -= f;
+      total += f;
+    }
+  std::fill (dist, dist+N+M, -1);
+  if (total == std:: min(Sh.nfullrows(), Sh.nfullcols())) return total;
+
+  int *flow = W.reserve(AuctWorkspace::MCFLOW, NNZ+1);
+  int *cptr = W.reserve(AuctWorkspace::MCCPTR, M+1);
+  int *crow = W.reserve(AuctWorkspace::MCCROW, NNZ+1);
+  int *cent = W.reserve(AuctWorkspace::MCCENT, NNZ+1);
+  int *itf = W.reserve(AuctWorkspace::MCITER, N+M), *itb = itf + N;
+  int *stack = W.reserve(AuctWorkspace::MCSTACK, 3*(N+1));
+  int *rs = stack, *fk = stack + N+1, *bk = stack + 2*(N+1);
+
+  // The entries of each column, by row.
+  std::fill (cptr, cptr+M+1, 0);
+  for (k = 0; k < NNZ; k++) cptr[ind[k]+1]++;
+  for (j = 0; j < M; j++) cptr[j+1] += cptr[j];
+  for (j = 0; j < M; j++) itb[j] = cptr[j];
+  for (i = 0; i < N; i++)
+    for (k = ptr[i]; k < ptr[i+1]; k++) {
+      crow[itb[ind[k]]] = i;
+      cent[itb[ind[k]]++] = k;
+    }
+
+  // The greedy associations again, as the flow of each entry.
+  for (i = 0; i < N; i++) rrem[i] = Sh.get_rowmult(i);
+  for (j = 0; j < M; j++) crem[j] = Sh.get_colmult(j);
+  for (i = 0; i < N; i++)
+    for (k = ptr[i]; k < ptr[i+1]; k++) {
+      flow[k] = std:: min(rrem[i], crem[ind[k]]);
+      rrem[i] -= flow[k];
+      crem[ind[k]] -= flow[k];
+    }
+
+  while (true) {
+    // Breadth first from the rows with room, through entries with room
+    // to their columns, and back through entries with flow to the rows
+    // which hold them, until the nearest columns with room.
+    std::fill (dist, dist+N+M, -1);
+    head = tail = 0;
+    for (i = 0; i < N; i++)
+      if (rrem[i] > 0) {
+	dist[i] = 0;
+	rs[tail++] = i;
+      }
+    level = -1;
+    while (head < tail) {
+      i = rs[head++];
+      if (level != -1 && dist[i] > level) break;
+      for (k = ptr[i]; k < ptr[i+1]; k++) {
+	j = ind[k];
+	if (flow[k] >= std:: min(Sh.get_rowmult(i), Sh.get_colmult(j))
+	    || cdist[j] != -1) continue;
+	cdist[j] = dist[i];
+	if (crem[j] > 0) {
+	  level = dist[i];
+	  continue;
+	}
+	for (b = cptr[j]; b < cptr[j+1]; b++)
+	  if (flow[cent[b]] > 0 && dist[crow[b]] == -1) {
+	    dist[crow[b]] = dist[i] + 1;
+	    rs[tail++] = crow[b];
+	  }
+      }
+    }
+    if (level == -1) break;
+
+    // Augment along shortest paths, one association at a time, each row
+    // and column walking its entries once for the phase; a row with no
+    // way on is taken out of the phase.
+    for (i = 0; i < N; i++) itf[i] = ptr[i];
+    for (j = 0; j < M; j++) itb[j] = cptr[j];
+    for (int s = 0; s < N; s++) {
+      while (rrem[s] > 0 && dist[s] == 0) {
+	bool found = false;
+	rs[0] = s;
+	top = 0;
+	while (top >= 0 && !found) {
+	  bool advanced = false;
+	  i = rs[top];
+	  for (; itf[i] < ptr[i+1] && !advanced && !found; ) {
+	    k = itf[i];
+	    j = ind[k];
+	    if (flow[k] >= std:: min(Sh.get_rowmult(i), Sh.get_colmult(j))
+		|| cdist[j] != dist[i]) {
+	      itf[i]++;
+	      continue;
+	    }
+	    fk[top] = k;
+	    if (dist[i] == level) {
+	      if (crem[j] > 0) found = true;
+	      else itf[i]++;
+	      continue;
+	    }
+	    for (; itb[j] < cptr[j+1]; itb[j]++) {
+	      b = itb[j];
+	      if (flow[cent[b]] > 0 && dist[crow[b]] == dist[i] + 1) {
+		bk[top] = b;
+		rs[++top] = crow[b];
+		advanced = true;
+		break;
+	      }
+	    }
+	    if (!advanced) itf[i]++;
+	  }
+	  if (!advanced && !found) {
+	    dist[i] = -2;
+	    top--;
+	  }
+	}
+	if (!found) break;
+	for (b = 0; b <= top; b++) flow[fk[b]]++;
+	for (b = 0; b < top; b++) flow[cent[bk[b]]]--;
+	crem[ind[fk[top]]]--;
+	rrem[s]--;
+	total++;
+      }
+    }
+  }
+
+  return total;
+}
+
+int AuctAlg::bound_prices (int* price, int nobj, int span) {
+  int j, changed = 0;
+  if (nobj == 0) return 0;
+  int lo = *std::min_element(price, price+nobj);
+  for (j = 0; j < nobj; j++) {
+    int p = std:: min(price[j] - lo, span);
+    if (p != price[j]) {
+      price[j] = p;
+      changed++;
+    }
+  }
+  return changed;
+}
+
+// Every phase starts from a blank association, so it makes at least
+// one bid per bidder.  The bids beyond that are displacements: few of
+// them mean the prices were already close to this epsilon, and the
+// next can be cut harder; many mean a price war, and a gentler cut.
+// When the phase was cheap and the next would be the last before
+// epsilon = 1, it is not worth running.
+int AuctAlg::adapt_epsfac (int eps, int bids, int nbidders, int& epsfac) {
+
+  const int FACMIN = 2, FACMAX = 64;
+  int extra = bids - nbidders;
+
+  if (2*extra < nbidders) {
+    if (eps/epsfac < epsfac) return AuctMetric::EPS_SKIP;
+    if (epsfac < FACMAX) {
+      epsfac = std:: min(2*epsfac, FACMAX);
+      return AuctMetric::EPS_FASTER;
+    }
+  } else if (extra > 2*nbidders && epsfac > FACMIN) {
+    epsfac = std:: max(epsfac/2, FACMIN);
+    return AuctMetric::EPS_BACKOFF;
+  }
+  return AuctMetric::EPS_KEEP;
+}
+
+// This function copies the (one based, unless a view) payoff into the
+// (zero based) workspace arrays, scaling each value.  If requested, the
+// payoff is transposed on the way, by counting the entries of each
+// column and then scattering the rows into place.  Rows are visited in
+// order, so the columns of the transpose come out sorted.
+int AuctAlg::load_payoff (AuctPay& Pay, int M, bool transp, int scale,
+			  AuctWorkspace& W) {
+
+  int N = Pay.nrows();
+  int NNZ = Pay.get_rowpt()[N] - Pay.get_base();
+  int nptr = (transp ? M : N) + 1;
+
+  if (trace) trace->begin(AuctTrace::SCALE, NNZ);
+  load_csr (N, M, Pay.get_rowpt(), Pay.get_indpt(), Pay.get_valpt(),
+	    Pay.get_base(), transp, scale, W.reserve(AuctWorkspace::PAYPTR, nptr),
+	    W.reserve(AuctWorkspace::PAYIND, NNZ),
+	    W.reserve(AuctWorkspace::PAYVAL, NNZ),
+	    transp ? W.reserve(AuctWorkspace::SCRATCH, M+1) : 0);
+  if (trace) trace->end(AuctTrace::SCALE, NNZ);
+  return NNZ;
+}
+
+int AuctAlg::load_fpayoff (AuctPay& Pay, int M, bool transp, AuctWorkspace& W) {
+
+  int N = Pay.nrows();
+  int NNZ = Pay.get_rowpt()[N] - Pay.get_base();
+  int nptr = (transp ? M : N) + 1;
+
+  if (trace) trace->begin(AuctTrace::SCALE, NNZ);
+  load_csr (N, M, Pay.get_rowpt(), Pay.get_indpt(), Pay.get_fvalpt(),
+	    Pay.get_base(), transp, 1.0, W.reserve(AuctWorkspace::PAYPTR, nptr),
+	    W.reserve(AuctWorkspace::PAYIND, NNZ),
+	    W.dreserve(AuctWorkspace::DPAYVAL, NNZ),
+	    transp ? W.reserve(AuctWorkspace::SCRATCH, M+1) : 0);
+  if (trace) trace->end(AuctTrace::SCALE, NNZ);
+  return NNZ;
+}
+
+// The copying, for either kind of payoff.
+template <class V>
+void AuctAlg::load_csr (int N, int M, int* rowpt, int* ind, V* val,
+			int base, bool transp, V scale,
+			int* aptr, int* aind, V* aval, int* next) {
+
+  int NNZ = rowpt[N] - base;
+  int i, k, pos;
+
+  if (!transp) {
+    for (i = 0; i <= N; i++) aptr[i] = rowpt[i] - base;
+    for (k = 0; k < NNZ; k++) {
+      aval[k] = scale * val[k];
+      aind[k] = ind[k] - base;
+    }
+    return;
+  }
+
+  std::fill (aptr, aptr+M+1, 0);
+  for (k = 0; k < NNZ; k++) aptr[ind[k]-base+1]++;
+  for (i = 0; i < M; i++) aptr[i+1] += aptr[i];
+  std::copy (aptr, aptr+M+1, next);
+
+  for (i = 0; i < N; i++) {
+    for (k = rowpt[i]-base; k < rowpt[i+1]-base; k++) {
+      pos = next[ind[k]-base]++;
+      aval[pos] = scale * val[k];
+      aind[pos] = i;
+    }
+  }
 }
 
 
@@ -249,22 +2171,23 @@ void AuctAlg::ctransp (InMat& x, IMat& y) {
 // of the Association Matrix, and the Prices. e-CS is a necessary
 // condition for optimality, and a full e-CS association with small
 // enough e-CS is guaranteed to be optimal.
-void AuctAlg::checkecs (IMat& A,AuctShape& Sh,AuctAssoc& S,AuctParm& Prms) {
+void AuctAlg::checkecs (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+			AuctParm& Prms,
+			AuctWorkspace& W) {
 
   int diff;
   int tmp, aij, p;
   int bestval, bestcol, bestpr, bestaij, bestcolS;
   int maxval, maxcol, maxpr, maxaij, maxcolS;
-  IMat::OneD::iterator j;
   int minassign, maxunass;
   int rowA, colA, rowS, colS;
 
   bestcol = bestpr = bestaij = bestcolS = 0;
   maxcol = maxpr = maxaij = maxcolS = 0;
 
+  if (trace) trace->begin(AuctTrace::CHECKECS, Prms.get_epsilon());
   S.group_price_equalize(Sh);
-  int *P;
-  P = new int [Sh.nfullcols()];
+  int *P = W.reserve(AuctWorkspace::SCRATCH, Sh.nfullcols());
   S.get_prices(P);
 
 
@@ -307,35 +2230,39 @@ void AuctAlg::checkecs (IMat& A,AuctShape& Sh,AuctAssoc& S,AuctParm& Prms) {
   minassign = S.get_minassoc();
   maxunass = S.get_maxunass();
   cout << "lambda: " << maxunass << "  Min Assign: " << minassign << endl;
+  if (trace) trace->end(AuctTrace::CHECKECS, Prms.get_epsilon(), -1,
+			AuctAlg::spread(P, Sh.nfullcols()));
 
 }
 
 // This subroutine runs if the number of auction cycles hits the
 // maximum allowed.  It greedily makes some associations to improve the
 // partial answer offered by the auction algorithm.
-void AuctAlg::greedy_fill (IMat& A, AuctShape& Sh, AuctAssoc& S,
+void AuctAlg::greedy_fill (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
 			   AuctParm& Prms) {
 
-  int maxbid, maxbidcol, assoccol;
-  IMat::OneD::iterator j;
-  int minassoc = min(Sh.nfullrows(), Sh.nfullcols());
+  int maxbid, maxbidcol, assoccol, grp, j;
+  int minassoc = std:: min(Sh.nfullrows(), Sh.nfullcols());
 
+  if (trace) trace->begin(AuctTrace::GREEDY_FILL, S.nassoc(),
+			  minassoc - S.nassoc());
   for (int i = 0; i < Sh.nfullrows() && S.nassoc() < minassoc; i++) {
     if  (S.col(i) == -1) {
       maxbidcol = -1;
       maxbid = -Prms.get_MAXINT();
-      for (j = A[Sh.get_rowmap(i)].begin(); j<A[Sh.get_rowmap(i)].end(); j++) {
-		assoccol = -1;
-	    if (maxbid < *j) {
-	  for (int k=Sh.get_colptr(j.column());
-	       k<Sh.get_colptr(j.column()+1); k++) {
+      AuctCSR<int>::Row r = A.row(Sh.get_rowmap(i));
+      for (j = 0; j < r.size; j++) {
+	assoccol = -1;
+	if (maxbid < r.val[j]) {
+	  grp = r.col[j];
+	  for (int k = Sh.get_colptr(grp); k < Sh.get_colptr(grp+1); k++) {
 	    if (S.row(k) == -1) {
 	      assoccol = k;
-	      k = Sh.get_colptr(j.column()+1);
+	      k = Sh.get_colptr(grp+1);
 	    }
 	  }
 	  if (assoccol != -1) {
-	    maxbid = *j;
+	    maxbid = r.val[j];
 	    maxbidcol = assoccol;
 	  }
 	}
@@ -343,15 +2270,16 @@ void AuctAlg::greedy_fill (IMat& A, AuctShape& Sh, AuctAssoc& S,
       if (maxbidcol > -1) S.add (i, maxbidcol);
     }
   }
+  if (trace) trace->end(AuctTrace::GREEDY_FILL, S.nassoc(),
+			minassoc - S.nassoc());
 }
 
 // Auction Cycle SM, with a sparse payoff matrix, A, and
 //                   accomodating multiple rows and columns
 //
-// A is the payoff matrix, which is constructed using the Matrix
-// Template library.  The matrix is stored sparsely
-// (column-compressed) but may be accessed using row and column
-// iterators, which automatically skip over the empty entries.
+// A is the payoff matrix, a view of the workspace's compressed rows,
+// so that each row's entries (and only those) are walked as a pair of
+// plain arrays.
 //
 // Sh is the Auction "shape" structure.  This stores the size of A, as
 // well as the multiplicities of each row and column of A.  It has
@@ -365,101 +2293,111 @@ void AuctAlg::greedy_fill (IMat& A, AuctShape& Sh, AuctAssoc& S,
 //
 // Prms is the Auction parameters structure
 //
-void AuctAlg::auct_cycle_SM (IMat& A, AuctShape& Sh, AuctAssoc& S,
-				AuctParm& Prms) {
+void AuctAlg::auct_cycle_SM (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+			     AuctParm& Prms, AuctWorkspace& W) {
 
   int NEGLARGE = -Prms.get_MAXINT();
   int epsilon = Prms.get_epsilon();
 
-  IMat::iterator i;
-  IMat::OneD::iterator j;
+  AuctCSR<int>::Row r;
+  int j;
 
-  PreBidClassMult curshop, empty;
-  std::list<PreBidClassMult> shoplist;
-  std::list<PreBidClassMult>::iterator si;
-  int rowA, rowS, colS;
+  int rowA, rowS, colS, grp, v, k, si, nfree, nused, nshop;
   int refgroup, refval, tmpval, saveval, startCol, endCol, minprice;
 
-  empty.v = NEGLARGE;
-  empty.js = empty.grp = -1;
-
-  bool freerow_flag, groupmatch_flag;
-  std::list<int> usedcols, freerows;
-  std::list<int>::iterator ui;
-
+  // The shopping list is kept as three parallel arrays (value, Assoc
+  // Matrix col, and column group), sorted by decreasing value.  It and
+  // the lists of occupied columns and free rows are sized for the
+  // largest row multiplicity, and live in the workspace.
+  int maxmult = 1;
+  for (rowA = 0; rowA < Sh.nrows(); rowA++)
+    maxmult = std::max(maxmult, Sh.get_rowmult(rowA));
+  int *usedcols = W.reserve(AuctWorkspace::USEDCOLS, maxmult);
+  int *freerows = W.reserve(AuctWorkspace::FREEROWS, maxmult);
+  int *shopv    = W.reserve(AuctWorkspace::SHOPV,   maxmult+1);
+  int *shopjs   = W.reserve(AuctWorkspace::SHOPJS,  maxmult+1);
+  int *shopgrp  = W.reserve(AuctWorkspace::SHOPGRP, maxmult+1);
+
+  bool groupmatch_flag;
   bool DEBUG = Prms.DEBUG();
 
   // Compute bids, submitting as many bids as possible for each A row.
 
   // Loop over rows of A
-  for (i = A.begin(); i < A.end(); i++) {
-    rowA = ((*i).begin()).row();
+  for (rowA = 0; rowA < A.nrows(); rowA++) {
+    if (out_of_time()) break;
+    r = A.row(rowA);
 
     // Build list of occupied columns and free rows corrsp. to this A row.
-    freerow_flag = false;
-    usedcols.clear(); freerows.clear();
+    nfree = nused = 0;
     for (rowS = Sh.get_rowptr(rowA); rowS < Sh.get_rowptr(rowA+1); rowS++) {
       if (S.col(rowS) != -1) {
-	usedcols.push_back(S.col(rowS));
+	usedcols[nused++] = S.col(rowS);
       } else {
-	freerow_flag = true;
-	freerows.push_back(rowS);
+	freerows[nfree++] = rowS;
       }
     }
 
     if (DEBUG) cout << "On A row " << rowA << " currently has "
-		    << freerows.size() << " free rows" << endl;
+		    << nfree << " free rows" << endl;
 
     // If there are any free rows, then find bids for them.  This is
     // done by assembling a "shopping list" of the top value columns to
     // be bid upon.
-    if (freerow_flag) {
-      shoplist.clear();
-      shoplist.insert(shoplist.begin(), freerows.size()+1, empty);
+    if (nfree > 0) {
+      nshop = nfree+1;
+      for (si = 0; si < nshop; si++) {
+	shopv[si] = NEGLARGE;
+	shopjs[si] = shopgrp[si] = -1;
+      }
 
       // Loop over columns of A
-      for (j = (*i).begin(); j < (*i).end(); j++) {
-	curshop.grp = j.column();
+      for (j = 0; j < r.size; j++) {
+	grp = r.col[j];
+
+	// Pass over a wide group if, at its least price, none of its
+	// columns would make the (full) shopping list.
+	if (S.indexed() && shopjs[nshop-1] != -1
+	    && Sh.get_colmult(grp) >= INDEXWIDTH
+	    && r.val[j] - S.min_price_in_colrange(Sh.get_colptr(grp),
+						  Sh.get_colptr(grp+1))
+	       < shopv[nshop-1])
+	  continue;
 
 	// Loop over cooresponding columns of S.
-	for (colS = Sh.get_colptr(curshop.grp);
-	     colS < Sh.get_colptr(curshop.grp+1); colS++) {
-	  curshop.js = colS;
-	  curshop.v  = *j - S.Price(colS); // value = payoff - price
+	for (colS = Sh.get_colptr(grp); colS < Sh.get_colptr(grp+1); colS++) {
+	  v = r.val[j] - S.Price(colS); // value = payoff - price
 
 	  // Insert into the shopping list if appropriate.  To decide,
 	  // run down the list, considering several properties:
 	  //
-	  // P1: list entry value >= curshop.v
-	  // P2: curshop.js already taken (i.e. is in usedcols list)
-	  // P3: list entry group == curshop.grp
+	  // P1: list entry is filled, and its value >= v
+	  // P2: colS already taken (i.e. is in usedcols list)
 	  //
 	  // The decision tree is a follows:
 	  //   Case 1: P1                   step to next list value
 	  //   Case 2: !P1 & P2             end (forget this S column)
 	  //   Case 3: !P1 & !P2            insert into list
-	  si = shoplist.begin();
-	  while (si != shoplist.end()) {
-	    if (si->v > curshop.v) {             // Case 1: step
-	      si++;
-	    } else {
-	      ui = std::find(usedcols.begin(), usedcols.end(), curshop.js);
-	      if (ui != usedcols.end()) {
-		si = shoplist.end();             // Case 2: end
-	      } else {
-		shoplist.insert(si,curshop);     // Case 3: insert
-		shoplist.pop_back();
-		si = shoplist.end();
+	  for (si = 0; si < nshop && shopjs[si] != -1 && shopv[si] > v; si++)
+	    ;                                    // Case 1: step
+	  if (si < nshop) {
+	    for (k = 0; k < nused && usedcols[k] != colS; k++) ;
+	    if (k == nused) {                    // Case 3: insert
+	      for (k = nshop-1; k > si; k--) {
+		shopv[k]   = shopv[k-1];
+		shopjs[k]  = shopjs[k-1];
+		shopgrp[k] = shopgrp[k-1];
 	      }
-	    }
-	  } // end loop over shopping list
+	      shopv[si] = v;  shopjs[si] = colS;  shopgrp[si] = grp;
+	    }                                    // else Case 2: end
+	  }
 	} // end loop over S cols corresponding to this A col
       } // end loop over columns of A
 
       // Construct reference from last member of the shopping list
-      refgroup = shoplist.front().grp;
-      refval   = shoplist.back().v;
-      shoplist.pop_back();
+      refgroup = shopgrp[0];
+      refval   = shopv[nshop-1];
+      nshop--;
 
       // Make sure that we are working with a non-empty row
       if (refgroup != -1) {
@@ -468,18 +2406,17 @@ void AuctAlg::auct_cycle_SM (IMat& A, AuctShape& Sh, AuctAssoc& S,
 	// reference, are from the same group, explicitly look for a
 	// reference value from a distinct group.
 	groupmatch_flag = true;
-	si = shoplist.begin();
-	while (++si != shoplist.end() && groupmatch_flag)
-	  groupmatch_flag = si->grp == refgroup;
+	for (si = 1; si < nshop && groupmatch_flag; si++)
+	  groupmatch_flag = shopgrp[si] == refgroup;
 
 	if (groupmatch_flag) {                    // Reference is unsuitable
 	  saveval = NEGLARGE;
-	  for (j = (*i).begin(); j < (*i).end(); j++) {
-	    if (j.column() != refgroup) {
-	      startCol = Sh.get_colptr(j.column());
-	      endCol   = Sh.get_colptr(j.column()+1);
+	  for (j = 0; j < r.size; j++) {
+	    if (r.col[j] != refgroup) {
+	      startCol = Sh.get_colptr(r.col[j]);
+	      endCol   = Sh.get_colptr(r.col[j]+1);
 	      minprice = S.min_price_in_colrange(startCol, endCol);
-	      tmpval   = *j - minprice;
+	      tmpval   = r.val[j] - minprice;
 	      if (tmpval <= refval && tmpval > saveval) saveval = tmpval;
 	    }
 	  }
@@ -487,13 +2424,14 @@ void AuctAlg::auct_cycle_SM (IMat& A, AuctShape& Sh, AuctAssoc& S,
 	} // end if block (for recomputing reference value)
 
 	// Make the bids for each row in freerows.
-	for (si = shoplist.begin(), ui = freerows.begin();
-	     si != shoplist.end(); si++, ui++) {
-	  S.add (*ui, si->js);
-	  S.set_Price(si->js, S.Price(si->js) + si->v - refval + epsilon);
+	for (si = 0; si < nshop; si++) {
+	  S.add (freerows[si], shopjs[si]);
+	  S.set_Price(shopjs[si], S.Price(shopjs[si])
+		      + std::max(shopv[si] - refval, 0) + epsilon);
 	  if (DEBUG) {
-	    cout << "Submitted a bid for ("<<*ui<<","<<si->js<<") for "
-		 << "value " << si->v << " reference " << refval << endl;
+	    cout << "Submitted a bid for ("<<freerows[si]<<","<<shopjs[si]
+		 <<") for value " << shopv[si] << " reference " << refval
+		 << endl;
 	  }
 	} // end for loop over bids
       } // end if non-empty row
@@ -501,64 +2439,241 @@ void AuctAlg::auct_cycle_SM (IMat& A, AuctShape& Sh, AuctAssoc& S,
   } // end loop over rows
 }
 
+// Checked once, on the first sign of a price war; rows which are all
+// distinct leave the auction as it was.
+void AuctAlg::collapse_rows (AuctCSR<int>& A, AuctAssoc& S, AuctCollapse& G,
+			     AuctParm& Prms, AuctMetric& metric,
+			     AuctWorkspace& W) {
+  if (!G.build(A, W)) return;
+  G.apply(S, W);
+  metric.set_nrowgroups(G.ngroups());
+  if (Prms.MESSG()) cerr << "Price war: " << A.nrows()
+			 << " rows collapsed to " << G.ngroups() << endl;
+}
+
+// The column reduction of the JV engine, in the auction's units.
+void AuctAlg::seed_prices (AuctCSR<int>& A, AuctAssoc& S, AuctWorkspace& W) {
+  int M = A.ncols(), NNZ = A.nnz(), k;
+  int lo = std::numeric_limits<int>::max();
+  int *price = W.reserve(AuctWorkspace::SCRATCH, M);
+  int *ind = A.colind(), *val = A.values();
+
+  std::fill (price, price+M, NOENTRY);
+  for (k = 0; k < NNZ; k++) price[ind[k]] = std:: max(price[ind[k]], val[k]);
+  for (k = 0; k < M; k++) if (price[k] != NOENTRY) lo = std:: min(lo, price[k]);
+  for (k = 0; k < M; k++) price[k] = (price[k] == NOENTRY) ? 0 : price[k] - lo;
+  S.set_prices(price);
+}
+
+// A row takes its best column only if no row before it has, so the
+// pass bids nothing up: it saves the first cycle of bids where the
+// rows' best columns do not collide.
+int AuctAlg::greedy_start (AuctCSR<int>& A, AuctAssoc& S) {
+  AuctCSR<int>::Row r;
+  int i, j, best, bestv, v, added = 0;
+
+  for (i = 0; i < A.nrows(); i++) {
+    if (S.col(i) != -1) continue;
+    r = A.row(i);
+    best = -1;
+    bestv = 0;
+    for (j = 0; j < r.size; j++) {
+      v = r.val[j] - S.Price(r.col[j]);
+      if (best == -1 || v > bestv) {
+	best = r.col[j];
+	bestv = v;
+      }
+    }
+    if (best != -1 && S.row(best) == -1) {
+      S.add(i, best);
+      added++;
+    }
+  }
+  return added;
+}
+
 // Auction Cycle, with only single rows/columns, without profits calculations.
 // Gauss-Seidel version (i.e. bids executed as made).
-void AuctAlg::auct_cycle_SP1 (IMat& A, AuctShape& Sh, AuctAssoc& S,
-			   AuctParm& Prms) {
+void AuctAlg::auct_cycle_SP1 (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+			      AuctParm& Prms) {
 
 
   int NEGLARGE = -Prms.get_MAXINT(), epsilon = Prms.get_epsilon();
   bool DEBUG   = Prms.DEBUG();
 
-  IMat::iterator i;
-  IMat::OneD::iterator j;
+  AuctCSR<int>::Row r;
+  int j;
 
-  PreBidClass curshop, empty;
-  std::list<PreBidClass> shoplist;
-  std::list<PreBidClass>::iterator si, snxt;
+  PreBidClass curshop, best, next;
 
   int rowA=0;
-  empty.v = NEGLARGE; empty.js = -1;
 
-  // Loop over nonempty rows of A
-  for (i = A.begin(); i < A.end(); i++) {
-    rowA = ((*i).begin()).row();
+  // Loop over rows of A
+  for (rowA = 0; rowA < A.nrows(); rowA++) {
+    if (out_of_time()) break;
     if (DEBUG) cout << "On row " << rowA << " currently associated to "
 		    << S.col(rowA) << endl;
     if (S.col(rowA) == -1) {
-      shoplist.clear();
-      shoplist.push_front(empty);
-      shoplist.push_front(empty);
-
-      // Loop over nonempty columns of A, insertion sort for top two vals.
-      for (j = (*i).begin(); j < (*i).end(); j++) {
-	curshop.js = j.column();
-	curshop.v  = *j - S.Price(curshop.js);
-	si = shoplist.begin();
-	while (si != shoplist.end()) {
-	  if  (curshop.v > si->v) {
-	    shoplist.insert(si, curshop);
-	    shoplist.pop_back();
-	    si = shoplist.end();
-	  } else si++;
+      best.v = next.v = NEGLARGE;
+      best.js = next.js = -1;
+      r = A.row(rowA);
+
+      // Loop over nonempty columns of A, keeping the top two vals.
+      for (j = 0; j < r.size; j++) {
+	curshop.js = r.col[j];
+	curshop.v  = r.val[j] - S.Price(curshop.js);
+	if (best.js == -1 || curshop.v > best.v) {
+	  next = best;
+	  best = curshop;
+	} else if (next.js == -1 || curshop.v > next.v) {
+	  next = curshop;
 	}
       } // end loop over columns of A
 
       // Only assign the row if it is non-empty
-      si = shoplist.begin();
-      if (si->js != -1) {
-	snxt = si; ++snxt;
-	S.add (rowA, si->js);
-	S.set_Price(si->js, S.Price(si->js) + si->v - snxt->v + epsilon);
-	if (DEBUG) cout << "Added (" << rowA << "," << si->js
+      if (best.js != -1) {
+	S.add (rowA, best.js);
+	S.set_Price(best.js, S.Price(best.js) + std::max(best.v - next.v, 0)
+		    + epsilon);
+	if (DEBUG) cout << "Added (" << rowA << "," << best.js
 			<< ") for price " << S.Price(rowA) << endl;
       } // end if non-empty row
     } // end if block (for unassociated entries)
   } // end loop over rows of A
 }
 
-void AuctAlg::auct_cycle_SP2 (IMat& A, AuctShape& Sh, AuctAssoc& S,
-			   AuctParm& Prms) {
+// SP1 on the compacted payoff: each entry's column and value are
+// decoded as the row is walked, from 4 bytes rather than 8.
+void AuctAlg::auct_cycle_SPC (AuctCompact& C, AuctAssoc& S, AuctParm& Prms) {
+
+  int NEGLARGE = -Prms.get_MAXINT(), epsilon = Prms.get_epsilon();
+  unsigned short *dcol = C.deltas(), *qval = C.quanta();
+  int rowA, k, end, top, step, col;
+
+  PreBidClass curshop, best, next;
+
+  // Loop over rows of A
+  for (rowA = 0; rowA < C.nrows(); rowA++) {
+    if (out_of_time()) break;
+    if (S.col(rowA) == -1) {
+      best.v = next.v = NEGLARGE;
+      best.js = next.js = -1;
+      C.row(rowA, k, end, top, step);
+
+      // Loop over the entries, skips only stepping the column on.
+      for (col = 0; k < end; k++) {
+	col += dcol[k];
+	if (qval[k] == AuctCompact::SKIP) continue;
+	curshop.js = col;
+	curshop.v  = top - qval[k] * step - S.Price(col);
+	if (best.js == -1 || curshop.v > best.v) {
+	  next = best;
+	  best = curshop;
+	} else if (next.js == -1 || curshop.v > next.v) {
+	  next = curshop;
+	}
+      } // end loop over entries
+
+      // Only assign the row if it is non-empty
+      if (best.js != -1) {
+	S.add (rowA, best.js);
+	S.set_Price(best.js, S.Price(best.js) + std::max(best.v - next.v, 0)
+		    + epsilon);
+      } // end if non-empty row
+    } // end if block (for unassociated entries)
+  } // end loop over rows of A
+}
+
+// SP1 with look-back: a wide row bids from the candidates it kept when
+// it last scanned, as long as the best of them is still worth at least
+// its threshold, which then stands in for any second best below it.
+// The bid may be the lower for it, but e-CS holds.  Otherwise the row
+// is scanned for its k+1 best entries (in order, by insertion), the
+// first k of which are its new candidates and the last its threshold.
+void AuctAlg::auct_cycle_SPL (AuctCSR<int>& A, AuctAssoc& S, AuctParm& Prms,
+			      AuctLookback& L) {
+
+  int NEGLARGE = -Prms.get_MAXINT(), epsilon = Prms.get_epsilon();
+  int topv[AuctLookback::MAXCAND+1], tope[AuctLookback::MAXCAND+1];
+  int k = L.ncand(), rowA, j, n, t, v, *c;
+  bool scan;
+
+  AuctCSR<int>::Row r;
+
+  PreBidClass curshop, best, next;
+
+  // Loop over rows of A
+  for (rowA = 0; rowA < A.nrows(); rowA++) {
+    if (out_of_time()) break;
+    if (S.col(rowA) == -1) {
+      best.v = next.v = NEGLARGE;
+      best.js = next.js = -1;
+      r = A.row(rowA);
+      scan = true;
+
+      if (!L.wide(r.size)) {
+	// Loop over nonempty columns of A, keeping the top two vals.
+	for (j = 0; j < r.size; j++) {
+	  curshop.js = r.col[j];
+	  curshop.v  = r.val[j] - S.Price(curshop.js);
+	  if (best.js == -1 || curshop.v > best.v) {
+	    next = best;
+	    best = curshop;
+	  } else if (next.js == -1 || curshop.v > next.v) {
+	    next = curshop;
+	  }
+	}
+	scan = false;
+      } else if (L.cached(rowA)) {
+	// The top two of the candidates, if they still beat the rest.
+	c = L.cand(rowA);
+	for (j = 0; j < k; j++) {
+	  curshop.js = r.col[c[j]];
+	  curshop.v  = r.val[c[j]] - S.Price(curshop.js);
+	  if (best.js == -1 || curshop.v > best.v) {
+	    next = best;
+	    best = curshop;
+	  } else if (next.js == -1 || curshop.v > next.v) {
+	    next = curshop;
+	  }
+	}
+	if (best.v >= L.threshold(rowA)) {
+	  next.v = std:: max(next.v, L.threshold(rowA));
+	  scan = false;
+	  L.hit();
+	}
+      }
+
+      if (scan) {
+	// The k+1 best entries, in order of decreasing value.
+	for (n = 0, j = 0; j < r.size; j++) {
+	  v = r.val[j] - S.Price(r.col[j]);
+	  if (n > k && v <= topv[k]) continue;
+	  for (t = (n > k) ? k : n++; t > 0 && topv[t-1] < v; t--) {
+	    topv[t] = topv[t-1];
+	    tope[t] = tope[t-1];
+	  }
+	  topv[t] = v;
+	  tope[t] = j;
+	}
+	L.cache(rowA, tope, topv[k]);
+	best.js = r.col[tope[0]];
+	best.v = topv[0];
+	next.v = topv[1];
+      }
+
+      // Only assign the row if it is non-empty
+      if (best.js != -1) {
+	S.add (rowA, best.js);
+	S.set_Price(best.js, S.Price(best.js) + std::max(best.v - next.v, 0)
+		    + epsilon);
+      } // end if non-empty row
+    } // end if block (for unassociated entries)
+  } // end loop over rows of A
+}
+
+void AuctAlg::auct_cycle_SP2 (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+			      AuctParm& Prms) {
 
   // This version: NO has multiple rows/columns, YES has profits. (plain 2).
   //               NO modified  YES sparse payoff
@@ -566,47 +2681,151 @@ void AuctAlg::auct_cycle_SP2 (IMat& A, AuctShape& Sh, AuctAssoc& S,
 
   int NEGLARGE = -Prms.get_MAXINT();
   int epsilon = Prms.get_epsilon();
-  int rowA=0;
-
-  IMat::iterator i;
-  IMat::OneD::iterator j;
+  int rowA=0, j;
 
-  PreBidClass curshop, empty;
-  std::list<PreBidClass> shoplist;
-  std::list<PreBidClass>::iterator si, snxt;
+  AuctCSR<int>::Row r;
 
-  empty.v = NEGLARGE; empty.js = -1;
+  PreBidClass curshop, best, next;
 
-  // Loop over nonempty rows of A
-  for (i = A.begin(); i < A.end(); i++) {
-    rowA = ((*i).begin()).row();
+  // Loop over rows of A
+  for (rowA = 0; rowA < A.nrows(); rowA++) {
+    if (out_of_time()) break;
     if (S.col(rowA) == -1) {
-      shoplist.clear();
-      shoplist.push_front(empty);
-      shoplist.push_front(empty);
-
-      // Loop over nonempty columns of A, insertion sort for top two values
-      for (j = (*i).begin(); j < (*i).end(); j++) {
-	curshop.js = j.column();
-	curshop.v  = *j - S.Price(curshop.js);
-	si = shoplist.begin();
-	while (si != shoplist.end()) {
-	  if  (curshop.v > si->v) {
-	    shoplist.insert(si, curshop);
-	    shoplist.pop_back();
-	    si = shoplist.end();
-	  } else si++;
+      best.v = next.v = NEGLARGE;
+      best.js = next.js = -1;
+      r = A.row(rowA);
+
+      // Loop over nonempty columns of A, keeping the top two values
+      for (j = 0; j < r.size; j++) {
+	curshop.js = r.col[j];
+	curshop.v  = r.val[j] - S.Price(curshop.js);
+	if (best.js == -1 || curshop.v > best.v) {
+	  next = best;
+	  best = curshop;
+	} else if (next.js == -1 || curshop.v > next.v) {
+	  next = curshop;
 	}
       } // end loop over columns of A
 
       // Only assign the row if it is non-empty
-      si = shoplist.begin();
-      if (si->js != -1) {
-	snxt = si; ++snxt;
-	S.add (rowA, si->js);
-	S.set_Price (si->js, S.Price(si->js) + si->v - snxt->v + epsilon);
-	S.set_Prof(rowA, snxt->v - epsilon);
+      if (best.js != -1) {
+	S.add (rowA, best.js);
+	S.set_Price (best.js, S.Price(best.js) + std::max(best.v - next.v, 0)
+		     + epsilon);
+	S.set_Prof(rowA, next.v - epsilon);
       } // end if non-empty row
     } // end if block (for unassociated entries)
   } // end loop over rows of A
 }
+
+// The raw cycle is SP1 on a zero based compressed row payoff, with the
+// associations and prices held in plain arrays.  It is templated on
+// the value type, so that the same bidding serves any payoff type.
+template <class V>
+void AuctAlg::auct_cycle_raw (int N, int* ptr, int* ind, V* val, V* price,
+			      int* bidobj, int* objbid, int& nassoc,
+			      V epsilon, V neglarge) {
+  int row, k, j, bestj, nextj;
+  V v, bestv, nextv;
+
+  for (row = 0; row < N; row++) {
+    if (out_of_time()) break;
+    if (bidobj[row] != -1) continue;
+
+    // Keep the top two values of the row.
+    bestj = nextj = -1;
+    bestv = nextv = neglarge;
+    for (k = ptr[row]; k < ptr[row+1]; k++) {
+      j = ind[k];
+      v = val[k] - price[j];
+      if (bestj == -1 || v > bestv) {
+	nextj = bestj;  nextv = bestv;
+	bestj = j;      bestv = v;
+      } else if (nextj == -1 || v > nextv) {
+	nextj = j;      nextv = v;
+      }
+    }
+    if (bestj == -1) continue;   // empty row
+
+    if (objbid[bestj] != -1) bidobj[objbid[bestj]] = -1;
+    else nassoc++;
+    objbid[bestj] = row;
+    bidobj[row] = bestj;
+    price[bestj] += std::max(bestv - nextv, (V)0) + epsilon;
+  }
+}
+
+// As AuctAssoc::hidden_bid, for the raw auction.  The objects are
+// sorted by price as indices, in the workspace.
+template <class V>
+void AuctAlg::hidden_bid_raw (int nbid, int nobj, V* price, int* bidobj,
+			      int* objbid, int& nassoc, V epsilon,
+			      AuctWorkspace& W) {
+  int *assoc = W.reserve(AuctWorkspace::HBASSOC, nobj);
+  int *unass = W.reserve(AuctWorkspace::HBUNASSOC, nobj);
+  int nas = 0, nun = 0;
+  V minassoc = 0, maxunass = 0;
+  int i, j;
+
+  for (j = 0; j < nobj; j++) {
+    if (objbid[j] >= 0) {
+      if (nas == 0 || price[j] < minassoc) minassoc = price[j];
+      assoc[nas++] = j;
+    } else {
+      if (nun == 0 || price[j] > maxunass) maxunass = price[j];
+      unass[nun++] = j;
+    }
+  }
+  if (nas == 0 || nun == 0) return;
+
+  int nbids = std:: min (nobj - nbid, nas);
+  nbids = std:: min (nbids, nun);
+
+  if (nbids > 0 && minassoc < maxunass) {
+    // The associated are in ascending and unassociated in descending order.
+    std::partial_sort(assoc, assoc + nbids, assoc + nas,
+		      [price] (int a, int b) { return price[a] < price[b]; });
+    std::partial_sort(unass, unass + nbids, unass + nun,
+		      [price] (int a, int b) { return price[a] > price[b]; });
+
+    for (i = 0; i < nbids && price[assoc[i]] < price[unass[i]]; i++) {
+      j = assoc[i];
+      bidobj[objbid[j]] = -1;
+      objbid[j] = -1;
+      nassoc--;
+      minassoc = price[j];
+    }
+    for (j = i; j < nun; j++)
+      price[unass[j]] = minassoc;
+  } else {
+    for (j = 0; j < nun; j++)
+      price[unass[j]] = minassoc - epsilon;
+  }
+}
+
+// As greedy_fill, for the raw auction.
+template <class V>
+void AuctAlg::greedy_raw (int N, int* ptr, int* ind, V* val,
+			  int* bidobj, int* objbid) {
+  int row, k, bestj, nfree = 0;
+  V bestv = 0;
+
+  if (trace) trace->begin(AuctTrace::GREEDY_FILL);
+  for (row = 0; row < N; row++) {
+    if (bidobj[row] != -1) continue;
+    bestj = -1;
+    for (k = ptr[row]; k < ptr[row+1]; k++) {
+      if (objbid[ind[k]] == -1 && (bestj == -1 || val[k] > bestv)) {
+	bestj = ind[k];
+	bestv = val[k];
+      }
+    }
+    if (bestj != -1) {
+      bidobj[row] = bestj;
+      objbid[bestj] = row;
+    } else {
+      nfree++;
+    }
+  }
+  if (trace) trace->end(AuctTrace::GREEDY_FILL, N - nfree, nfree);
+}
@@ -3,15 +3,25 @@
 #define auction_H
 
 #include <list>
+#include <iostream>
 #include <algorithm>
+#include <chrono>
 #include "AuctParm.h"
 #include "AuctShape.h"
 #include "AuctPay.h"
 #include "AuctAssoc.h"
 #include "AuctMetric.h"
-
-#include "mtl/mtl.h"
-#include "mtl/matrix.h"
+#include "AuctWorkspace.h"
+#include "AuctShard.h"
+#include "AuctTransport.h"
+#include "AuctTrace.h"
+#include "AuctPerf.h"
+#include "AuctTelemetry.h"
+#include "AuctCSR.h"
+#include "AuctCompact.h"
+#include "AuctReorder.h"
+#include "AuctLookback.h"
+#include "AuctCollapse.h"
 
 class AuctAlg {
 
@@ -23,30 +33,6 @@ class AuctAlg {
 
  private:
 
-  /**
-   * MTL Type definition for Input Payoff Matrix Data type
-   */
-  typedef mtl::matrix<int, mtl::rectangle<>, mtl::compressed<int, 
-    mtl::external, mtl::index_from_one>, mtl::row_major>::type InMat;
-
-  /**
-   * MTL Type definition for Oriented Payoff Data type
-   */
-  typedef mtl::matrix<int, mtl::rectangle<>, mtl::compressed<>, 
-    mtl::row_major>::type IMat;
-
-  /**
-   * Structure for Considered bids in the multiple associations case <p>    
-   * int v;               // value under consideration. <br>
-   * int js;              // Assoc Matrix col.  <br>
-   * int grp;             // column group ID.  <br>
-   */
-  typedef struct PreBidClassMult {
-    int v;               // value under consideration
-    int js;              // Assoc Matrix col
-    int grp;             // column group ID
-  } PreBidClassMult;    
-
   /**
    * Structure for Considered bids <p>
    * int v;               // value under consideration. <br>
@@ -58,6 +44,35 @@ class AuctAlg {
   } PreBidClass;    
 
 
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.
+   */
+  AuctAlg () {
+    clockperiod = clockcount = 0;
+    expired = timed = false;
+    cancelflag = 0;
+    trace = 0;
+    shards = 0;
+    packed = 0;
+    shardcap = pricecap = 0;
+  }
+
+  /**
+   * Destructor
+   */
+  ~AuctAlg () {
+    delete [] shards;
+    delete [] packed;
+  }
+
   // ------------------------------------------------------------------
   //
   //	Action Methods
@@ -76,10 +91,21 @@ class AuctAlg {
    * the input AuctAssoc structure satisfies e-CS.  An empty
    * association structure trivially satisfies this. <p>
    *
-   * Currently, the top-level auction simply calls a Forward Auction
-   * routine.  Future versions might require a more sophisticated 
-   * top-level auction with the ability to switch among high level 
-   * auction strategies. <p>
+   * The top-level auction calls a Forward Auction routine, optionally
+   * on a pruned payoff (see AuctParm::set_prunek), in floating point
+   * (AuctParm::set_floating), sharded over several threads
+   * (AuctParm::set_nthreads), or distributed over several processes
+   * (AuctParm::set_transport).  Otherwise, it may instead run the
+   * dense Jonker-Volgenant engine, if a cost model estimates it to be
+   * faster for the size, density and value range of the payoff (see
+   * AuctParm::set_engine).  The engine, and why it was chosen, are
+   * recorded in the AuctMetric. <p>
+   *
+   * The auction runs until it is optimal, or until it runs out of
+   * cycles or time (AuctParm::set_timelimit).  In the latter case it
+   * returns the assignment of its last complete epsilon-scaling phase,
+   * greedily filled if need be, and AuctMetric::gap bounds its payoff
+   * loss. <p>
    *
    * @param Pay Payoff Matrix
    * @param Sh Problem "Shape" which includes association multiplicities
@@ -89,9 +115,58 @@ class AuctAlg {
    */
   AuctMetric auction (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
 		      AuctParm& Prms) {
-    return auctionF (Pay, Sh, S, Prms);
+    return auction (Pay, Sh, S, Prms, work);
+  }
+
+  /**
+   * As above, but with the internal storage taken from a caller owned
+   * workspace.  Repeated solves of same-shaped problems through the
+   * same workspace do not allocate any solver storage. <p>
+   *
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (modified to contain auction results)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result from auctionF pass-through.
+   */
+  AuctMetric auction (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+		      AuctParm& Prms, AuctWorkspace& W) {
+    AuctMetric metric;
+    int why;
+    double auct, jv, jvsp;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    start_clock (Prms);
+    int engine = AuctAlg::choose_engine (Pay, Sh, S, Prms, why, auct, jv, jvsp);
+    if (engine == AuctParm::ENGINE_JV)
+      metric = auctionJV (Pay, Sh, S, Prms, W);
+    else if (engine == AuctParm::ENGINE_JVSP)
+      metric = auctionJVsp (Pay, Sh, S, Prms, W);
+    else if (Prms.floating())
+      metric = auctionFP (Pay, Sh, S, Prms, W);
+    else if (Prms.get_transport() && Prms.get_transport()->size() > 1)
+      metric = auctionD (Pay, Sh, S, Prms, W);
+    else if (Prms.get_prunek() > 0)
+      metric = auctionP (Pay, Sh, S, Prms, W);
+    else if (Prms.get_nthreads() > 1)
+      metric = auctionMT (Pay, Sh, S, Prms, W);
+    else
+      metric = auctionF (Pay, Sh, S, Prms, W);
+    metric.set_cancelled(metric.expired() && cancelled());
+    metric.set_engine(engine, why, auct, jv, jvsp);
+    if (Prms.get_telemetry())
+      Prms.get_telemetry()->record(metric, std::chrono::duration<double>
+				   (std::chrono::steady_clock::now() - t0)
+				   .count(), Sh.nnz());
+    return metric;
   }
 
+  /**
+   * Accessor to the workspace used by the four argument auction().
+   * @return The workspace owned by this AuctAlg.
+   */
+  AuctWorkspace& workspace() { return work; }
+
   /**
    * The total payoff for a specified assignment, using internal payoff.
    * Note that the payoff in Pay is scaled, cast to ints, etc.
@@ -139,16 +214,489 @@ class AuctAlg {
    * @param Sh Problem "Shape" which includes association multiplicities
    * @param S Association Matrix (where auction results are placed)
    * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
    * @return AuctMetric result.
    */
   AuctMetric auctionF (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
-		      AuctParm& Prms);
+		      AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Forward auction on a pruned payoff.  Only the best few entries of
+   * each bidder (AuctParm::get_prunek), together with a maximum
+   * matching, are given to auctionF.  The result is then checked for
+   * e-CS against the entries which were left out, and any which violate
+   * it are re-admitted and the auction is re-run, warm-started from the
+   * previous prices.  The final result is
+   * therefore as optimal as an auction on the full payoff.  If it stops
+   * early, the assignment is greedily filled from the full payoff, and
+   * the gap is unknown (-1). <p>
+   * Pruning is skipped for problems with multiple associations.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (where auction results are placed)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result.
+   */
+  AuctMetric auctionP (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+		       AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Floating point auction.  The bidding is done on the payoff values
+   * as given (AuctParm::set_floating), without the scaling and rounding
+   * to ints of auctionF, and epsilon is scaled down until the result is
+   * within the tolerance of the optimum.  Problems with multiple
+   * associations, or payoffs built without floating point values, are
+   * passed on to auctionF.
+   * @param Pay Payoff Matrix, with floating point values
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (where auction results are placed)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result.
+   */
+  AuctMetric auctionFP (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+			AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Distributed auction.  Each of the processes joined by the
+   * AuctParm::get_transport bids for its own share of the bidders, and
+   * they exchange the prices they raise after every cycle.  All the
+   * processes must call it together, with the same shape, parameters
+   * and starting prices; each needs only its own bidders' entries of
+   * the payoff.  Every process gets the whole result, which is as
+   * optimal as that of auctionF.  Problems with multiple associations
+   * are passed on to auctionF (in every process).
+   * @param Pay Payoff Matrix (at least this process's bidders)
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (where auction results are placed)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result.
+   */
+  AuctMetric auctionD (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+		       AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Sharded (multi-threaded) auction.  The bidders are split into
+   * AuctParm::get_nthreads shards, which bid at the same time against
+   * shared prices.  The result is as optimal as that of auctionF.
+   * Problems with multiple associations are passed on to auctionF.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (where auction results are placed)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result.
+   */
+  AuctMetric auctionMT (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+			AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Jonker-Volgenant engine.  Each bidder in turn is associated along
+   * a shortest augmenting path, found by Dijkstra's method on a dense
+   * copy of the payoff, with reduced payoffs as lengths.  A square
+   * problem starts from a column reduction (each object priced at its
+   * largest payoff, and given to that bidder if it is still free).
+   * Multiplicities are honored by giving every copy of a row or column
+   * its own bidder or object.  The prices and profits left in S are
+   * those of an optimal (0-CS) assignment, in the same units as the
+   * auction's, so they may warm start it.  Unlike the auction, it is
+   * not bounded by maxcycles (there is one augmentation per bidder),
+   * but the time limit and cancellation apply.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (where results are placed)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result.
+   */
+  AuctMetric auctionJV (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+			AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Sparse shortest augmenting paths, for very sparse payoffs.  As
+   * auctionJV, but the search works on the payoff's own entries (those
+   * of its transpose, in the workspace, if it has more rows than
+   * columns) through a heap of the objects reached, so that each
+   * augmentation costs in proportion to the entries it looks at, not
+   * to the dense payoff.  The prices and profits are scaled to the
+   * auction's, so they may warm start it.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (where results are placed)
+   * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
+   * @return AuctMetric result.
+   */
+  AuctMetric auctionJVsp (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, 
+			  AuctParm& Prms, AuctWorkspace& W);
+
+  /**
+   * Choose the engine of AuctAlg::auction (see AuctParm::set_engine).
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix, whose prices and profits may warm-start
+   *          the auction
+   * @param Prms Algorithm and Run-time parameters
+   * @param why Reason for the choice, an AuctMetric::EngineReason (set)
+   * @param auct Cost model's estimate for the auction (set)
+   * @param jv Cost model's estimate for the JV engine (set)
+   * @param jvsp Cost model's estimate for the sparse JV engine (set)
+   * @return Engine to run (not ENGINE_AUTO)
+   */
+  int choose_engine (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+		     AuctParm& Prms, int& why, double& auct, double& jv, double& jvsp);
+
+  /**
+   * Shortest augmenting paths on a dense payoff, the work of auctionJV.
+   * Bidders which are already associated (by the column reduction) are
+   * left so, and the others are associated in turn.  A bidder with no
+   * path to a free object is left unassociated.
+   * @param nbid Number of bidders
+   * @param nobj Number of objects
+   * @param rowof Payoff row of each bidder
+   * @param val Dense payoff, nobj values per payoff row (NOENTRY if absent)
+   * @param bidobj Object of each bidder, -1 if none (updated)
+   * @param objbid Bidder of each object, -1 if none (updated)
+   * @param profit Bidder profits (updated)
+   * @param price Object prices (updated)
+   * @param W Workspace providing the search storage
+   * @param scans Number of bidders scanned (updated)
+   * @return Number of bidders associated
+   */
+  int jv_dense (int nbid, int nobj, int* rowof, int* val, int* bidobj,
+		int* objbid, double* profit, double* price, AuctWorkspace& W,
+		long& scans);
+
+  /**
+   * Shortest augmenting paths on a sparse payoff, the work of
+   * auctionJVsp.  Each free bidder is associated in turn, or left
+   * unassociated if it has no path to a free object.
+   * @param nbid Number of bidders
+   * @param nobj Number of objects
+   * @param rowof Payoff row of each bidder
+   * @param ptr Row pointers of the payoff (base offset)
+   * @param ind Column of each payoff entry (base offset)
+   * @param val Value of each payoff entry
+   * @param base Index base of ptr and ind
+   * @param Sh Problem "Shape", for the copies of each column
+   * @param bidobj Object of each bidder, -1 if none (updated)
+   * @param objbid Bidder of each object, -1 if none (updated)
+   * @param profit Bidder profits (updated)
+   * @param price Object prices (updated)
+   * @param W Workspace providing the search storage
+   * @param scans Number of bidders scanned (updated)
+   * @return Number of bidders associated
+   */
+  int jv_sparse (int nbid, int nobj, int* rowof, int* ptr, int* ind,
+		 int* val, int base, AuctShape& Sh, int* bidobj, int* objbid,
+		 double* profit, double* price, AuctWorkspace& W,
+		 long& scans);
+
+  /**
+   * Put the (bidder, object) pairs of a floating point auction into S.
+   * @param nbid Number of bidders
+   * @param bidobj Object of each bidder (-1 if none)
+   * @param reoriented True if the bidders are the columns of S
+   * @param S Association Matrix (blanked and refilled)
+   */
+  void raw_to_assoc (int nbid, int* bidobj, bool reoriented, AuctAssoc& S);
+
+  /**
+   * One Gauss-Seidel bidding cycle over the unassigned bidders, on a
+   * zero based compressed row payoff.
+   * @param N Number of bidders (rows of the payoff)
+   * @param ptr Row pointers (N+1 long)
+   * @param ind Object of each entry
+   * @param val Value of each entry
+   * @param price Object prices (updated)
+   * @param bidobj Object of each bidder, -1 if none (updated)
+   * @param objbid Bidder of each object, -1 if none (updated)
+   * @param nassoc Number of associations (updated)
+   * @param epsilon Bid increment
+   * @param neglarge Value of a missing second choice
+   */
+  template <class V>
+  void auct_cycle_raw (int N, int* ptr, int* ind, V* val, V* price,
+		       int* bidobj, int* objbid, int& nassoc,
+		       V epsilon, V neglarge);
 
   /**
-   * Transpose an InMat Matrix (external storage) into an IMat Matrix
-   * (internal storage)
+   * The hidden bid of AuctAssoc::hidden_bid, on raw arrays.
+   * @param nbid Number of bidders
+   * @param nobj Number of objects
+   * @param price Object prices (updated)
+   * @param bidobj Object of each bidder (updated)
+   * @param objbid Bidder of each object (updated)
+   * @param nassoc Number of associations (updated)
+   * @param epsilon Bid increment
+   * @param W Workspace providing the sort buffers
    */
-  void ctransp(InMat&, IMat&);
+  template <class V>
+  void hidden_bid_raw (int nbid, int nobj, V* price, int* bidobj,
+		       int* objbid, int& nassoc, V epsilon, AuctWorkspace& W);
+
+  /**
+   * Greedily associate the unassigned bidders of a raw auction, in order.
+   * @param N Number of bidders
+   * @param ptr Row pointers (N+1 long)
+   * @param ind Object of each entry
+   * @param val Value of each entry
+   * @param bidobj Object of each bidder (updated)
+   * @param objbid Bidder of each object (updated)
+   */
+  template <class V>
+  void greedy_raw (int N, int* ptr, int* ind, V* val, int* bidobj, int* objbid);
+
+  /**
+   * Mark the entries of a maximum cardinality matching as kept, so
+   * that a pruned payoff has the same maximum matching as the full one.
+   * @param bidptr Start of each bidder's entries in bident (nbid+1 long)
+   * @param bident Payoff entries (as indexed in AuctPay), grouped by bidder
+   * @param object Object (column, or row if reoriented) of each entry
+   * @param nbid Number of bidders
+   * @param nobj Number of objects
+   * @param keep Entries kept, indexed as in AuctPay (updated)
+   * @param W Workspace providing the search storage
+   */
+  void keep_matching (int* bidptr, int* bident, int* object, int nbid,
+		      int nobj, int* keep, AuctWorkspace& W);
+
+  /**
+   * Re-admit pruned entries which violate e-CS for the associations
+   * and prices in S.  Rows (or, if the auction was reoriented, columns)
+   * which were left unassociated get all their pruned entries back.
+   * If any are re-admitted, the object prices are capped at the largest
+   * payoff, ready for a warm-started re-run.
+   * @param Pay Payoff Matrix (unpruned)
+   * @param S Association Matrix, as returned by auctionF
+   * @param Prms Algorithm and Run-time parameters
+   * @param keep Flag for each entry of Pay, 1 if not pruned (updated)
+   * @param reoriented True if auctionF reoriented the problem
+   * @param W Workspace providing the profits of the bidders
+   * @return Number of entries re-admitted
+   */
+  int readmit (AuctPay& Pay, AuctAssoc& S, AuctParm& Prms,
+	       int* keep, bool reoriented, AuctWorkspace& W);
+
+  /**
+   * The largest difference between two values in the same row of the
+   * payoff, used to choose the starting epsilon of the adaptive schedule.
+   * @param A Payoff Matrix
+   * @return Largest range of values within a row
+   */
+  int payoff_range (AuctCSR<int>& A);
+
+  /**
+   * The largest number of associations the pattern of the payoff allows
+   * (Hopcroft-Karp, with each row and column taking as many as its
+   * multiplicity).  On return, the workspace's MCDIST holds, for each
+   * row of A, a distance of zero or more if some largest association
+   * leaves it short.
+   * @param A Payoff Matrix
+   * @param Sh Problem "Shape", in the orientation of A
+   * @param W Workspace for the search
+   * @return Largest number of associations
+   */
+  int max_cardinality (AuctCSR<int>& A, AuctShape& Sh, AuctWorkspace& W);
+
+  /**
+   * Bound the starting prices of a warm start.  Every phase starts from
+   * a blank assignment, so any prices are a valid start, but a price
+   * far above the others (such as one bid up without limit by a bidder
+   * with no other object, which has since gained one) holds up the
+   * hidden bids of an asymmetric auction until every other price has
+   * been bid up to it, and prices near MAXINT leave no room to bid.
+   * The prices of e-CS assignments are no further apart than the
+   * widest row range, plus epsilon, so the prices are shifted to start
+   * from zero (which does not change e-CS), and any beyond the span are
+   * lowered to it.
+   * @param price Starting price of each object
+   * @param nobj Number of objects
+   * @param span Largest price kept
+   * @return Number of prices changed
+   */
+  int bound_prices (int* price, int nobj, int span);
+
+  /**
+   * Choose the epsilon reduction factor for the next phase of the
+   * adaptive schedule, from the bids made in the phase just finished.
+   * @param eps Epsilon of the phase just finished
+   * @param bids Bids made in the phase
+   * @param nbidders Number of associations to be made
+   * @param epsfac Reduction factor (updated)
+   * @return AuctMetric::EpsDecision taken
+   */
+  int adapt_epsfac (int eps, int bids, int nbidders, int& epsfac);
+
+  /**
+   * Keep the complete assignment (and prices) of an epsilon-scaling
+   * phase in the workspace, and pass it to the anytime callback.
+   * @param Sh Problem "Shape", in the auction's orientation
+   * @param S Association Matrix, in the auction's orientation
+   * @param Prms Algorithm and Run-time parameters (with the callback)
+   * @param W Workspace to keep the assignment in
+   * @param reoriented True if Sh and S are transposed from the user's view
+   * @param gap Bound on the payoff lost, in payoff units
+   * @param R Reordering S is numbered in, if any
+   * @return False if the callback asked for the auction to stop
+   */
+  bool phase_done (AuctShape& Sh, AuctAssoc& S, AuctParm& Prms,
+		   AuctWorkspace& W, bool reoriented, double gap,
+		   AuctReorder* R = 0);
+
+  /**
+   * Record the end of an epsilon-scaling phase in the metric, report
+   * it to the callback's progress method, and sample the counters.
+   * @param metric Metric the phase is added to
+   * @param Prms Algorithm and Run-time parameters
+   * @param eps Epsilon of the phase
+   * @param phasecycles Cycles run in the phase
+   * @param bids Bids made in the phase
+   * @param epsfac Reduction factor for the next phase
+   * @param decision How the phase ended (an AuctMetric::EpsDecision)
+   * @param nassoc Number of associations at the end of the phase
+   * @param cycles Cycles run in the auction so far
+   */
+  void end_phase (AuctMetric& metric, AuctParm& Prms, double eps,
+		  int phasecycles, int bids, int epsfac, int decision,
+		  int nassoc, int cycles);
+
+  /**
+   * Put back the assignment and prices kept by phase_done.
+   * @param S Association Matrix
+   * @param W Workspace the assignment was kept in
+   */
+  void restore_phase (AuctAssoc& S, AuctWorkspace& W);
+
+  /**
+   * Start the clock for an auction's time limit (if it has one), take
+   * up the parameters' event trace, and mark its hardware counters.
+   * @param Prms Algorithm and Run-time parameters
+   */
+  void start_clock (AuctParm& Prms);
+
+  /**
+   * Transpose the shape and associations, as a traced step.
+   * @param Sh Problem "Shape"
+   * @param S Association Matrix
+   */
+  void transpose (AuctShape& Sh, AuctAssoc& S);
+
+  /**
+   * The spread of a set of prices, for the trace.
+   * @param price Object prices
+   * @param nobj Number of objects
+   * @return Highest price less lowest (0 if there are none)
+   */
+  template <class V>
+  static double spread (V* price, int nobj) {
+    if (nobj == 0) return 0;
+    V lo = price[0], hi = price[0];
+    for (int j = 1; j < nobj; j++) {
+      lo = std:: min(lo, price[j]);
+      hi = std:: max(hi, price[j]);
+    }
+    return (double)hi - lo;
+  }
+
+  /**
+   * The spread of the prices of S, for the trace.
+   * @param S Association Matrix
+   * @return Highest column price less lowest
+   */
+  static double spread (AuctAssoc& S);
+
+  /**
+   * Called once per row bid upon.  Every clockrows rows, the clock is
+   * checked against the time limit, and the cancellation flag read.
+   * @return True if the time limit has run out, or the auction was
+   *         cancelled
+   */
+  inline bool out_of_time () {
+    if (clockperiod == 0 || expired) return expired;
+    if (++clockcount < clockperiod) return false;
+    clockcount = 0;
+    return check_clock();
+  }
+
+  /**
+   * Check the clock against the time limit, and read the cancellation
+   * flag, now.
+   * @return True if the time limit has run out, or the auction was
+   *         cancelled
+   */
+  inline bool check_clock () {
+    if ((timed && std::chrono::steady_clock::now() >= deadline) ||
+	cancelled())
+      expired = true;
+    return expired;
+  }
+
+  /**
+   * Check the clock now, between the stages of an auction's setup, if
+   * there is a time limit or a cancellation flag to check.
+   * @return True if the time limit has run out, or the auction was
+   *         cancelled
+   */
+  inline bool past_deadline () {
+    return (clockperiod != 0) ? check_clock() : expired;
+  }
+
+  /**
+   * Has the cancellation flag been set?
+   * @return True if the auction has a cancellation flag and it is set
+   */
+  inline bool cancelled () {
+    return cancelflag && cancelflag->load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Copy the payoff into the workspace payoff buffers as a zero based
+   * compressed row matrix, optionally transposing it, and multiplying
+   * all values by a scale factor.  The transpose is a counting sort,
+   * linear in the number of non-zeros.
+   * @param Pay Payoff Matrix
+   * @param M Number of columns in the payoff matrix
+   * @param transp True if the payoff is to be transposed
+   * @param scale Factor to multiply every payoff value by
+   * @param W Workspace to load the payoff into
+   * @return Number of non-zero entries loaded
+   */
+  int load_payoff (AuctPay& Pay, int M, bool transp, int scale,
+		   AuctWorkspace& W);
+
+  /**
+   * As load_payoff, for the floating point values of the payoff, which
+   * are loaded into the DPAYVAL buffer unscaled.
+   * @param Pay Payoff Matrix, with floating point values
+   * @param M Number of columns in the payoff matrix
+   * @param transp True if the payoff is to be transposed
+   * @param W Workspace to load the payoff into
+   * @return Number of non-zero entries loaded
+   */
+  int load_fpayoff (AuctPay& Pay, int M, bool transp, AuctWorkspace& W);
+
+  /**
+   * The work of load_payoff, on compressed row arrays of any value type.
+   * @param N Number of rows
+   * @param M Number of columns
+   * @param rowpt Row pointers (N+1 long), from base
+   * @param ind Column of each entry, from base
+   * @param val Value of each entry
+   * @param base Index of the first entry and column (0 or 1)
+   * @param transp True if the payoff is to be transposed
+   * @param scale Factor to multiply every value by
+   * @param aptr Output row pointers, zero based
+   * @param aind Output column of each entry, zero based
+   * @param aval Output value of each entry
+   * @param next Scratch space for the transpose (M+1 long)
+   */
+  template <class V>
+  void load_csr (int N, int M, int* rowpt, int* ind, V* val, int base,
+		 bool transp, V scale, int* aptr, int* aind, V* aval,
+		 int* next);
 
   /**
    * Check that the associations in S, for the problem defined by the
@@ -158,8 +706,10 @@ class AuctAlg {
    * @param Sh Problem "Shape" which includes association multiplicities
    * @param S Association Matrix
    * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the solver storage
    */
-  void checkecs (IMat& A, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms);
+  void checkecs (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+		 AuctParm& Prms, AuctWorkspace& W);
 
   /**
    * A greedy association to fill in the remaining, unassigned rows
@@ -169,7 +719,44 @@ class AuctAlg {
    * @param S Association Matrix
    * @param Prms Algorithm and Run-time parameters
    */
-  void greedy_fill (IMat& A, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms);
+  void greedy_fill (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+		    AuctParm& Prms);
+
+  /**
+   * Collapse the identical rows of the payoff into multiplicities, for
+   * the rest of the auction (see AuctParm::set_collapse).
+   * @param A Payoff Matrix (single associations)
+   * @param S Association Matrix (put in the collapsed order, if any
+   *          rows were collapsed)
+   * @param G Collapsed payoff and shape (built)
+   * @param Prms Algorithm and Run-time parameters
+   * @param metric Metric of the auction (number of distinct rows set)
+   * @param W Workspace which holds the collapsed payoff
+   */
+  void collapse_rows (AuctCSR<int>& A, AuctAssoc& S, AuctCollapse& G,
+		      AuctParm& Prms, AuctMetric& metric, AuctWorkspace& W);
+
+  /**
+   * Column reduction, for a cold start: each column is priced at its
+   * largest payoff (less the least of these, and an empty column at
+   * zero), so that no row values any column above zero and each
+   * column's best row values it at exactly zero.
+   * @param A Payoff Matrix
+   * @param S Association Matrix (prices set)
+   * @param W Workspace providing the price storage
+   */
+  void seed_prices (AuctCSR<int>& A, AuctAssoc& S, AuctWorkspace& W);
+
+  /**
+   * A conflict-free greedy association at the current prices, to start
+   * a phase: each free row, in order, takes the column of its best
+   * value if no row has it yet.  Every row so associated has its best
+   * value, so e-CS holds, and no price is raised.
+   * @param A Payoff Matrix (single associations)
+   * @param S Association Matrix
+   * @return Number of rows associated
+   */
+  int greedy_start (AuctCSR<int>& A, AuctAssoc& S);
 
   /**
    * SM auction "cycle" accomodates a (S)parse payoff with (M)ultiple 
@@ -178,8 +765,10 @@ class AuctAlg {
    * @param Sh Problem "Shape" which includes association multiplicities
    * @param S Association Matrix
    * @param Prms Algorithm and Run-time parameters
+   * @param W Workspace providing the shopping list storage
    */
-  void auct_cycle_SM (IMat& A, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms);
+  void auct_cycle_SM (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+		      AuctParm& Prms, AuctWorkspace& W);
 
   /**
    * SP1 auction "cycle" accomodates a (S)parse payoff with (P)rimitive, 
@@ -189,7 +778,29 @@ class AuctAlg {
    * @param S Association Matrix
    * @param Prms Algorithm and Run-time parameters
    */
-  void auct_cycle_SP1 (IMat& A, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms);
+  void auct_cycle_SP1 (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+		       AuctParm& Prms);
+
+  /**
+   * SPC auction "cycle" is SP1 on the (C)ompacted payoff, decoding each
+   * entry as it goes.
+   * @param C Compacted payoff matrix
+   * @param S Association Matrix
+   * @param Prms Algorithm and Run-time parameters
+   */
+  void auct_cycle_SPC (AuctCompact& C, AuctAssoc& S, AuctParm& Prms);
+
+  /**
+   * SPL auction "cycle" is SP1 with (L)ook-back: a wide row bids from
+   * the few candidates it kept at its last scan while they provably
+   * hold the best value, and is scanned only when they do not.
+   * @param A Payoff Matrix (single associations)
+   * @param S Association Matrix
+   * @param Prms Algorithm and Run-time parameters
+   * @param L Candidates of each row, invalidated whenever prices fall
+   */
+  void auct_cycle_SPL (AuctCSR<int>& A, AuctAssoc& S, AuctParm& Prms,
+		       AuctLookback& L);
 
   /**
    * SP2 auction "cycle" accomodates a (S)parse payoff with (P)rimitive, 
@@ -200,7 +811,34 @@ class AuctAlg {
    * @param S Association Matrix
    * @param Prms Algorithm and Run-time parameters
    */
-  void auct_cycle_SP2 (IMat& A, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms);
+  void auct_cycle_SP2 (AuctCSR<int>& A, AuctShape& Sh, AuctAssoc& S,
+		       AuctParm& Prms);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  static const int NOENTRY = -2147483647-1; //!< Absent dense payoff entry
+  static const int INDEXWIDTH = 16; //!< Least group width to index prices of
+  static const int WARBIDS = 8; //!< Bids a row in a phase that mean a price war
+  AuctWorkspace work; //!< Solver storage, reused from one auction to the next
+  std::chrono::steady_clock::time_point deadline; //!< End of the time limit
+  int clockperiod; //!< Rows between clock checks (0 if nothing to check)
+  int clockcount;  //!< Rows since the clock was last checked
+  bool timed;      //!< Is there a time limit?
+  bool expired;    //!< Has the time limit run out (or the auction stopped)?
+  const std::atomic<bool> *cancelflag; //!< Cancellation flag, or NULL
+  AuctTrace *trace;  //!< Event trace of the auction, or NULL
+  AuctShard *shards; //!< Shards of the sharded auction, one per thread
+  int shardcap;      //!< Number of shards allocated
+  AuctShard::PackedPrice *packed; //!< Shared prices of the sharded auction
+  int pricecap;      //!< Number of shared prices allocated
 
 };
 
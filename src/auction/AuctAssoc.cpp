@@ -11,6 +11,8 @@ AuctAssoc::AuctAssoc(int N) : AssocMatrix::AssocMatrix(N) {
   std::fill (prices, prices+N, 0);
   profits = new int[N];
   std::fill (profits, profits+N, 0);
+  pricecap = profcap = N;
+  indexon = indexfresh = false;
 }
 
 AuctAssoc::AuctAssoc(int N, int M) : AssocMatrix::AssocMatrix(N,M) {
@@ -18,6 +20,9 @@ AuctAssoc::AuctAssoc(int N, int M) : AssocMatrix::AssocMatrix(N,M) {
   std::fill (prices, prices+Ncols, 0);
   profits = new int[Nrows];
   std::fill (profits, profits+Nrows, 0);
+  pricecap = Ncols;
+  profcap = Nrows;
+  indexon = indexfresh = false;
 }
 
 AuctAssoc::AuctAssoc (AuctShape& S) :
@@ -26,6 +31,19 @@ AuctAssoc::AuctAssoc (AuctShape& S) :
   std::fill (prices, prices+Ncols, 0);
   profits = new int[Nrows];
   std::fill (profits, profits+Nrows, 0);
+  pricecap = Ncols;
+  profcap = Nrows;
+  indexon = indexfresh = false;
+}
+
+AuctAssoc::AuctAssoc (const AuctAssoc& x) : AssocMatrix::AssocMatrix(x) {
+  prices = new int[Ncols];
+  std::copy (x.prices, x.prices+Ncols, prices);
+  profits = new int[Nrows];
+  std::copy (x.profits, x.profits+Nrows, profits);
+  pricecap = Ncols;
+  profcap = Nrows;
+  indexon = indexfresh = false;
 }
 
 AuctAssoc::~AuctAssoc() {
@@ -38,24 +56,159 @@ void AuctAssoc::transpose() {
   AssocMatrix::transpose();
   int* temp;
   temp = prices; prices = profits; profits = temp;
+  std::swap (pricecap, profcap);
+  indexfresh = false;
+}
+
+void AuctAssoc::reset (AuctShape& S) {
+  AssocMatrix::resize(S.nfullrows(), S.nfullcols());
+  if (Ncols > pricecap) {
+    delete [] prices;
+    prices = new int[Ncols];
+    pricecap = Ncols;
+  }
+  if (Nrows > profcap) {
+    delete [] profits;
+    profits = new int[Nrows];
+    profcap = Nrows;
+  }
+  std::fill (prices, prices+Ncols, 0);
+  std::fill (profits, profits+Nrows, 0);
+  indexfresh = false;
+}
+
+// The payoff level operations change the shape and the expanded rows
+// or columns together, so that the two always agree.
+int AuctAssoc::add_row (AuctShape& Sh, int mult) {
+  int from = std:: min(Sh.nrows(), Sh.ncols()) + 1;
+  int i = Sh.add_row(mult);
+  add_rows(mult);
+  rescale(from, std:: min(Sh.nrows(), Sh.ncols()) + 1);
+  return i;
+}
+
+int AuctAssoc::add_col (AuctShape& Sh, int mult) {
+  int from = std:: min(Sh.nrows(), Sh.ncols()) + 1;
+  int j = Sh.add_col(mult);
+  add_cols(mult);
+  rescale(from, std:: min(Sh.nrows(), Sh.ncols()) + 1);
+  return j;
+}
+
+void AuctAssoc::remove_row (AuctShape& Sh, int i) {
+  int from = std:: min(Sh.nrows(), Sh.ncols()) + 1;
+  Sh.ifcompute();
+  remove_rows(Sh.get_rowptr(i), Sh.get_rowmult(i));
+  Sh.remove_row(i);
+  rescale(from, std:: min(Sh.nrows(), Sh.ncols()) + 1);
+}
+
+void AuctAssoc::remove_col (AuctShape& Sh, int j) {
+  int from = std:: min(Sh.nrows(), Sh.ncols()) + 1;
+  Sh.ifcompute();
+  remove_cols(Sh.get_colptr(j), Sh.get_colmult(j));
+  Sh.remove_col(j);
+  rescale(from, std:: min(Sh.nrows(), Sh.ncols()) + 1);
+}
+
+void AuctAssoc::add_rows (int count) {
+  int low = (Nrows > 0) ? *std::min_element(profits, profits+Nrows) : 0;
+  regrow (profits, profcap, Nrows, Nrows+count);
+  std::fill (profits+Nrows, profits+Nrows+count, low);
+  AssocMatrix::add_rows(count);
+}
+
+void AuctAssoc::add_cols (int count) {
+  indexfresh = false;
+  int low = (Ncols > 0) ? min_price() : 0;
+  regrow (prices, pricecap, Ncols, Ncols+count);
+  std::fill (prices+Ncols, prices+Ncols+count, low);
+  AssocMatrix::add_cols(count);
+}
+
+// A column freed by the removal keeps a price won against the removed
+// row.  Left above the prices of the associated columns, it would hold
+// up the hidden bids of an asymmetric auction until they had all been
+// bid up to it, so it is put back at the bottom.
+void AuctAssoc::remove_rows (int first, int count) {
+  indexfresh = false;
+  int i, low = (Ncols > 0) ? min_price() : 0;
+  for (i = first; i < first+count; i++)
+    if (col(i) >= 0) prices[col(i)] = low;
+  std::copy (profits+first+count, profits+Nrows, profits+first);
+  AssocMatrix::remove_rows(first, count);
+}
+
+void AuctAssoc::remove_cols (int first, int count) {
+  indexfresh = false;
+  int j, low = (Nrows > 0) ? *std::min_element(profits, profits+Nrows) : 0;
+  for (j = first; j < first+count; j++)
+    if (row(j) >= 0) profits[row(j)] = low;
+  std::copy (prices+first+count, prices+Ncols, prices+first);
+  AssocMatrix::remove_cols(first, count);
+}
+
+void AuctAssoc::rescale (int from, int to) {
+  int i;
+  if (from == to) return;
+  indexfresh = false;
+  for (i = 0; i < Ncols; i++) prices[i] = (int)((long long)prices[i] * to / from);
+  for (i = 0; i < Nrows; i++) profits[i] = (int)((long long)profits[i] * to / from);
+}
+
+void AuctAssoc::set_indexed (bool flag) {
+  indexon = flag;
+  indexfresh = false;
+  if (!flag) {
+    std::vector<int>().swap(pmin);
+    std::vector<int>().swap(pmax);
+  }
+}
+
+// The index is a segment tree kept bottom up: the price of column j is
+// leaf Ncols+j, and node i covers its children 2i and 2i+1.  A range
+// query climbs from both ends of the range, taking the nodes that lie
+// wholly inside it.
+void AuctAssoc::index_build () {
+  int i;
+  pmin.resize(2*Ncols);
+  pmax.resize(2*Ncols);
+  for (i = 0; i < Ncols; i++) pmin[Ncols+i] = pmax[Ncols+i] = prices[i];
+  for (i = Ncols-1; i > 0; i--) {
+    pmin[i] = std:: min(pmin[2*i], pmin[2*i+1]);
+    pmax[i] = std:: max(pmax[2*i], pmax[2*i+1]);
+  }
+  indexfresh = true;
 }
 
 int AuctAssoc::min_price () {
-  int *mpir;
-  mpir = std::min_element (prices, prices + Ncols);
-  return *mpir;
+  return min_price_in_colrange (0, Ncols);
 }
 
 int AuctAssoc::max_price_in_colrange (int first, int last) {
-  int *mpir;
-  mpir = std::max_element(prices+first, prices+last);
-  return *mpir;
+  if (!indexon || last - first < 2) {
+    return *std::max_element(prices+first, prices+last);
+  }
+  if (!indexfresh) index_build();
+  int mpir = prices[first];
+  for (first += Ncols, last += Ncols; first < last; first >>= 1, last >>= 1) {
+    if (first & 1) mpir = std:: max(mpir, pmax[first++]);
+    if (last & 1) mpir = std:: max(mpir, pmax[--last]);
+  }
+  return mpir;
 }
 
 int AuctAssoc::min_price_in_colrange (int first, int last) {
-  int *mpir;
-  mpir = std::min_element(prices+first, prices+last);
-  return *mpir;
+  if (!indexon || last - first < 2) {
+    return *std::min_element(prices+first, prices+last);
+  }
+  if (!indexfresh) index_build();
+  int mpir = prices[first];
+  for (first += Ncols, last += Ncols; first < last; first >>= 1, last >>= 1) {
+    if (first & 1) mpir = std:: min(mpir, pmin[first++]);
+    if (last & 1) mpir = std:: min(mpir, pmin[--last]);
+  }
+  return mpir;
 }
 
 int AuctAssoc::max_price_in_rowrange (int first, int last) {
@@ -138,22 +291,16 @@ int AuctAssoc::get_maxunass_prof() {
 }
 
 
-
-template <class T>
-class IndVal {
- public:
-  T value;
-  int index;
-  IndVal (T v, int i) { value = v; index = i; }
-  bool operator<(const IndVal &x) const {return (value < x.value);}
-  bool operator>(const IndVal &x) const {return (value > x.value);}
-};
-
 void AuctAssoc::hidden_bid(AuctShape& Sh, AuctParm& Param) {
-  std::vector <IndVal<int> > assocprice, unassocprice;
   int i, rowa, cola;
   int minassoc=Param.get_MAXINT(), maxunass=0;
 
+  indexfresh = false;
+
+  // The sort lists are members, so their storage is reused.
+  assocprice.clear();
+  unassocprice.clear();
+
   // separate Prices into Associated, and unassociated and sort.
   for (i = 0; i < Ncols; i++) {
     if (AssocMatrix::row(i)>=0) {
@@ -200,6 +347,7 @@ void AuctAssoc::group_price_equalize(AuctShape& Sh) {
   int n = Sh.nrows();
   int mpg, col;
 
+  indexfresh = false;
   for (int i = 0; i<n; i++) {
     mpg = max_price_in_rowrange (Sh.get_rowptr(i), Sh.get_rowptr(i+1));
     for (int j = Sh.get_rowptr(i); j < Sh.get_rowptr(i+1); j++) {
@@ -2,8 +2,23 @@
 #ifndef AuctAssoc_H
 #define AuctAssoc_H
 
+#include <vector>
 #include "AssocMatrix.h"
 
+/**
+ * A value tagged with an index, ordered by value.  Used to sort prices
+ * while remembering which column they belong to.
+ */
+template <class T>
+class IndVal {
+ public:
+  T value;
+  int index;
+  IndVal (T v, int i) { value = v; index = i; }
+  bool operator<(const IndVal &x) const {return (value < x.value);}
+  bool operator>(const IndVal &x) const {return (value > x.value);}
+};
+
 class AuctAssoc : public AssocMatrix {
 
 
@@ -34,6 +49,12 @@ class AuctAssoc : public AssocMatrix {
    */
   AuctAssoc (AuctShape& S);
 
+  /** 
+   * Copy constructor, including prices and profits.
+   * @param x Association Matrix to copy
+   */
+  AuctAssoc (const AuctAssoc& x);
+
   /** 
    * Destructor. 
    */
@@ -60,7 +81,10 @@ class AuctAssoc : public AssocMatrix {
    * @param value Price for given row
    */
   inline void set_Price(int ind, int value) { 
-    if (ind > -1) prices[ind] = value; 
+    if (ind > -1) {
+      prices[ind] = value;
+      if (indexfresh) index_update(ind);
+    }
   }
 
   /** 
@@ -89,7 +113,10 @@ class AuctAssoc : public AssocMatrix {
    * Set prices (vector).
    * @param inprices Array containing prices for each row
    */
-  void set_prices(int* inprices) { std::copy(inprices, inprices+Ncols, prices); }
+  void set_prices(int* inprices) {
+    std::copy(inprices, inprices+Ncols, prices);
+    indexfresh = false;
+  }
 
   /** 
    * Access profits (vector).
@@ -126,6 +153,105 @@ class AuctAssoc : public AssocMatrix {
    */
   void transpose();
 
+  /** 
+   * Re-initialize for a problem of a given shape: all associations
+   * are cleared, and prices and profits are set to zero.  Storage is
+   * reused unless the problem is larger than any previous one.
+   * @param S Shape of auction problem.
+   */
+  void reset (AuctShape& S);
+
+  /**
+   * Add a row to the problem, after the last one: the shape gains
+   * the row, and this matrix its (unassociated) row associations.
+   * The other associations, prices and profits are kept, so that the
+   * next auction warm-starts from them.  Its payoff entries are added
+   * by AuctPay::add_row. <p>
+   *
+   * Prices are in the auction's internal units, which scale with
+   * min(nrows, ncols)+1, so they are rescaled if that changes.
+   * @param Sh Shape of auction problem, changed to match
+   * @param mult Number of associations to the new row
+   * @return Index of the new row in the shape
+   */
+  int add_row (AuctShape& Sh, int mult = 1);
+
+  /**
+   * Add a column to the problem, after the last one, as add_row.  New
+   * columns are priced at the lowest existing price, so that they are
+   * bid for at once.  Its payoff entries are added by AuctPay::add_col.
+   * @param Sh Shape of auction problem, changed to match
+   * @param mult Number of associations to the new column
+   * @return Index of the new column in the shape
+   */
+  int add_col (AuctShape& Sh, int mult = 1);
+
+  /**
+   * Remove a row from the problem.  Only the associations of the row
+   * are lost (its columns become free); the rows after it are
+   * renumbered down by one.  Its payoff entries are removed by
+   * AuctPay::remove_row.
+   * @param Sh Shape of auction problem, changed to match
+   * @param i Row of the shape to remove
+   */
+  void remove_row (AuctShape& Sh, int i);
+
+  /**
+   * Remove a column from the problem, as remove_row.
+   * @param Sh Shape of auction problem, changed to match
+   * @param j Column of the shape to remove
+   */
+  void remove_col (AuctShape& Sh, int j);
+
+  /**
+   * Add unassociated rows, as AssocMatrix::add_rows, with profits
+   * set to the lowest existing profit.
+   * @param count Number of rows to add
+   */
+  void add_rows (int count);
+
+  /**
+   * Add unassociated columns, as AssocMatrix::add_cols, with prices
+   * set to the lowest existing price.
+   * @param count Number of columns to add
+   */
+  void add_cols (int count);
+
+  /**
+   * Remove a range of rows, and their profits, as AssocMatrix::remove_rows.
+   * The columns they free are priced at the lowest price.
+   * @param first First row to remove
+   * @param count Number of rows to remove
+   */
+  void remove_rows (int first, int count);
+
+  /**
+   * Remove a range of columns, and their prices, as
+   * AssocMatrix::remove_cols.  The rows they free are given the lowest
+   * profit.
+   * @param first First column to remove
+   * @param count Number of columns to remove
+   */
+  void remove_cols (int first, int count);
+
+  /**
+   * Keep an index of the prices (a segment tree of their minima and
+   * maxima), so that min_price, min_price_in_colrange and
+   * max_price_in_colrange take O(log Ncols) rather than a scan of the
+   * range.  set_Price keeps it up to date, in O(log Ncols); any other
+   * change to the prices leaves it to be rebuilt by the next query.
+   * Worth it only while the ranges queried are wide (column groups of
+   * large multiplicity).
+   * @param flag True to keep the index
+   */
+  void set_indexed (bool flag);
+
+  /**
+   * Accesses whether the prices are indexed
+   * @return True if the range queries use the index
+   */
+  bool indexed () { return indexon; }
+
   /** 
    * compute minimum price. 
    * @return Minimum price for all rows
@@ -246,6 +372,44 @@ class AuctAssoc : public AssocMatrix {
 
   int *prices;  //!< array of prices for each row
   int *profits; //!< array of profits for each column
+  int pricecap; //!< allocated length of prices
+  int profcap;  //!< allocated length of profits
+
+  bool indexon;    //!< Are the prices indexed?
+  bool indexfresh; //!< Is the index up to date (and on)?
+  std::vector<int> pmin;  //!< Index: minimum price under each node
+  std::vector<int> pmax;  //!< Index: maximum price under each node
+
+  std::vector<IndVal<int> > assocprice;   //!< hidden_bid scratch space
+  std::vector<IndVal<int> > unassocprice; //!< hidden_bid scratch space
+
+  AuctAssoc& operator= (const AuctAssoc&); //!< Not implemented
+
+  /**
+   * Rescale prices and profits from one internal payoff scale to another.
+   * @param from Scale they are in (min(nrows, ncols)+1 of the old shape)
+   * @param to Scale they are wanted in
+   */
+  void rescale (int from, int to);
+
+  /**
+   * Bring the price index up to date with all the prices.
+   */
+  void index_build ();
+
+  /**
+   * Bring the price index up to date with a changed price, from its
+   * leaf to the root.
+   * @param j Column whose price changed
+   */
+  inline void index_update (int j) {
+    int i = j + Ncols;
+    pmin[i] = pmax[i] = prices[j];
+    for (; i > 1; i >>= 1) {
+      pmin[i>>1] = std:: min(pmin[i], pmin[i^1]);
+      pmax[i>>1] = std:: max(pmax[i], pmax[i^1]);
+    }
+  }
   
     
 };
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include "AuctAsync.h"
+
+AuctAsync::AuctAsync (int nthreads) {
+  quit = false;
+  if (nthreads < 1) nthreads = 1;
+  for (int t = 0; t < nthreads; t++)
+    workers.push_back(std::thread(&AuctAsync::work, this));
+}
+
+// Queued jobs are still run by the workers, but being cancelled they
+// finish at once, so that anyone waiting on them is released.
+AuctAsync::~AuctAsync () {
+  cancel_all();
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    quit = true;
+  }
+  cv.notify_all();
+  for (int t = 0; t < (int)workers.size(); t++) workers[t].join();
+}
+
+std::shared_ptr<AuctJob> AuctAsync::submit (AuctPay& Pay, AuctShape& Sh,
+					    AuctAssoc& S, AuctParm& Prms) {
+  std::shared_ptr<AuctJob> job(new AuctJob(Pay, Sh, S, Prms));
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    queue.push_back(job);
+  }
+  cv.notify_one();
+  return job;
+}
+
+void AuctAsync::cancel_all () {
+  std::lock_guard<std::mutex> lock(mtx);
+  for (int i = 0; i < (int)queue.size(); i++) queue[i]->cancel();
+  for (int i = 0; i < (int)running.size(); i++) running[i]->cancel();
+}
+
+int AuctAsync::npending () {
+  std::lock_guard<std::mutex> lock(mtx);
+  return queue.size();
+}
+
+void AuctAsync::work () {
+  for (;;) {
+    std::shared_ptr<AuctJob> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      while (queue.empty() && !quit) cv.wait(lock);
+      if (queue.empty()) return;
+      job = queue.front();
+      queue.pop_front();
+      running.push_back(job);
+    }
+    job->run();
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      running.erase(std::find(running.begin(), running.end(), job));
+    }
+  }
+}
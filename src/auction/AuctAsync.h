@@ -0,0 +1,97 @@
+
+
+#ifndef AuctAsync_H
+#define AuctAsync_H
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "AuctJob.h"
+
+class AuctAsync {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  Starts the worker threads, which run the submitted
+   * auctions in the order they were submitted.
+   * @param nthreads Number of auctions run at once
+   */
+  AuctAsync (int nthreads = 1);
+
+  /**
+   * Destructor.  Cancels every job not yet finished, and waits for the
+   * running ones to stop.
+   */
+  ~AuctAsync ();
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Queue an auction, and return straight away.  The job copies the
+   * problem (see AuctJob), so the arguments may be reused at once.
+   * The callback of Prms, if any, is called on a worker thread, and
+   * its progress method reports each phase of the auction.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (prices and profits warm-start the auction)
+   * @param Prms Algorithm and Run-time parameters
+   * @return Handle of the job, to wait for, cancel, or read the results of
+   */
+  std::shared_ptr<AuctJob> submit (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S,
+				   AuctParm& Prms);
+
+  /**
+   * Cancel every job submitted so far which has not finished, as when
+   * newer data makes them all stale.
+   */
+  void cancel_all ();
+
+  /**
+   * Number of jobs submitted which have not yet started.
+   * @return Length of the queue
+   */
+  int npending ();
+
+ private:
+
+  /**
+   * A worker thread: run jobs from the queue until told to quit.
+   */
+  void work ();
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  std::vector<std::thread> workers;  //!< Worker threads
+  std::deque<std::shared_ptr<AuctJob> > queue;  //!< Jobs not yet started
+  std::vector<std::shared_ptr<AuctJob> > running;  //!< Jobs being run
+  std::mutex mtx;  //!< Guards queue, running and quit
+  std::condition_variable cv;  //!< Signals a new job, or quit
+  bool quit;  //!< Have the workers been told to stop?
+
+};
+
+#endif
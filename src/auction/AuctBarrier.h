@@ -0,0 +1,71 @@
+
+
+#ifndef AuctBarrier_H
+#define AuctBarrier_H
+
+#include <mutex>
+#include <condition_variable>
+
+class AuctBarrier {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.
+   * @param n Number of threads which meet at the barrier
+   */
+  AuctBarrier (int n) {
+    count = n;
+    waiting = generation = 0;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Wait until all the threads have reached the barrier.  Everything
+   * written by any thread before the barrier is visible to all of
+   * them after it.  The barrier may be used again straight away.
+   */
+  void wait () {
+    std::unique_lock<std::mutex> lock(mtx);
+    int gen = generation;
+    if (++waiting == count) {
+      waiting = 0;
+      generation++;
+      cv.notify_all();
+      return;
+    }
+    while (gen == generation) cv.wait(lock);
+  }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  std::mutex mtx;              //!< Guards the counts
+  std::condition_variable cv;  //!< Signalled when the last thread arrives
+  int count;       //!< Number of threads
+  int waiting;     //!< Number of threads waiting
+  int generation;  //!< Number of times the barrier has opened
+
+};
+
+#endif
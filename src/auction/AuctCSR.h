@@ -0,0 +1,146 @@
+
+
+#ifndef AuctCSR_H
+#define AuctCSR_H
+
+template <class V>
+class AuctCSR {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * One row: its entries' columns and values, side by side <p>
+   * const int* col;      // column of each entry <br>
+   * V* val;              // value of each entry <br>
+   * int size;            // number of entries
+   */
+  typedef struct Row {
+    const int* col;      // column of each entry
+    V* val;              // value of each entry
+    int size;            // number of entries
+  } Row;
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  An empty matrix.
+   */
+  AuctCSR () {
+    nr = nc = 0;
+    ptr = ind = 0;
+    val = 0;
+  }
+
+  /**
+   * Constructor.  A view of zero based compressed row arrays, which
+   * the caller (usually an AuctWorkspace) owns.
+   * @param nrows Number of rows
+   * @param ncols Number of columns
+   * @param rowptr Index of the first entry of each row (nrows+1 long)
+   * @param colind Column of each entry
+   * @param values Value of each entry
+   */
+  AuctCSR (int nrows, int ncols, int* rowptr, int* colind, V* values) {
+    nr = nrows;
+    nc = ncols;
+    ptr = rowptr;
+    ind = colind;
+    val = values;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses number of rows
+   * @return Number of rows
+   */
+  inline int nrows () { return nr; }
+
+  /**
+   * Accesses number of columns
+   * @return Number of columns
+   */
+  inline int ncols () { return nc; }
+
+  /**
+   * Accesses number of entries
+   * @return Number of entries
+   */
+  inline int nnz () { return nr ? ptr[nr] : 0; }
+
+  /**
+   * Accesses a row
+   * @param i Row
+   * @return Its columns, values and number of entries
+   */
+  inline Row row (int i) {
+    Row r = { ind + ptr[i], val + ptr[i], ptr[i+1] - ptr[i] };
+    return r;
+  }
+
+  /**
+   * Accesses an entry, by a search of its row
+   * @param i Row
+   * @param j Column
+   * @return Value, or zero if there is no entry
+   */
+  V operator() (int i, int j) {
+    for (int k = ptr[i]; k < ptr[i+1]; k++) if (ind[k] == j) return val[k];
+    return 0;
+  }
+
+  /**
+   * Accesses the row pointers
+   * @return Index of the first entry of each row (nrows+1 long)
+   */
+  inline int* rowptr () { return ptr; }
+
+  /**
+   * Accesses the column indices
+   * @return Column of each entry
+   */
+  inline int* colind () { return ind; }
+
+  /**
+   * Accesses the values
+   * @return Value of each entry
+   */
+  inline V* values () { return val; }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int nr;      //!< Number of rows
+  int nc;      //!< Number of columns
+  int *ptr;    //!< Index of the first entry of each row (not owned)
+  int *ind;    //!< Column of each entry (not owned)
+  V *val;      //!< Value of each entry (not owned)
+
+};
+
+#endif
@@ -0,0 +1,46 @@
+
+
+#ifndef AuctCSRMtl_H
+#define AuctCSRMtl_H
+
+// Adapters between AuctCSR views and MTL compressed matrices.  The
+// auction does not need MTL; include this only where MTL is at hand.
+
+#include "mtl/mtl.h"
+#include "mtl/matrix.h"
+#include "AuctCSR.h"
+
+/**
+ * MTL Type definition for the Oriented Payoff Data type the auction
+ * once walked: row major compressed2D, with external storage, indexed
+ * from zero.
+ */
+typedef mtl::matrix<int, mtl::rectangle<>, mtl::compressed<int, 
+  mtl::external, mtl::index_from_zero>, mtl::row_major>::type AuctIMat;
+
+/**
+ * Adapter from an MTL row major compressed2D matrix, indexed from
+ * zero.  The view shares the matrix's arrays.
+ * @param A MTL matrix
+ * @return View of A
+ */
+template <class Mat>
+AuctCSR<int> auct_csr_of (Mat& A) {
+  return AuctCSR<int> (A.nrows(), A.ncols(), (int*)A.get_ptr(),
+		       (int*)A.get_ind(), A.get_val());
+}
+
+/**
+ * Adapter to an MTL row major compressed2D matrix with external
+ * storage, indexed from zero (such as AuctIMat), sharing the view's
+ * arrays.
+ * @param A View
+ * @return MTL matrix
+ */
+template <class Mat>
+Mat auct_mtl (AuctCSR<int>& A) {
+  return Mat (A.nrows(), A.ncols(), A.nnz(), A.values(), A.rowptr(),
+	      A.colind());
+}
+
+#endif
@@ -0,0 +1,65 @@
+
+
+#ifndef AuctCallback_H
+#define AuctCallback_H
+
+#include "AuctShape.h"
+#include "AuctAssoc.h"
+
+class AuctCallback {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Destructor
+   */
+  virtual ~AuctCallback () { }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Called by the auction each time an epsilon-scaling phase ends with
+   * a complete assignment.  Each assignment is within a smaller bound
+   * of the optimum than the last, and the last (gap = 0) is optimal. <p>
+   *
+   * The shape and associations are in the user's orientation, and are
+   * only valid for the duration of the call: they must not be changed,
+   * and should be copied (e.g. with AuctAssoc::getrowassign) if needed.
+   *
+   * @param Sh Problem "Shape"
+   * @param S Associations found by the phase
+   * @param gap Bound on the payoff lost against the optimum, in payoff units
+   * @return True to carry on, false to stop the auction with this assignment
+   */
+  virtual bool improved (AuctShape& Sh, AuctAssoc& S, double gap) {
+    return true;
+  }
+
+  /**
+   * Called by the auction at the end of every epsilon-scaling phase,
+   * complete or not (before improved, if it is).  It is only a report,
+   * and is called on the thread running the auction, so it should be
+   * quick, and hand anything slow to another thread. <p>
+   *
+   * @param phase Index of the phase in AuctMetric::phase
+   * @param epsilon Epsilon of the phase, in the units of AuctMetric::EpsPhase
+   * @param nassoc Number of associations at the end of the phase
+   * @param cycles Number of cycles run by the auction so far
+   */
+  virtual void progress (int phase, double epsilon, int nassoc, int cycles) { }
+
+};
+
+#endif
@@ -0,0 +1,243 @@
+
+
+#ifndef AuctCollapse_H
+#define AuctCollapse_H
+
+#include <algorithm>
+#include "AuctCSR.h"
+#include "AuctShape.h"
+#include "AuctAssoc.h"
+#include "AuctWorkspace.h"
+
+class AuctCollapse {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  Not collapsed until built; nothing is allocated
+   * until a build finds rows to collapse.
+   */
+  AuctCollapse () {
+    nr = ng = 0;
+    rownew = rowat = 0;
+    Sh = 0;
+  }
+
+  /**
+   * Destructor
+   */
+  ~AuctCollapse () { delete Sh; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses whether any rows were collapsed
+   * @return True if built with two or more identical rows
+   */
+  inline bool collapsed () { return ng > 0; }
+
+  /**
+   * Accesses number of distinct rows
+   * @return Rows of the collapsed payoff (0 if not collapsed)
+   */
+  inline int ngroups () { return ng; }
+
+  /**
+   * Accesses the collapsed payoff: one row for each set of identical
+   * rows.
+   * @return Collapsed payoff
+   */
+  inline AuctCSR<int>& payoff () { return B; }
+
+  /**
+   * Accesses the shape of the collapsed payoff, each row's multiplicity
+   * the number of rows it stands for.
+   * @return Collapsed shape (only once collapsed)
+   */
+  inline AuctShape& shape () { return *Sh; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Collapse the identical rows of a payoff (the same entries, in the
+   * same order) into one, whose multiplicity is their number.  The
+   * rows are sorted by a hash of their entries, then by the entries
+   * themselves, so that identical rows fall together.  Each set of
+   * them becomes a contiguous run of the collapsed shape's full rows.
+   * @param A Payoff (single associations)
+   * @param W Workspace which holds the collapsed payoff
+   * @return Number of distinct rows, or 0 (and not collapsed) if all
+   *         the rows are distinct
+   */
+  int build (AuctCSR<int>& A, AuctWorkspace& W) {
+    int i, k, f, g, nnz;
+
+    nr = A.nrows();
+    ng = 0;
+    rownew = W.reserve(AuctWorkspace::CLROW, nr);
+    rowat = W.reserve(AuctWorkspace::CLROWAT, nr);
+    int *hash = W.reserve(AuctWorkspace::SCRATCH, nr);
+
+    for (i = 0; i < nr; i++) {
+      AuctCSR<int>::Row r = A.row(i);
+      unsigned int h = 2166136261u;
+      for (k = 0; k < r.size; k++) {
+	h = (h ^ (unsigned int)r.col[k]) * 16777619u;
+	h = (h ^ (unsigned int)r.val[k]) * 16777619u;
+      }
+      hash[i] = (int)h;
+      rowat[i] = i;
+    }
+    std::sort(rowat, rowat+nr, Before(A, hash));
+
+    // Count the distinct rows; if there are as many as rows, stop.
+    for (f = 0, g = 0; f < nr; f++)
+      if (f == 0 || !AuctCollapse::same(A, rowat[f-1], rowat[f])) g++;
+    if (g == nr) return 0;
+
+    // The first row of each set stands for it.
+    int *ptr = W.reserve(AuctWorkspace::CLPTR, g+1);
+    int *mult = W.reserve(AuctWorkspace::CLMULT, g);
+    for (f = 0, g = -1, nnz = 0; f < nr; f++) {
+      if (f == 0 || !AuctCollapse::same(A, rowat[f-1], rowat[f])) {
+	ptr[++g] = nnz;
+	nnz += A.row(rowat[f]).size;
+	mult[g] = 0;
+      }
+      mult[g]++;
+      rownew[rowat[f]] = f;
+    }
+    ng = g+1;
+    ptr[ng] = nnz;
+    int *ind = W.reserve(AuctWorkspace::CLIND, nnz+1);
+    int *val = W.reserve(AuctWorkspace::CLVAL, nnz+1);
+    for (f = 0, g = 0; g < ng; f += mult[g++]) {
+      AuctCSR<int>::Row r = A.row(rowat[f]);
+      std::copy(r.col, r.col+r.size, ind+ptr[g]);
+      std::copy(r.val, r.val+r.size, val+ptr[g]);
+    }
+    B = AuctCSR<int> (ng, A.ncols(), ptr, ind, val);
+
+    if (Sh) Sh->reshape(ng, A.ncols(), nnz);
+    else Sh = new AuctShape (ng, A.ncols(), nnz);
+    for (g = 0; g < ng; g++) Sh->set_rowmult(g, mult[g]);
+    Sh->ifcompute();
+    return ng;
+  }
+
+  /**
+   * Carry an association matrix (its assignment and profits) into the
+   * collapsed shape's order of rows.  Its prices stay as they are.
+   * @param S Association matrix, in the payoff's order
+   * @param W Workspace, for the copies
+   */
+  void apply (AuctAssoc& S, AuctWorkspace& W) {
+    AuctCollapse::move(S, W, rownew);
+  }
+
+  /**
+   * Carry an association matrix back from the collapsed shape's order.
+   * @param S Association matrix, in the collapsed order
+   * @param W Workspace, for the copies
+   */
+  void undo (AuctAssoc& S, AuctWorkspace& W) {
+    AuctCollapse::move(S, W, rowat);
+  }
+
+ private:
+
+  /**
+   * Orders rows by hash, then by their entries, then by number.
+   */
+  struct Before {
+    AuctCSR<int>& A;
+    int *hash;
+    Before (AuctCSR<int>& a, int* h) : A (a) { hash = h; }
+    bool operator() (int a, int b) const {
+      if (hash[a] != hash[b]) return hash[a] < hash[b];
+      AuctCSR<int>::Row ra = A.row(a), rb = A.row(b);
+      if (ra.size != rb.size) return ra.size < rb.size;
+      for (int k = 0; k < ra.size; k++) {
+	if (ra.col[k] != rb.col[k]) return ra.col[k] < rb.col[k];
+	if (ra.val[k] != rb.val[k]) return ra.val[k] < rb.val[k];
+      }
+      return a < b;
+    }
+  };
+
+  /**
+   * Whether two rows are identical
+   * @param A Payoff
+   * @param a Row
+   * @param b Row
+   * @return True if they have the same entries, in the same order
+   */
+  static bool same (AuctCSR<int>& A, int a, int b) {
+    AuctCSR<int>::Row ra = A.row(a), rb = A.row(b);
+    if (ra.size != rb.size) return false;
+    return std::equal(ra.col, ra.col+ra.size, rb.col)
+      && std::equal(ra.val, ra.val+ra.size, rb.val);
+  }
+
+  /**
+   * Renumber the rows of an association matrix.
+   * @param S Association matrix
+   * @param W Workspace, for the copies
+   * @param rmap New number of each row
+   */
+  void move (AuctAssoc& S, AuctWorkspace& W, int* rmap) {
+    int *cols = W.reserve(AuctWorkspace::CLCOPY, 2*nr);
+    int *vals = cols + nr;
+    int i;
+
+    S.get_columns(cols);
+    S.blank();
+    for (i = 0; i < nr; i++)
+      if (cols[i] != -1) S.add(rmap[i], cols[i]);
+
+    S.get_profits(cols);
+    for (i = 0; i < nr; i++) vals[rmap[i]] = cols[i];
+    S.set_profits(vals);
+  }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int nr;           //!< Number of rows
+  int ng;           //!< Number of distinct rows (0 if not collapsed)
+  int *rownew;      //!< Full row of each row (workspace owned)
+  int *rowat;       //!< Row at each full row (workspace owned)
+  AuctCSR<int> B;   //!< Collapsed payoff (arrays workspace owned)
+  AuctShape *Sh;    //!< Collapsed shape (made by the first collapse)
+
+  AuctCollapse (const AuctCollapse&);             //!< Not implemented
+  AuctCollapse& operator= (const AuctCollapse&);  //!< Not implemented
+
+};
+
+#endif
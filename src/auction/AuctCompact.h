@@ -0,0 +1,217 @@
+
+
+#ifndef AuctCompact_H
+#define AuctCompact_H
+
+#include <vector>
+#include <algorithm>
+#include "AuctCSR.h"
+#include "AuctWorkspace.h"
+
+class AuctCompact {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Limits of the 16 bit fields. <p>
+   * MAXDELTA: largest column step from one entry to the next <br>
+   * SKIP: value of an entry which only steps the column on (by
+   * MAXDELTA), where two columns are further apart than that <br>
+   * MAXQ: largest quantized value
+   */
+  enum { MAXDELTA = 0xFFFF, SKIP = 0xFFFF, MAXQ = 0xFFFE };
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  Empty until built.
+   */
+  AuctCompact () {
+    nr = 0;
+    ptr = top = step = 0;
+    dcol = qval = 0;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses number of rows
+   * @return Number of rows
+   */
+  inline int nrows () { return nr; }
+
+  /**
+   * Accesses the bytes stored for each payoff entry, on average
+   * @param nnz Entries of the uncompacted payoff
+   * @return Bytes per entry, counting the skip entries
+   */
+  double bytes_per_entry (int nnz) {
+    return nnz ? 4.0 * ptr[nr] / nnz : 0;
+  }
+
+  /**
+   * Accesses the entries of a row, for the bidding loops: the row's
+   * k-th entry (from start to end) is in column col, the sum of the
+   * first k+1 deltas, and has value top - q*step, unless q is SKIP.
+   * @param i Row
+   * @param start First entry (returned)
+   * @param end Entry after the last (returned)
+   * @param tp Largest value of the row (returned)
+   * @param st Value of one quantum of the row (returned)
+   */
+  inline void row (int i, int& start, int& end, int& tp, int& st) {
+    start = ptr[i];
+    end = ptr[i+1];
+    tp = top[i];
+    st = step[i];
+  }
+
+  /**
+   * Accesses the column deltas
+   * @return Column step of each entry
+   */
+  inline unsigned short* deltas () { return dcol; }
+
+  /**
+   * Accesses the quantized values
+   * @return Quanta below the row's top of each entry (or SKIP)
+   */
+  inline unsigned short* quanta () { return qval; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Compact a payoff into the workspace.  Each row's values are kept as
+   * quanta below its largest value, in 16 bits, and each column as its
+   * step from the last, in 16 bits.  A row whose values span more than
+   * MAXQ quanta of scale has its quantum doubled until they fit; its
+   * values are then rounded up, by less than a quantum.
+   * @param A Payoff, its values multiples of scale
+   * @param scale Unit of the payoff values
+   * @param W Workspace which holds the compacted payoff
+   * @return Largest rounding of any value, in units of scale (0 if the
+   *         compacted payoff is exact)
+   */
+  int build (AuctCSR<int>& A, int scale, AuctWorkspace& W) {
+    int i, k, n, c, prev, lo, hi, shift, err = 0;
+    long d;
+
+    nr = A.nrows();
+    ptr = W.reserve(AuctWorkspace::CMPPTR, nr+1);
+    top = W.reserve(AuctWorkspace::CMPTOP, nr);
+    step = W.reserve(AuctWorkspace::CMPSTEP, nr);
+
+    // The size of each row, with the skips its gaps need.
+    ptr[0] = 0;
+    for (i = 0; i < nr; i++) {
+      AuctCSR<int>::Row r = AuctCompact::sorted_row(A, i);
+      for (n = 0, prev = 0, k = 0; k < r.size; k++) {
+	n += 1 + (r.col[k] - prev - 1) / MAXDELTA * (r.col[k] > prev);
+	prev = r.col[k];
+      }
+      ptr[i+1] = ptr[i] + n;
+    }
+    dcol = (unsigned short*)W.reserve(AuctWorkspace::CMPCOL, ptr[nr]/2 + 1);
+    qval = (unsigned short*)W.reserve(AuctWorkspace::CMPVAL, ptr[nr]/2 + 1);
+
+    for (i = 0; i < nr; i++) {
+      AuctCSR<int>::Row r = AuctCompact::sorted_row(A, i);
+      lo = hi = r.size ? r.val[0] : 0;
+      for (k = 1; k < r.size; k++) {
+	lo = std:: min(lo, r.val[k]);
+	hi = std:: max(hi, r.val[k]);
+      }
+      d = ((long)hi - lo) / scale;
+      for (shift = 0; (d >> shift) > MAXQ; shift++) ;
+      top[i] = hi;
+      step[i] = scale << shift;
+      err = std:: max(err, (1 << shift) - 1);
+      for (n = ptr[i], prev = 0, k = 0; k < r.size; k++) {
+	for (c = r.col[k] - prev; c > MAXDELTA; c -= MAXDELTA, n++) {
+	  dcol[n] = MAXDELTA;
+	  qval[n] = SKIP;
+	}
+	dcol[n] = c;
+	qval[n++] = (unsigned short)((((long)hi - r.val[k]) / scale) >> shift);
+	prev = r.col[k];
+      }
+    }
+    return err;
+  }
+
+ private:
+
+  /**
+   * A row with its columns in order, sorted into a copy if they are not.
+   * @param A Payoff
+   * @param i Row
+   * @return The row, in order (the copy lasts until the next call)
+   */
+  AuctCSR<int>::Row sorted_row (AuctCSR<int>& A, int i) {
+    AuctCSR<int>::Row r = A.row(i);
+    int k;
+    for (k = 1; k < r.size && r.col[k-1] < r.col[k]; k++) ;
+    if (k >= r.size) return r;
+
+    pairs.resize(r.size);
+    for (k = 0; k < r.size; k++)
+      pairs[k] = std::make_pair(r.col[k], r.val[k]);
+    std::sort(pairs.begin(), pairs.end());
+    cols.resize(r.size);
+    vals.resize(r.size);
+    for (k = 0; k < r.size; k++) {
+      cols[k] = pairs[k].first;
+      vals[k] = pairs[k].second;
+    }
+    r.col = &cols[0];
+    r.val = &vals[0];
+    return r;
+  }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int nr;                 //!< Number of rows
+  int *ptr;               //!< First entry of each row (workspace owned)
+  int *top;               //!< Largest value of each row (workspace owned)
+  int *step;              //!< Value of a quantum of each row (workspace owned)
+  unsigned short *dcol;   //!< Column step of each entry (workspace owned)
+  unsigned short *qval;   //!< Quanta below top of each entry (workspace owned)
+  std::vector<std::pair<int,int> > pairs;  //!< Sorting space for a row
+  std::vector<int> cols;  //!< Columns of a sorted row
+  std::vector<int> vals;  //!< Values of a sorted row
+
+};
+
+#endif
@@ -0,0 +1,153 @@
+
+
+#ifndef AuctHeap_H
+#define AuctHeap_H
+
+#include <algorithm>
+
+class AuctHeap {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Number of children of each node.  A wider heap is shallower, so
+   * that lowering a key (which is done far more often than taking the
+   * smallest) moves it up fewer levels.
+   */
+  enum { ARITY = 4 };
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  The heap has no storage until attached.
+   */
+  AuctHeap () {
+    heap = pos = 0;
+    key = 0;
+    size = 0;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Is the heap empty?
+   * @return True if there are no items in the heap
+   */
+  inline bool empty () { return size == 0; }
+
+  /**
+   * The item with the smallest key.
+   * @return Item at the top of the heap (the heap must not be empty)
+   */
+  inline int top () { return heap[0]; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Use caller owned storage for a heap of items 0 to n-1.  The keys
+   * are read from key, which the caller changes (only ever lowering
+   * the key of an item in the heap) before calling push.
+   * @param h Heap array (n long)
+   * @param p Position of each item in the heap (n long, -1 if not in
+   *          it); it must be -1 for every item when first attached
+   * @param k Key of each item
+   */
+  void attach (int* h, int* p, double* k) {
+    heap = h;
+    pos = p;
+    key = k;
+    size = 0;
+  }
+
+  /**
+   * Put an item into the heap, or move it up if its key has been
+   * lowered while in it.
+   * @param j Item
+   */
+  inline void push (int j) {
+    int i = pos[j], parent;
+    if (i < 0) i = size++;
+    while (i > 0) {
+      parent = (i-1) / ARITY;
+      if (key[heap[parent]] <= key[j]) break;
+      heap[i] = heap[parent];
+      pos[heap[i]] = i;
+      i = parent;
+    }
+    heap[i] = j;
+    pos[j] = i;
+  }
+
+  /**
+   * Take the item with the smallest key out of the heap.
+   * @return The item (its position becomes -1)
+   */
+  inline int pop () {
+    int j = heap[0], last = heap[--size], i = 0, c, best, end;
+    pos[j] = -1;
+    if (size == 0) return j;
+    for (;;) {
+      c = ARITY*i + 1;
+      if (c >= size) break;
+      end = std:: min(c + ARITY, size);
+      for (best = c++; c < end; c++)
+	if (key[heap[c]] < key[heap[best]]) best = c;
+      if (key[heap[best]] >= key[last]) break;
+      heap[i] = heap[best];
+      pos[heap[i]] = i;
+      i = best;
+    }
+    heap[i] = last;
+    pos[last] = i;
+    return j;
+  }
+
+  /**
+   * Empty the heap, leaving the position of every item -1.
+   */
+  void clear () {
+    while (size > 0) pos[heap[--size]] = -1;
+  }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int *heap;    //!< Items, as a heap on their keys (not owned)
+  int *pos;     //!< Position of each item in heap, or -1 (not owned)
+  double *key;  //!< Key of each item (not owned)
+  int size;     //!< Number of items in the heap
+
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include "AuctJob.h"
+
+AuctJob::AuctJob (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms)
+  : Sh(Sh), Pay(Pay), S(S), Prms(Prms), stop(false), finished(false) {
+  done = result.get_future().share();
+  this->Prms.set_cancel(&stop);
+}
+
+void AuctJob::run () {
+  AuctMetric metric;
+  std::vector<std::function<void(AuctJob&)> > calls;
+
+  if (stop.load()) {
+    metric.set_timed_out(true);
+    metric.set_expired(true);
+    metric.set_cancelled(true);
+  } else {
+    metric = alg.auction(Pay, Sh, S, Prms);
+  }
+
+  // The waiters are called outside the lock, as they may well wait on
+  // (or add waiters to) this job themselves.
+  result.set_value(metric);
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    finished = true;
+    calls.swap(waiters);
+  }
+  for (int i = 0; i < (int)calls.size(); i++) calls[i](*this);
+}
+
+bool AuctJob::notify (std::function<void(AuctJob&)> f) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (finished) return false;
+  waiters.push_back(f);
+  return true;
+}
@@ -0,0 +1,204 @@
+
+
+#ifndef AuctJob_H
+#define AuctJob_H
+
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <vector>
+#include <functional>
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define AUCT_COROUTINES
+#endif
+#endif
+#include "AuctAlg.h"
+
+class AuctJob {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  The job keeps its own copies of the problem, so the
+   * caller's may be changed or freed as soon as it is made, and the
+   * auction's transposes are never seen by the caller.  The job's
+   * cancellation flag replaces any set in Prms.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape" which includes association multiplicities
+   * @param S Association Matrix (prices and profits warm-start the auction)
+   * @param Prms Algorithm and Run-time parameters
+   */
+  AuctJob (AuctPay& Pay, AuctShape& Sh, AuctAssoc& S, AuctParm& Prms);
+
+  /**
+   * Destructor.  A job must have finished before it is destroyed, which
+   * AuctAsync makes sure of by holding it until then.
+   */
+  ~AuctJob () { }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Has the job finished?  Does not wait.
+   * @return True if the results may be read
+   */
+  bool ready () {
+    return done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+
+  /**
+   * Has the job been cancelled?
+   * @return True if cancel has been called
+   */
+  bool cancelled () { return stop.load(); }
+
+  /**
+   * The future of the job's metric, for use with other futures.
+   * @return Future which becomes ready when the job finishes
+   */
+  std::shared_future<AuctMetric> future () { return done; }
+
+  /**
+   * The metric of the auction, waiting for it to finish.  A job
+   * cancelled before it started has AuctMetric::cancelled set, no
+   * cycles, and its associations as given.
+   * @return AuctMetric of the job's auction
+   */
+  AuctMetric metric () { return done.get(); }
+
+  /**
+   * The associations found, waiting for the auction to finish.
+   * @return Association Matrix, in the caller's orientation
+   */
+  AuctAssoc& assoc () { done.wait(); return S; }
+
+  /**
+   * The shape of the problem, waiting for the auction to finish.
+   * @return Problem "Shape", in the caller's orientation
+   */
+  AuctShape& shape () { done.wait(); return Sh; }
+
+  /**
+   * The solver of the job, waiting for the auction to finish (the
+   * floating point auction leaves its prices in its workspace).
+   * @return AuctAlg which ran the auction
+   */
+  AuctAlg& solver () { done.wait(); return alg; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Wait for the job to finish.
+   */
+  void wait () { done.wait(); }
+
+  /**
+   * Wait for the job to finish, for at most a given time.
+   * @param ms Longest time to wait, in milliseconds
+   * @return True if the job has finished
+   */
+  bool wait_for (double ms) {
+    return done.wait_for(std::chrono::microseconds((long)(1000 * ms)))
+      == std::future_status::ready;
+  }
+
+  /**
+   * Ask the job to stop.  It may be called from any thread, at any
+   * time.  A job still queued does not run; a running one stops within
+   * clockrows rows (see AuctParm::set_cancel), and keeps the assignment
+   * of its last complete phase, as if its time had run out.
+   */
+  void cancel () { stop.store(true); }
+
+  /**
+   * Call a function when the job finishes, on the thread which
+   * finishes it, or straight away on this thread if it already has.
+   * An event loop would use it to post a wake-up to itself.
+   * @param f Function to call, given the job
+   */
+  void on_done (std::function<void(AuctJob&)> f) {
+    if (!notify(f)) f(*this);
+  }
+
+#ifdef AUCT_COROUTINES
+  /**
+   * Awaiting a job suspends the coroutine until the job finishes.  It
+   * is resumed on the thread which finished the job.
+   */
+  struct Awaiter {
+    AuctJob* job;
+    bool await_ready () { return job->ready(); }
+    bool await_suspend (std::coroutine_handle<> h) {
+      return job->notify([h] (AuctJob&) { h.resume(); });
+    }
+    AuctMetric await_resume () { return job->metric(); }
+  };
+
+  /**
+   * co_await on a job.
+   * @return Awaiter whose result is the job's metric
+   */
+  Awaiter operator co_await () { return Awaiter{this}; }
+#endif
+
+ private:
+
+  friend class AuctAsync;
+
+  /**
+   * Run the auction, unless the job has been cancelled, and finish.
+   */
+  void run ();
+
+  /**
+   * Add a function to be called when the job finishes.
+   * @param f Function to call, given the job
+   * @return False (and f is not kept) if the job has already finished
+   */
+  bool notify (std::function<void(AuctJob&)> f);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  AuctShape Sh;  //!< Problem shape (copy)
+  AuctPay Pay;   //!< Payoff matrix (copy)
+  AuctAssoc S;   //!< Associations (copy), the results once finished
+  AuctParm Prms; //!< Parameters (copy)
+  AuctAlg alg;   //!< Solver, with its own workspace
+  std::atomic<bool> stop;  //!< Cancellation flag
+  std::promise<AuctMetric> result;  //!< Set when the job finishes
+  std::shared_future<AuctMetric> done;  //!< Future of result
+  std::mutex mtx;  //!< Guards finished and waiters
+  bool finished;   //!< Have the waiters been called?
+  std::vector<std::function<void(AuctJob&)> > waiters; //!< Called when finished
+
+};
+
+#endif
@@ -0,0 +1,461 @@
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include "AuctKBest.h"
+#include "AuctHeap.h"
+
+AuctKBest::AuctKBest () {
+  numsolves = numcycles = 0;
+  nbid = nobj = 0;
+}
+
+AuctKBest::~AuctKBest () {
+}
+
+// Murty's algorithm.  The queue holds subproblems, best first: solved
+// ones by their payoff, unsolved ones by a bound on it.  Unsolved ones
+// at the top are solved, or their bound lowered, and put back.  A
+// solved one at the top has the next best assignment, which is
+// recorded, and the rest of its subproblem is split into children.
+// The nodes taken off are kept until the end, as their children are
+// solved from them.
+int AuctKBest::kbest (AuctPay& Pay, AuctShape& Sh, AuctParm& Prms, int k,
+		      std::vector<std::vector<int> >& assign,
+		      std::vector<int>& payoff) {
+
+  int N = Sh.nrows(), M = Sh.ncols(), row, col, p, b, least;
+  unsigned int i;
+  std::vector<KBestNode*> queue, done;
+  std::vector<int> rowcol;
+  KBestNode *best;
+
+  numsolves = numcycles = 0;
+  assign.clear();
+  payoff.clear();
+  if (k <= 0) return 0;
+
+  if (Sh.nfullrows() != N || Sh.nfullcols() != M) {
+    if (Prms.MESSG())
+      std::cerr << "k-best requires single associations" << std::endl;
+    return 0;
+  }
+
+  // The entries of each bidder, and the number of each object's.
+  bool byrow = (N <= M);
+  nbid = byrow ? N : M;
+  nobj = byrow ? M : N;
+  int nnz = Pay.get_rowptr(N)-1;        // AuctPay indexes from 1
+  bptr.assign(nbid+1, 0);
+  bent.resize(nnz);  bval.resize(nnz);
+  listed.resize(nnz);
+  ocount.assign(nobj, 0);
+  cptr.assign(nobj+1, 0);
+  mark.assign(nbid+nobj, 0);
+  for (row = 0; row < N; row++) {
+    for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++) {
+      col = Pay.get_col(p)-1;
+      bptr[(byrow ? row : col) + 1]++;
+      ocount[byrow ? col : row]++;
+    }
+  }
+  for (b = 0; b < nbid; b++) bptr[b+1] += bptr[b];
+  std::vector<int> bnext(bptr.begin(), bptr.end()-1);
+  for (row = 0; row < N; row++) {
+    for (p = Pay.get_rowptr(row)-1; p < Pay.get_rowptr(row+1)-1; p++) {
+      col = Pay.get_col(p)-1;
+      b = byrow ? row : col;
+      bent[bnext[b]] = byrow ? col : row;
+      bval[bnext[b]++] = Pay.get_value(p);
+    }
+  }
+
+  best = new KBestNode;
+  solve_root(Pay, Sh, Prms, *best);
+  numsolves++;  numcycles += best->cycles;
+  if (!best->feasible) {
+    delete best;
+    return 0;
+  }
+  queue.push_back(best);
+
+  while (!queue.empty() && (int)assign.size() < k) {
+    best = queue.front();
+
+    // An unsolved subproblem at the top need only be solved if it can
+    // beat the next one down.
+    if (!best->solved) {
+      std::pop_heap (queue.begin(), queue.end(), KBestOrder());
+      queue.pop_back();
+      if (best->sibling) {
+	enqueue (best->parent, best->sibling, queue);
+	best->sibling = 0;
+      }
+      least = queue.empty() ? std::numeric_limits<int>::min()
+			    : queue.front()->value;
+      if (!queue.empty())
+	shortlist (*best->parent, best->parent->value - least);
+      solve (*best, least, alg.workspace());
+      if (best->solved) {
+	numsolves++;  numcycles += best->cycles;
+      }
+      if (best->solved && !best->feasible) {
+	delete best;
+	continue;
+      }
+      queue.push_back(best);
+      std::push_heap (queue.begin(), queue.end(), KBestOrder());
+      continue;
+    }
+
+    std::pop_heap (queue.begin(), queue.end(), KBestOrder());
+    queue.pop_back();
+    done.push_back(best);
+    rowcol.assign(N, -1);
+    for (b = 0; b < nbid; b++) {
+      if (byrow) rowcol[b] = best->assign[b];
+      else rowcol[best->assign[b]] = b;
+    }
+    assign.push_back(rowcol);
+    payoff.push_back(best->value);
+    if ((int)assign.size() < k) {
+      shortlist (*best, queue.empty() ? 0
+		 : best->value - queue.front()->value);
+      split (best, queue);
+    }
+  }
+
+  for (i = 0; i < queue.size(); i++) delete queue[i];
+  for (i = 0; i < done.size(); i++) delete done[i];
+  return assign.size();
+}
+
+// The prices and profits of the JV engine are in the auction's units,
+// which are min(rows, cols)+1 to a unit of payoff.
+bool AuctKBest::solve_root (AuctPay& Pay, AuctShape& Sh, AuctParm& Prms,
+			    KBestNode& node) {
+
+  int N = Sh.nrows(), M = Sh.ncols(), scale = std::min(N, M)+1, b, j, e;
+  bool byrow = (N <= M);
+  AuctAssoc S(Sh);
+  AuctParm P(Prms);
+
+  node.solved = true;
+  node.feasible = false;
+  node.parent = 0;
+  node.split = -1;
+  node.sibling = 0;
+  node.reach = -1;
+  P.set_engine(AuctParm::ENGINE_JV);
+  AuctMetric metric = alg.auction(Pay, Sh, S, P);
+  node.cycles = metric.ncycles();
+  if (!metric.isoptimal()) return false;
+
+  node.assign.resize(nbid);
+  node.profits.resize(nbid);
+  node.prices.resize(nobj);
+  node.value = 0;
+  for (b = 0; b < nbid; b++) {
+    node.assign[b] = byrow ? S.col(b) : S.row(b);
+    if (node.assign[b] == -1) return false;
+    node.profits[b] = (byrow ? S.Prof(b) : S.Price(b)) / scale;
+    for (e = bptr[b]; e < bptr[b+1]; e++)
+      if (bent[e] == node.assign[b]) node.value += bval[e];
+  }
+  for (j = 0; j < nobj; j++)
+    node.prices[j] = (byrow ? S.Price(j) : S.Prof(j)) / scale;
+  node.feasible = true;
+  return true;
+}
+
+// Child t forbids the pair of the t-th bidder which is not forced,
+// and forces those of the bidders before it.  Its bidder must take
+// another object, and its object another bidder (or a dummy), at a
+// reduced payoff of at least the least of those left to them: the
+// child's payoff is at most the node's less those two.  Only the
+// entries on the node's short lists are looked at, and a bidder or
+// object with others gives up more than the lists' reach otherwise.
+void AuctKBest::split (KBestNode* node, std::vector<KBestNode*>& queue) {
+
+  const int INF = std::numeric_limits<int>::max();
+  int *bmark = &mark[0], *omark = &mark[nbid];   // 1 forced, 2 forbidden
+  int *assign = &node->assign[0];
+  int *price = &node->prices[0], *profit = &node->profits[0];
+  int *nearptr = &node->nearptr[0];
+  int b, c, j, e, i, rowmin, colmin, lowest = 0;
+  unsigned int f, nf = node->forbidden.size();
+
+  // The listed entries of each object.
+  std::fill (cptr.begin(), cptr.end(), 0);
+  for (i = 0; i < nearptr[nbid]; i++) cptr[bent[node->nearent[i]] + 1]++;
+  for (j = 0; j < nobj; j++) cptr[j+1] += cptr[j];
+  cbid.resize(nearptr[nbid]);
+  cval.resize(nearptr[nbid]);
+  for (b = 0; b < nbid; b++) {
+    for (i = nearptr[b]; i < nearptr[b+1]; i++) {
+      e = node->nearent[i];
+      cbid[cptr[bent[e]]] = b;
+      cval[cptr[bent[e]]++] = bval[e];
+    }
+  }
+  for (j = nobj; j > 0; j--) cptr[j] = cptr[j-1];
+  cptr[0] = 0;
+
+  std::fill (mark.begin(), mark.end(), 0);
+  for (f = 0; f < node->forced.size(); f++) {
+    bmark[node->forced[f].first] = 1;
+    omark[node->forced[f].second] = 1;
+  }
+
+  // The objects held by dummies all have the lowest price.
+  node->holder.assign(nobj, nbid);
+  for (b = 0; b < nbid; b++) {
+    node->holder[assign[b]] = (bmark[b] & 1) ? -1 : b;
+    omark[assign[b]] |= 4;
+  }
+  for (j = 0; j < nobj; j++) {
+    if (omark[j] & 4) continue;
+    lowest = price[j];
+    break;
+  }
+
+  for (b = 0; b < nbid; b++) {
+    if (bmark[b] & 1) continue;
+    c = assign[b];
+    for (f = 0; f < nf; f++) {
+      if (node->forbidden[f].first == b) omark[node->forbidden[f].second] |= 2;
+      if (node->forbidden[f].second == c) bmark[node->forbidden[f].first] |= 2;
+    }
+    rowmin = colmin = INF;
+    for (i = nearptr[b]; i < nearptr[b+1] && rowmin > 0; i++) {
+      e = node->nearent[i];
+      if (bent[e] != c && !(omark[bent[e]] & 3))
+	rowmin = std::min(rowmin, profit[b] + price[bent[e]] - bval[e]);
+    }
+    for (i = cptr[c]; i < cptr[c+1] && colmin > 0; i++)
+      if (cbid[i] != b && !(bmark[cbid[i]] & 3))
+	colmin = std::min(colmin, profit[cbid[i]] + price[c] - cval[i]);
+    if (rowmin == INF && nearptr[b+1] - nearptr[b] < bptr[b+1] - bptr[b])
+      rowmin = node->reach + 1;
+    if (colmin == INF && cptr[c+1] - cptr[c] < ocount[c])
+      colmin = node->reach + 1;
+    if (nobj > nbid) colmin = std::min(colmin, price[c] - lowest);
+    for (f = 0; f < nf; f++) {
+      omark[node->forbidden[f].second] &= ~2;
+      bmark[node->forbidden[f].first] &= ~2;
+    }
+
+    if (rowmin != INF && colmin != INF)
+      node->kids.push_back(std::make_pair(node->value - rowmin - colmin, b));
+    bmark[b] |= 1;
+    omark[c] |= 1;
+  }
+
+  std::sort (node->kids.begin(), node->kids.end(),
+	     std::greater<std::pair<int,int> >());
+  if (!node->kids.empty()) enqueue (node, 0, queue);
+}
+
+// The children are queued best first, each when the one before it is
+// taken off the queue, so that only those near the top are made.
+void AuctKBest::enqueue (KBestNode* node, int t,
+			 std::vector<KBestNode*>& queue) {
+
+  KBestNode *kid = new KBestNode;
+  kid->solved = kid->feasible = false;
+  kid->cycles = 0;
+  kid->value = node->kids[t].first;
+  kid->parent = node;
+  kid->split = node->kids[t].second;
+  kid->sibling = (t+1 < (int)node->kids.size()) ? t+1 : 0;
+  kid->reach = -1;
+  queue.push_back(kid);
+  std::push_heap (queue.begin(), queue.end(), KBestOrder());
+}
+
+// Dijkstra's method from the freed bidder, as in AuctAlg::jv_sparse,
+// with the parent's prices and profits: every reduced payoff left is
+// at least zero, and those of its pairs are zero.  The first object
+// reached that a dummy holds lets the search on to any object, at the
+// difference in price; the dummies' objects all have the lowest price,
+// so the others need not be scanned.  The search only reads the
+// parent, and the child's copy is made once it has reached the freed
+// object: most children cost more than the least value still wanted,
+// and are put back with the bound found so far.  Such a search only
+// needs the parent's short lists of entries.
+bool AuctKBest::solve (KBestNode& node, int least, AuctWorkspace& W) {
+
+  const double INF = std::numeric_limits<double>::infinity();
+  KBestNode& par = *node.parent;
+  int r = node.split, c = par.assign[r];
+  const int *bidobj = &par.assign[0], *holder = &par.holder[0];
+  const int *price = &par.prices[0], *profit = &par.profits[0];
+  int *mask = W.reserve(AuctWorkspace::KBMASK, nobj);
+  int *pred = W.reserve(AuctWorkspace::JVPRED, nobj);
+  int *reached = W.reserve(AuctWorkspace::JVTODO, nobj);
+  int *pos = W.reserve(AuctWorkspace::JVPOS, nobj);
+  double *dist = W.dreserve(AuctWorkspace::DDIST, nobj);
+  int b, j, t, e, i, first, last, nreached = 0, dummycol = -1, sink = -1;
+  unsigned int f, nf = par.forbidden.size();
+  double d, minval = 0, cap = (double)par.value - least, over = INF;
+  bool stopped = false, listed = (par.reach >= cap);
+  AuctHeap heap;
+
+  node.solved = node.feasible = false;
+  node.cycles = 0;
+
+  // The objects of the pairs forced in the parent, and of those of the
+  // bidders split on before this one, have a holder before it; the
+  // forbidden ones are masked only while their bidder is scanned.
+  std::fill (mask, mask+nobj, 0);
+  std::fill (dist, dist+nobj, INF);
+  std::fill (pos, pos+nobj, -1);
+  heap.attach(W.reserve(AuctWorkspace::JVHEAP, nobj), pos, dist);
+
+  for (b = r; b != -1; ) {
+    for (f = 0; f < nf; f++)
+      if (par.forbidden[f].first == b) mask[par.forbidden[f].second] = 1;
+    if (b == r) mask[c] = 1;
+    first = listed ? par.nearptr[b] : bptr[b];
+    last = listed ? par.nearptr[b+1] : bptr[b+1];
+    if (last - first < bptr[b+1] - bptr[b])
+      over = std::min(over, minval + par.reach + 1);
+    for (i = first; i < last; i++) {
+      e = listed ? par.nearent[i] : i;
+      j = bent[e];
+      if (holder[j] < r || mask[j]) continue;
+      d = minval + profit[b] + price[j] - bval[e];
+      if (d > cap) {
+	over = std::min(over, d);
+	continue;
+      }
+      if (d < dist[j]) {
+	if (dist[j] == INF) reached[nreached++] = j;
+	dist[j] = d;
+	pred[j] = b;
+	heap.push(j);
+      }
+    }
+    for (f = 0; f < nf; f++)
+      if (par.forbidden[f].first == b) mask[par.forbidden[f].second] = 0;
+    mask[c] = 0;
+
+    // The nearest object: the freed one ends the search, and a real
+    // bidder's has that bidder scanned next.  Objects past the least
+    // value wanted are never queued: if one was, and nothing nearer
+    // is left, the search stops at the nearest of them.
+    b = -1;
+    while (!heap.empty()) {
+      j = heap.pop();
+      minval = dist[j];
+      if (j == c) {
+	sink = j;
+	break;
+      }
+      if (holder[j] != nbid) {
+	b = holder[j];
+	break;
+      }
+      if (dummycol != -1) continue;
+      dummycol = j;
+      for (t = 0; t < nobj; t++) {
+	if (holder[t] < r) continue;
+	d = minval + price[t] - price[j];
+	if (d > cap) {
+	  over = std::min(over, d);
+	  continue;
+	}
+	if (d < dist[t]) {
+	  if (dist[t] == INF) reached[nreached++] = t;
+	  dist[t] = d;
+	  pred[t] = -1 - j;                 // from the dummy holding j
+	  heap.push(t);
+	}
+      }
+    }
+    if (b == -1 && sink == -1 && over != INF) {
+      stopped = true;
+      minval = over;
+    }
+  }
+  heap.clear();
+
+  if (stopped) {
+    node.value = std::min(node.value, par.value - (int)minval);
+  } else {
+    node.solved = true;
+    node.cycles = 1;
+  }
+
+  // The objects settled before the freed one rise in price, so that
+  // the path's pairs are left with a reduced payoff of zero.
+  if (sink != -1) {
+    node.forced = par.forced;
+    for (b = 0; b < r; b++)
+      if (holder[bidobj[b]] == b)
+	node.forced.push_back(std::make_pair(b, bidobj[b]));
+    node.forbidden = par.forbidden;
+    node.forbidden.push_back(std::make_pair(r, c));
+    node.assign = par.assign;
+    node.prices = par.prices;
+    node.profits = par.profits;
+    int *nbidobj = &node.assign[0];
+    int *nprice = &node.prices[0], *nprofit = &node.profits[0];
+
+    nprofit[r] -= (int)minval;
+    for (t = 0; t < nreached; t++) {
+      j = reached[t];
+      if (dist[j] >= minval) continue;
+      nprice[j] += (int)(minval - dist[j]);
+      if (holder[j] != nbid) nprofit[holder[j]] -= (int)(minval - dist[j]);
+    }
+    for (j = sink; ; j = t) {
+      b = pred[j];
+      if (b < 0) {
+	t = -1 - b;
+	continue;
+      }
+      t = nbidobj[b];
+      nbidobj[b] = j;
+      if (b == r) break;
+    }
+    node.value = 0;
+    for (b = 0; b < nbid; b++) node.value += nprofit[b] + nprice[nbidobj[b]];
+    node.feasible = true;
+  }
+  return node.feasible;
+}
+
+// A solved child has the prices of its parent, or higher, and the same
+// profits but for those of the bidders on its path: the entries of the
+// other bidders are only listed if they were on the parent's list.
+void AuctKBest::shortlist (KBestNode& node, int reach) {
+
+  int b, e, i, wide, n = 0;
+  int *price = &node.prices[0], *profit = &node.profits[0];
+  KBestNode *par = node.parent;
+  bool inherit;
+
+  if (node.reach >= reach) return;
+  wide = (int)std::min((long)std::numeric_limits<int>::max(),
+		       2L*std::max(reach, node.reach)+1);
+  inherit = (par != 0 && par->reach >= reach);
+  if (inherit) wide = std::min(wide, par->reach);
+
+  node.reach = wide;
+  node.nearptr.resize(nbid+1);
+  int *nearent = &listed[0];
+  for (b = 0; b < nbid; b++) {
+    node.nearptr[b] = n;
+    if (inherit && profit[b] == par->profits[b]) {
+      for (i = par->nearptr[b]; i < par->nearptr[b+1]; i++) {
+	e = par->nearent[i];
+	if (profit[b] + price[bent[e]] - bval[e] <= wide) nearent[n++] = e;
+      }
+    } else {
+      for (e = bptr[b]; e < bptr[b+1]; e++)
+	if (profit[b] + price[bent[e]] - bval[e] <= wide) nearent[n++] = e;
+    }
+  }
+  node.nearptr[nbid] = n;
+  node.nearent.assign(nearent, nearent+n);
+}
@@ -0,0 +1,239 @@
+
+
+#ifndef AuctKBest_H
+#define AuctKBest_H
+
+#include <vector>
+#include <utility>
+#include "AuctAlg.h"
+
+class AuctKBest {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ private:
+
+  /**
+   * A Murty subproblem, and its optimal assignment. <p>
+   * The subproblem is the original problem with the "forced" pairs
+   * required, and the "forbidden" pairs removed.  The bidders are the
+   * rows, or the columns if there are fewer of them, and the objects
+   * the other side.  The prices and profits of its solution satisfy
+   * 0-CS, in payoff units, and warm-start its children. <p>
+   * A subproblem is first queued unsolved, with a bound on its value;
+   * its pairs and solution are filled in only if it reaches the top.
+   * Once split, it lists the entries of each bidder whose reduced
+   * payoff is within reach (-1 if not listed), for its children, and
+   * holds the bidder of each object (-1 if forced, nbid if a dummy)
+   * and its children's bounds, best first.
+   */
+  typedef struct KBestNode {
+    bool solved;                               // are assign and value exact
+    bool feasible;                             // was a full assignment found
+    int cycles;                                // augmentations to solve it
+    int value;                                 // total payoff, or a bound
+    KBestNode *parent;                         // subproblem split from
+    int split;                                 // bidder whose pair it forbids
+    int sibling;                               // next child of parent, or 0
+    std::vector<int> assign;                   // object of each bidder
+    std::vector<std::pair<int,int> > forced;   // (bidder,object) required
+    std::vector<std::pair<int,int> > forbidden;// (bidder,object) removed
+    std::vector<int> prices;                   // object prices
+    std::vector<int> profits;                  // bidder profits
+    int reach;                                 // most reduced payoff listed
+    std::vector<int> nearptr;                  // start of each bidder's list
+    std::vector<int> nearent;                  // entries within reach
+    std::vector<int> holder;                   // bidder of each object
+    std::vector<std::pair<int,int> > kids;     // (bound,bidder) of children
+  } KBestNode;
+
+  /**
+   * Ordering of subproblems for a heap of them: a comes after b if its
+   * assignment (or bound) is worse, or if only b of the same value is
+   * solved.
+   */
+  struct KBestOrder {
+    bool operator() (const KBestNode* a, const KBestNode* b) const {
+      return a->value < b->value ||
+	(a->value == b->value && !a->solved && b->solved);
+    }
+  };
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.
+   */
+  AuctKBest ();
+
+  /**
+   * Destructor
+   */
+  ~AuctKBest ();
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the number of (sub)problems solved by the last kbest()
+   * call: the first auction, and the searches which were completed.
+   * @return Number of (sub)problems solved
+   */
+  int nsolves() { return numsolves; }
+
+  /**
+   * Accesses the total number of cycles of the last kbest() call: those
+   * of the first auction, and one augmentation per subproblem.
+   * @return Sum of cycles over all (sub)problems
+   */
+  int ncycles() { return numcycles; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Find the k best assignments, using Murty's partitioning. <p>
+   *
+   * The best assignment is found with the JV engine, whose prices and
+   * profits satisfy 0-CS.  Each assignment found is then used to
+   * partition the remaining solutions into subproblems, each with one
+   * of its pairs forbidden and the pairs before it forced.  These are
+   * queued on a bound from the reduced payoffs of their parent, and
+   * solved only when they reach the top of the queue: the parent's
+   * assignment, less the forbidden pair, is completed by one shortest
+   * augmenting path on its prices.  A search which shows that its
+   * subproblem cannot beat the next one queued stops, and puts it
+   * back on the tighter bound. <p>
+   *
+   * Only problems with single associations (no multiplicities) are
+   * supported.  Subproblems which cannot associate min(rows,cols)
+   * pairs are dropped, so only assignments of that size are returned. <p>
+   *
+   * For k=100 on a dense 300x300 payoff this takes about 6.5 times a
+   * single solve (3 to 4 times at 1000x1000), but about 30 times at
+   * 20% density: there the bounds are weaker, so that some 25000
+   * searches are started for the 100 solved (6000 when dense), and the
+   * single auction is itself faster than the JV solve of the root.
+   *
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape", without multiplicities
+   * @param Prms Algorithm and Run-time parameters
+   * @param k Number of assignments wanted
+   * @param assign Output, the payoff column of each row, for each assignment
+   * @param payoff Output, the internal payoff (as totalpay) of each assignment
+   * @return Number of assignments found (at most k)
+   */
+  int kbest (AuctPay& Pay, AuctShape& Sh, AuctParm& Prms, int k,
+	     std::vector<std::vector<int> >& assign, std::vector<int>& payoff);
+
+ private:
+
+  /**
+   * Solve the original problem with the JV engine, and take its
+   * assignment, prices and profits into the bidders and objects.
+   * @param Pay Payoff Matrix
+   * @param Sh Problem "Shape"
+   * @param Prms Algorithm and Run-time parameters
+   * @param node Node to fill in
+   * @return True if a full assignment was found
+   */
+  bool solve_root (AuctPay& Pay, AuctShape& Sh, AuctParm& Prms,
+		   KBestNode& node);
+
+  /**
+   * Split a solved subproblem: bound a child for each pair which is
+   * not forced, by the least reduced payoff its bidder and object give
+   * up, and queue the best of them.  Children which cannot be fully
+   * associated are dropped.
+   * @param node Subproblem to split
+   * @param queue Heap of subproblems (see KBestOrder)
+   */
+  void split (KBestNode* node, std::vector<KBestNode*>& queue);
+
+  /**
+   * Queue a child of a split subproblem, to be solved later.
+   * @param node Subproblem split
+   * @param t Index of the child in the node's kids
+   * @param queue Heap of subproblems
+   */
+  void enqueue (KBestNode* node, int t, std::vector<KBestNode*>& queue);
+
+  /**
+   * Solve a subproblem from its parent's solution, filling in its
+   * pairs, assignment, value, prices, and the solved, feasible and
+   * cycles fields. <p>
+   * The freed bidder takes a shortest augmenting path, on reduced
+   * payoffs, to the freed object.  With more objects than bidders,
+   * the free objects are held by dummy bidders, which value every
+   * object at 0, so that the problem is square: the path may pass
+   * through one of them to any object.  Once the path is known to
+   * leave less than the least value wanted, the search stops, and
+   * the node is left unsolved with its value lowered to that bound.
+   * @param node Subproblem to solve
+   * @param least Value below which the node need not be solved
+   * @param W Workspace providing the search storage
+   * @return True if a full assignment was found
+   */
+  bool solve (KBestNode& node, int least, AuctWorkspace& W);
+
+  /**
+   * List the entries of each bidder of a split subproblem whose
+   * reduced payoff is at most reach, if not already listed.  The lists
+   * reach past twice that, as far as the parent's lists allow, so that
+   * they are remade only a few times.
+   * @param node Subproblem whose entries to list
+   * @param reach Least reduced payoff to list up to
+   */
+  void shortlist (KBestNode& node, int reach);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  AuctAlg alg;    //!< Auction for the first solve, and its workspace
+  int numsolves;  //!< Number of (sub)problems solved by the last kbest()
+  int numcycles;  //!< Number of cycles run by the last kbest()
+  int nbid;       //!< Number of bidders (the smaller side)
+  int nobj;       //!< Number of objects
+  std::vector<int> bptr;    //!< Start of each bidder's entries (nbid+1 long)
+  std::vector<int> bent;    //!< Object of each bidder entry
+  std::vector<int> bval;    //!< Payoff of each bidder entry
+  std::vector<int> listed;  //!< Entries being listed by shortlist
+  std::vector<int> ocount;  //!< Number of entries of each object
+  std::vector<int> cptr;    //!< Start of each object's listed entries in split
+  std::vector<int> cbid;    //!< Bidder of each listed object entry
+  std::vector<int> cval;    //!< Payoff of each listed object entry
+  std::vector<int> mark;    //!< Constraint marks of split (nbid+nobj long)
+
+  AuctKBest (const AuctKBest&);             //!< Not implemented
+  AuctKBest& operator= (const AuctKBest&);  //!< Not implemented
+
+};
+
+#endif
@@ -0,0 +1,160 @@
+
+
+#ifndef AuctLookback_H
+#define AuctLookback_H
+
+#include <algorithm>
+#include "AuctCSR.h"
+#include "AuctWorkspace.h"
+
+class AuctLookback {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * MAXCAND: most candidates kept for a row
+   */
+  enum { MAXCAND = 16 };
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  No rows cached until built.
+   */
+  AuctLookback () {
+    nr = k = hits = 0;
+    ent = thr = ok = 0;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the number of candidates kept for each row
+   * @return Candidates per row (0 if none are kept)
+   */
+  inline int ncand () { return k; }
+
+  /**
+   * Accesses whether a row is worth caching: one with no more than a
+   * few times the candidates' entries is cheaper to scan.
+   * @param size Entries of the row
+   * @return True if its candidates are kept
+   */
+  inline bool wide (int size) { return k > 0 && size > 4*k; }
+
+  /**
+   * Accesses whether a row's candidates still hold
+   * @param i Row
+   * @return True if cached since the prices last fell
+   */
+  inline bool cached (int i) { return ok[i] != 0; }
+
+  /**
+   * Accesses a row's candidates
+   * @param i Row
+   * @return Its k entries (offsets into the row) of best value, when cached
+   */
+  inline int* cand (int i) { return ent + (long)i*k; }
+
+  /**
+   * Accesses a row's threshold: no entry other than its candidates had
+   * a value above it when they were cached, and as prices only rise
+   * none has since.
+   * @param i Row
+   * @return Value of its best entry left out
+   */
+  inline int threshold (int i) { return thr[i]; }
+
+  /**
+   * Accesses the number of bids made from the candidates
+   * @return Bids which did not scan their row
+   */
+  inline int nhits () { return hits; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Keep k candidates for each row of a payoff, all uncached.
+   * @param nrows Rows of the payoff
+   * @param ncand Candidates per row (0 to keep none, at most MAXCAND)
+   * @param W Workspace which holds the candidates
+   */
+  void build (int nrows, int ncand, AuctWorkspace& W) {
+    nr = nrows;
+    k = std:: min(ncand, (int)MAXCAND);
+    if (k <= 0) return;
+    ent = W.reserve(AuctWorkspace::LBENT, nr*k);
+    thr = W.reserve(AuctWorkspace::LBTHR, nr);
+    ok = W.reserve(AuctWorkspace::LBOK, nr);
+    invalidate();
+  }
+
+  /**
+   * Forget every row's candidates, as the prices may have fallen.  Each
+   * row is cached again the next time it bids.
+   */
+  void invalidate () {
+    if (k > 0) std::fill(ok, ok+nr, 0);
+  }
+
+  /**
+   * Cache a row, from the scan which found its best entries.
+   * @param i Row
+   * @param top Its k entries of best value
+   * @param threshold Value of the next best entry
+   */
+  void cache (int i, int* top, int threshold) {
+    std::copy(top, top+k, cand(i));
+    thr[i] = threshold;
+    ok[i] = 1;
+  }
+
+  /**
+   * Count a bid made from the candidates.
+   */
+  inline void hit () { hits++; }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int nr;        //!< Number of rows
+  int k;         //!< Candidates per row
+  int *ent;      //!< Candidate entries of each row (workspace owned)
+  int *thr;      //!< Threshold of each row (workspace owned)
+  int *ok;       //!< Whether each row is cached (workspace owned)
+  int hits;      //!< Bids made from the candidates
+
+};
+
+#endif
@@ -3,8 +3,70 @@
 #ifndef AuctMetric_H
 #define AuctMetric_H
 
+#include <vector>
+#include <algorithm>
+
 class AuctMetric {
   friend class AuctAlg;
+  friend class AuctJob;
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Decision taken at the end of an epsilon-scaling phase. <p>
+   * EPS_FIXED: fixed schedule, epsilon divided by epsfac <br>
+   * EPS_KEEP: adaptive, reduction factor kept <br>
+   * EPS_FASTER: adaptive, few bids, reduction factor increased <br>
+   * EPS_BACKOFF: adaptive, price war, reduction factor decreased <br>
+   * EPS_SKIP: adaptive, remaining phases skipped, straight to epsilon = 1 <br>
+   * EPS_FINAL: the final (optimal epsilon) phase <br>
+   * EPS_STOPPED: the phase was cut short (out of cycles or time)
+   */
+  enum EpsDecision { EPS_FIXED, EPS_KEEP, EPS_FASTER, EPS_BACKOFF,
+		     EPS_SKIP, EPS_FINAL, EPS_STOPPED };
+
+  /**
+   * Reason the engine was chosen. <p>
+   * WHY_REQUESTED: it was set in AuctParm::set_engine <br>
+   * WHY_COST: the cost model estimated it to be the fastest <br>
+   * WHY_DENSITY: the payoff is too sparse, or too large, for the dense JV
+   * engine <br>
+   * WHY_OPTIONS: only the auction has the options asked for (floating
+   * point, distributed, pruned or sharded) <br>
+   * WHY_WARM: the association matrix carries prices or profits, from
+   * which only the auction warm-starts (without multiplicities)
+   */
+  enum EngineReason { WHY_REQUESTED, WHY_COST, WHY_DENSITY, WHY_OPTIONS,
+		      WHY_WARM };
+
+  /**
+   * Record of one epsilon-scaling phase <p>
+   * double epsilon;      // epsilon of the phase <br>
+   * int cycles;          // auction cycles run in the phase <br>
+   * int bids;            // bids made in the phase <br>
+   * int epsfac;          // reduction factor to the next phase <br>
+   * int decision;        // EpsDecision taken at the end of the phase
+   */
+  typedef struct EpsPhase {
+    double epsilon;      // epsilon of the phase
+    int cycles;          // auction cycles run in the phase
+    int bids;            // bids made in the phase
+    int epsfac;          // reduction factor to the next phase
+    int decision;        // EpsDecision taken at the end of the phase
+  } EpsPhase;
+
+  /**
+   * MAXPHASES: most epsilon-scaling phases recorded.  The integer
+   * auctions' epsilon falls at least twofold a phase, so they run no
+   * more than 32; phases beyond it are folded into the last record.
+   */
+  enum { MAXPHASES = 64 };
 
   // ------------------------------------------------------------------
   //
@@ -19,7 +81,18 @@ class AuctMetric {
    */
   AuctMetric () {
     numcycles = numassoc_byauction = numassoc_total = numassoc_max = 0;
+    numallocs = numpruned = numreadmitted = 0;
+    numreachable = -1;
+    numseeded = numlookback = numrowgroups = 0;
     payoffdensity = 0;
+    payoffgap = -1;
+    quant_error = -1;
+    col_span = col_span_in = 0;
+    engine_used = engine_why = 0;
+    auction_cost = jv_cost = jvsp_cost = 0;
+    numphases = 0;
+    std::fill(phases, phases+MAXPHASES, EpsPhase());
+    expired_flag = cancelled_flag = failed_flag = false;
     timedout = re_oriented = sparsification = row_mults = false;
     col_mults = e_scaling = false;
   }
@@ -62,6 +135,68 @@ class AuctMetric {
    */
   int nmaxassoc() {return numassoc_max; }
 
+  /**
+   * Accesses the largest number of associations the pattern of the
+   * payoff allows, with its multiplicities (see AuctParm::set_precheck).
+   * The auction stops once it has made this many.
+   * @return Reachable associations (-1 if not checked)
+   */
+  int nreachable() {return numreachable; }
+
+  /**
+   * Accesses the number of rows some largest association leaves short
+   * @return Number of short rows (0 if the payoff is feasible)
+   */
+  int nshortrows() {return shortrows.size(); }
+
+  /**
+   * Accesses a row some largest association leaves short: one which
+   * has no entries, or which competes with others for fewer columns
+   * than there are rows.  Any of these may be left unassociated.
+   * @param i Short row, in order
+   * @return Payoff row (a payoff column if reoriented())
+   */
+  int shortrow(int i) {return shortrows[i]; }
+
+  /**
+   * Accesses number of associations the phases started with (see
+   * AuctParm::set_seed)
+   * @return Rows associated greedily, over all the phases
+   */
+  int nseeded() {return numseeded; }
+
+  /**
+   * Accesses number of bids made from look-back candidates (see
+   * AuctParm::set_lookback)
+   * @return Bids which did not scan their row
+   */
+  int nlookback() {return numlookback; }
+
+  /**
+   * Accesses number of distinct rows the identical rows were collapsed
+   * to in a price war (see AuctParm::set_collapse)
+   * @return Rows of the collapsed payoff (0 if none were collapsed)
+   */
+  int nrowgroups() {return numrowgroups; }
+
+  /**
+   * Accesses number of workspace allocations made during the auction
+   * @return Number of heap allocations (zero once the workspace is warm)
+   */
+  int nallocs() {return numallocs; }
+
+  /**
+   * Accesses number of payoff entries the bidding never saw
+   * @return Number of entries removed by pruning (after re-admission)
+   */
+  int npruned() {return numpruned; }
+
+  /**
+   * Accesses number of pruned payoff entries which had to be re-admitted
+   * @return Number of entries re-admitted after failing the e-CS check
+   */
+  int nreadmitted() {return numreadmitted; }
+
   /**
    * Accesses density of the sparse payoff matrix
    * @return Density of the payoff matrix (i.e. non-zeros / total )
@@ -74,6 +209,58 @@ class AuctMetric {
    */
   bool timed_out() {return timedout; }
 
+  /**
+   * Accesses boolean flag indicating the time limit was reached
+   * @return True if the wall-clock time limit ran out (implies timed_out)
+   */
+  bool expired() {return expired_flag; }
+
+  /**
+   * Accesses boolean flag indicating the auction was cancelled
+   * @return True if the cancellation flag stopped the auction (implies
+   *         expired)
+   */
+  bool cancelled() {return cancelled_flag; }
+
+  /**
+   * Accesses boolean flag indicating the auction failed
+   * @return True if a process of a distributed auction was lost (implies
+   *         timed_out; the assignment is this process's partial one)
+   */
+  bool failed() {return failed_flag; }
+
+  /**
+   * Accesses the bound on how far the result is from optimal.  A
+   * result returned early comes from the last completed epsilon-scaling
+   * phase, whose epsilon bounds the payoff lost.
+   * @return Bound on payoff lost, in payoff units (0 if optimal,
+   *         -1 if no phase completed and there is no bound)
+   */
+  double gap() {return payoffgap; }
+
+  /**
+   * Accesses the largest rounding of a value of the compacted payoff
+   * (see AuctParm::set_compact).  Each association may lose this much
+   * payoff, which the gap includes.
+   * @return Rounding, in payoff units (0 if exact, -1 if the payoff
+   *         was not compacted)
+   */
+  double quanterror() {return quant_error; }
+
+  /**
+   * Accesses the locality of the payoff bid on: the average span of a
+   * row's columns (see AuctParm::set_reorder)
+   * @return Average column span, after any reordering (0 if not known)
+   */
+  double colspan() {return col_span; }
+
+  /**
+   * Accesses the locality of the payoff before it was reordered
+   * @return Average column span, in the payoff's own order (0 if not
+   *         reordered)
+   */
+  double colspan_in() {return col_span_in; }
+
   /**
    * Accesses boolean flag indicating whether a reorientation was needed
    * @return True if payoff matrix was transposed before auction.
@@ -104,6 +291,49 @@ class AuctMetric {
    */
   bool escaling() {return e_scaling; }
 
+  /**
+   * Accesses number of epsilon-scaling phases run, including the last
+   * @return Number of phases recorded (at most MAXPHASES)
+   */
+  int nphases() {return numphases; }
+
+  /**
+   * Accesses the record of an epsilon-scaling phase
+   * @param i Phase, in the order run
+   * @return Epsilon, cycles, bids and the decision taken for the phase
+   */
+  EpsPhase phase(int i) {return phases[i]; }
+
+  /**
+   * Accesses the engine which was run
+   * @return An AuctParm::Engine (never ENGINE_AUTO)
+   */
+  int engine() {return engine_used; }
+
+  /**
+   * Accesses the reason the engine was chosen
+   * @return An EngineReason
+   */
+  int engine_reason() {return engine_why; }
+
+  /**
+   * Accesses the cost model's estimate for the auction
+   * @return Estimated cost, in the units of AuctParm::set_costmodel
+   */
+  double auction_estimate() {return auction_cost; }
+
+  /**
+   * Accesses the cost model's estimate for the JV engine
+   * @return Estimated cost (0 if JV was not considered)
+   */
+  double jv_estimate() {return jv_cost; }
+
+  /**
+   * Accesses the cost model's estimate for the sparse JV engine
+   * @return Estimated cost (0 if it was not considered)
+   */
+  double jvsp_estimate() {return jvsp_cost; }
+
  private:
   
   /**
@@ -130,6 +360,48 @@ class AuctMetric {
    */ 
   void set_nmaxassoc(int val)      { numassoc_max            = val; }
 
+  /**
+   * Sets the largest number of associations the payoff's pattern allows
+   * @param val Reachable associations
+   */
+  void set_nreachable(int val)     { numreachable            = val; }
+
+  /**
+   * Sets number of associations the phases started with
+   * @param val Rows associated greedily, over all the phases
+   */
+  void set_nseeded(int val)        { numseeded               = val; }
+
+  /**
+   * Sets number of bids made from look-back candidates
+   * @param val Bids which did not scan their row
+   */
+  void set_nlookback(int val)      { numlookback             = val; }
+
+  /**
+   * Sets number of distinct rows the identical rows were collapsed to
+   * @param val Rows of the collapsed payoff
+   */
+  void set_nrowgroups(int val)     { numrowgroups            = val; }
+
+  /**
+   * Sets number of workspace allocations made during the auction
+   * @param val Number of heap allocations
+   */
+  void set_nallocs(int val)        { numallocs               = val; }
+
+  /**
+   * Sets number of payoff entries the bidding never saw
+   * @param val Number of entries removed by pruning
+   */
+  void set_npruned(int val)        { numpruned               = val; }
+
+  /**
+   * Sets number of pruned payoff entries which had to be re-admitted
+   * @param val Number of entries re-admitted
+   */
+  void set_nreadmitted(int val)    { numreadmitted           = val; }
+
   /**
    * Sets density of the sparse payoff matrix
    * @param val Density of the payoff matrix (i.e. non-zeros / total )
@@ -142,6 +414,43 @@ class AuctMetric {
    */
   void set_timed_out(bool flag)    { timedout                = flag; }
 
+  /**
+   * Sets boolean flag indicating the time limit was reached
+   * @param flag True if the wall-clock time limit ran out
+   */
+  void set_expired(bool flag)      { expired_flag            = flag; }
+
+  /**
+   * Sets boolean flag indicating the auction was cancelled
+   * @param flag True if the cancellation flag stopped the auction
+   */
+  void set_cancelled(bool flag)    { cancelled_flag          = flag; }
+
+  /**
+   * Sets boolean flag indicating the auction failed
+   * @param flag True if a process of a distributed auction was lost
+   */
+  void set_failed(bool flag)       { failed_flag             = flag; }
+
+  /**
+   * Sets the bound on how far the result is from optimal
+   * @param val Bound on payoff lost, in payoff units (-1 if unbounded)
+   */
+  void set_gap(double val)         { payoffgap               = val; }
+
+  /**
+   * Sets the largest rounding of a value of the compacted payoff
+   * @param val Rounding, in payoff units (-1 if not compacted)
+   */
+  void set_quanterror(double val)  { quant_error             = val; }
+
+  /**
+   * Sets the locality of the payoff, before and after reordering
+   * @param in Average column span of a row, in the payoff's order
+   * @param out Average column span of a row, as bid on
+   */
+  void set_colspan(double in, double out) { col_span_in = in; col_span = out; }
+
   /**
    * Sets boolean flag indicating whether a reorientation was needed
    * @param flag True if payoff matrix was transposed before auction.
@@ -172,6 +481,49 @@ class AuctMetric {
    */
   void set_escaling(bool flag)     { e_scaling               = flag; }
 
+  /**
+   * Sets the engine which was run, and why
+   * @param e An AuctParm::Engine
+   * @param why An EngineReason
+   * @param auct Cost model's estimate for the auction
+   * @param jv Cost model's estimate for the JV engine
+   * @param jvsp Cost model's estimate for the sparse JV engine
+   */
+  void set_engine(int e, int why, double auct, double jv, double jvsp) {
+    engine_used = e;
+    engine_why = why;
+    auction_cost = auct;
+    jv_cost = jv;
+    jvsp_cost = jvsp;
+  }
+
+  /**
+   * Records an epsilon-scaling phase.  The records are kept in the
+   * metric itself, so that a solve does not allocate for them; once
+   * MAXPHASES are kept, the last one takes on the cycles and bids of
+   * any more, and their epsilon and decision.
+   * @param eps Epsilon of the phase
+   * @param cycles Auction cycles run in the phase
+   * @param bids Bids made in the phase
+   * @param fac Reduction factor to the next phase
+   * @param decision EpsDecision taken at the end of the phase
+   */
+  void add_phase(double eps, int cycles, int bids, int fac, int decision) {
+    EpsPhase ph = { eps, cycles, bids, fac, decision };
+    if (numphases == MAXPHASES) {
+      ph.cycles += phases[numphases-1].cycles;
+      ph.bids += phases[numphases-1].bids;
+      numphases--;
+    }
+    phases[numphases++] = ph;
+  }
+
+  /**
+   * Records a row some largest association leaves short
+   * @param row Payoff row (a payoff column if reoriented)
+   */
+  void add_shortrow(int row) { shortrows.push_back(row); }
+
 //
 // ------------------------------------------------------------------
 //
@@ -185,9 +537,13 @@ class AuctMetric {
 
   /**
    * Computes a boolean flag indicating whether the result is optimal
+   * (a rounded compacted payoff may have cost it optimality)
    * @return True if the result is optimal
    */
-  bool isoptimal() {return (numassoc_max == numassoc_byauction); }
+  bool isoptimal() {
+    return (!timedout && numassoc_max == numassoc_byauction
+	    && quant_error <= 0);
+  }
 
   /**
    * Computes a boolean flag indicating whether the problem was feasible
@@ -209,13 +565,35 @@ class AuctMetric {
   int numassoc_byauction; //!< Number of objects associated in auction
   int numassoc_total; //!< Number of objects associated, total
   int numassoc_max; //!< Maximum concievable number of associations
+  int numreachable; //!< Associations the payoff's pattern allows
+  int numseeded; //!< Associations the phases started with
+  int numlookback; //!< Bids made from look-back candidates
+  int numrowgroups; //!< Distinct rows, once identical ones were collapsed
+  int numallocs; //!< Number of workspace allocations during the auction
+  int numpruned; //!< Number of payoff entries removed by pruning
+  int numreadmitted; //!< Number of pruned entries re-admitted
   double payoffdensity; //!< Density of the payoff matrix
+  double payoffgap; //!< Bound on the payoff lost against the optimum
+  double quant_error; //!< Largest rounding of the compacted payoff
+  double col_span; //!< Average column span of a row, as bid on
+  double col_span_in; //!< Average column span of a row, before reordering
   bool timedout; //!< Did the auction time out?
+  bool expired_flag; //!< Did the wall-clock time limit run out?
+  bool cancelled_flag; //!< Was the auction cancelled?
+  bool failed_flag; //!< Was a process of a distributed auction lost?
   bool re_oriented; //!< Was the payoff matrix transposed before the auction?
   bool sparsification; //!< Was the payoff matrix sparsified from a dense input?
   bool row_mults; //!< Were there multiple row associations?
   bool col_mults; //!< Were there multiple column associations?
   bool e_scaling; //!< Was epsilon-scaling employed?
+  int numphases; //!< Epsilon-scaling phases recorded
+  EpsPhase phases[MAXPHASES]; //!< Epsilon-scaling phases, in the order run
+  std::vector<int> shortrows; //!< Rows a largest association leaves short
+  int engine_used; //!< Engine run (an AuctParm::Engine)
+  int engine_why; //!< Reason the engine was chosen (an EngineReason)
+  double auction_cost; //!< Cost model's estimate for the auction
+  double jv_cost; //!< Cost model's estimate for the JV engine
+  double jvsp_cost; //!< Cost model's estimate for the sparse JV engine
 
   
 };
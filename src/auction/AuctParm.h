@@ -3,8 +3,33 @@
 #ifndef AuctParm_H
 #define AuctParm_H
 
+#include <atomic>
+
+class AuctCallback;
+class AuctTransport;
+class AuctTrace;
+class AuctPerf;
+class AuctTelemetry;
+
 class AuctParm {
 
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Engine used by AuctAlg::auction. <p>
+   * ENGINE_AUTO: chosen by the cost model (see set_engine) <br>
+   * ENGINE_AUCTION: the (forward) auction <br>
+   * ENGINE_JV: dense Jonker-Volgenant shortest augmenting paths <br>
+   * ENGINE_JVSP: sparse shortest augmenting paths, on the payoff's CSR
+   */
+  enum Engine { ENGINE_AUTO, ENGINE_AUCTION, ENGINE_JV, ENGINE_JVSP };
+
   // ------------------------------------------------------------------
   //
   //	Constructors, Destructors, and Operators.
@@ -25,7 +50,31 @@ class AuctParm {
     epsbegin = 5;
     epsfactor   = 5;
     dcare    = 0;
+    prunek   = 0;
+    nthreads = 1;
+    timelimit = 0;
+    clockrows = 64;
+    callback = 0;
+    transport = 0;
+    cancelflag = 0;
+    trace = 0;
+    perf = 0;
+    telemetry = 0;
+    engine = ENGINE_AUTO;
+    auctcost = 1;
+    jvcost = 0.3;
+    jvspcost = 0.15;
+    jvdensity = 0.5;
     escale_flag = epsrel = true;
+    epsadapt = false;
+    floatpt = false;
+    compactpay = false;
+    reorderpay = false;
+    precheckpay = true;
+    seedpay = true;
+    lookbackcand = 0;
+    collapsepay = true;
+    tolerance = 0;
     status_msg_flag = debug_flag = false;
   }
 
@@ -78,6 +127,97 @@ class AuctParm {
    */
   int get_dontcare() {return dcare; }
 
+  /**
+   * Accesses number of payoff entries kept per bidder by the pruning stage
+   * @return Entries kept per bidder, or 0 if the payoff is not pruned
+   */
+  int get_prunek() {return prunek; }
+
+  /**
+   * Accesses number of threads of the sharded auction
+   * @return Number of threads bidding at once (1 = single threaded)
+   */
+  int get_nthreads() {return nthreads; }
+
+  /**
+   * Accesses the wall-clock time limit of an auction
+   * @return Time limit in milliseconds, or 0 if there is none
+   */
+  double get_timelimit() {return timelimit; }
+
+  /**
+   * Accesses the number of rows bid upon between checks of the clock
+   * @return Rows between clock checks
+   */
+  int get_clockrows() {return clockrows; }
+
+  /**
+   * Accesses the anytime callback
+   * @return Callback given each improving assignment, or NULL
+   */
+  AuctCallback* get_callback() {return callback; }
+
+  /**
+   * Accesses the transport of the distributed auction
+   * @return Transport joining the auction's processes, or NULL
+   */
+  AuctTransport* get_transport() {return transport; }
+
+  /**
+   * Accesses the cancellation flag
+   * @return Flag which stops the auction when set, or NULL
+   */
+  const std::atomic<bool>* get_cancel() {return cancelflag; }
+
+  /**
+   * Accesses the event trace
+   * @return Trace the solver's steps are recorded into, or NULL
+   */
+  AuctTrace* get_trace() {return trace; }
+
+  /**
+   * Accesses the hardware counters
+   * @return Counters sampled at each epsilon-scaling phase, or NULL
+   */
+  AuctPerf* get_perf() {return perf; }
+
+  /**
+   * Accesses the telemetry registry
+   * @return Registry each solve is recorded into, or NULL
+   */
+  AuctTelemetry* get_telemetry() {return telemetry; }
+
+  /**
+   * Accesses the engine to be used
+   * @return An Engine (ENGINE_AUTO if chosen by the cost model)
+   */
+  int get_engine() {return engine; }
+
+  /**
+   * Accesses the cost model's weight for the auction
+   * @return Estimated time per payoff entry per epsilon-scaling phase
+   */
+  double get_auctcost() {return auctcost; }
+
+  /**
+   * Accesses the cost model's weight for the JV engine
+   * @return Estimated time per dense payoff entry per augmentation
+   */
+  double get_jvcost() {return jvcost; }
+
+  /**
+   * Accesses the cost model's weight for the sparse JV engine
+   * @return Estimated time per payoff entry per heap level per
+   *         augmentation
+   */
+  double get_jvspcost() {return jvspcost; }
+
+  /**
+   * Accesses the least density at which the JV engine is considered
+   * @return Fraction of the payoff entries present
+   */
+  double get_jvdensity() {return jvdensity; }
+
   /**
    * Accesses Maximum possible payoff value (usu. set by largest integer)
    * @return  Maximum possible payoff value (usu. set by largest integer)
@@ -107,6 +247,60 @@ class AuctParm {
    * @return True if epsilon=1 is optimal, false if epsilon in Payoff units.
    */
   bool epsrelative() {return epsrel; }
+
+  /**
+   * Accesses Flag for the adaptive epsilon-scaling schedule
+   * @return True if epsilon start and reduction adapt to the problem
+   */
+  bool epsadaptive() {return epsadapt; }
+
+  /**
+   * Accesses Flag for the floating point auction
+   * @return True if payoffs are kept, and auctioned, in floating point
+   */
+  bool floating() {return floatpt; }
+
+  /**
+   * Accesses Flag for the compacted payoff
+   * @return True if the auction bids on a 16 bit copy of the payoff
+   */
+  bool compact() {return compactpay; }
+
+  /**
+   * Accesses Flag for the reordered payoff
+   * @return True if the payoff is reordered for locality before bidding
+   */
+  bool reorder() {return reorderpay; }
+
+  /**
+   * Accesses Flag for the structural pre-check
+   * @return True if the reachable associations are found before bidding
+   */
+  bool precheck() {return precheckpay; }
+
+  /**
+   * Accesses Flag for the greedy start of each phase
+   * @return True if each phase starts from a greedy association
+   */
+  bool seed() {return seedpay; }
+
+  /**
+   * Accesses number of look-back candidates
+   * @return Candidates kept for each wide row (0 if none)
+   */
+  int lookback() {return lookbackcand; }
+
+  /**
+   * Accesses Flag for collapsing identical rows in a price war
+   * @return True if identical rows may be collapsed into multiplicities
+   */
+  bool collapse() {return collapsepay; }
+
+  /**
+   * Accesses optimality tolerance of the floating point auction
+   * @return Bound on the payoff lost, in payoff units (0 for the default)
+   */
+  double get_tolerance() {return tolerance; }
   
   /**
    * Sets maximum number of auction cycles.
@@ -144,6 +338,151 @@ class AuctParm {
    */
   void set_dontcare (int x) { dcare = x; }
 
+  /**
+   * Sets number of payoff entries kept per bidder by the pruning stage.
+   * Only the best n entries of each bidder (row, or column if there
+   * are fewer columns) are bid upon, and any others are re-admitted
+   * if the result does not satisfy e-CS with them.
+   * @param n Entries kept per bidder, or 0 to not prune the payoff
+   */
+  void set_prunek (int n) { prunek = n; }
+
+  /**
+   * Sets number of threads of the sharded auction.  With more than one,
+   * the bidders are split into that many shards, balanced by number of
+   * payoff entries, which bid at the same time.  Only single
+   * associations are supported (others use a single thread), and a
+   * pruned auction (set_prunek) is not sharded.
+   * @param n Number of threads bidding at once
+   */
+  void set_nthreads (int n) { nthreads = (n < 1) ? 1 : n; }
+
+  /**
+   * Sets the wall-clock time limit of an auction.  When the time runs
+   * out, bidding stops, and the assignment of the last completed
+   * epsilon-scaling phase (or else the partial assignment, greedily
+   * filled) is returned.  AuctMetric::gap bounds how far it is from
+   * optimal.  The limit and maxcycles both apply.
+   * <p>
+   * The clock starts when AuctAlg::auction is called, and is checked
+   * between the steps of the setup and every clockrows rows bid upon;
+   * once it has run out, the remaining optional steps (precheck,
+   * reorder, compact, seed, pruning) are skipped.  Three steps are
+   * never interrupted, and may run past the limit: loading the
+   * payoff (one pass over its entries, or the dense copy of the JV
+   * engine), grouping the entries by bidder for a pruned auction, and
+   * the greedy fill of a partial assignment (one more pass).
+   * @param ms Time limit in milliseconds, or 0 for no limit
+   */
+  void set_timelimit (double ms) { timelimit = ms; }
+
+  /**
+   * Sets the number of rows bid upon between checks of the clock.
+   * @param n Rows between clock checks
+   */
+  void set_clockrows (int n) { clockrows = (n < 1) ? 1 : n; }
+
+  /**
+   * Sets the anytime callback, which is given the assignment at the
+   * end of every epsilon-scaling phase, and may stop the auction.
+   * The callback is not owned by the parameters.
+   * @param cb Callback, or NULL for none
+   */
+  void set_callback (AuctCallback* cb) { callback = cb; }
+
+  /**
+   * Sets the transport of the distributed auction.  If it joins more
+   * than one process, the auction is distributed over them (see
+   * AuctAlg::auctionD).  The transport is not owned by the parameters.
+   * @param t Transport, or NULL to auction in this process only
+   */
+  void set_transport (AuctTransport* t) { transport = t; }
+
+  /**
+   * Sets the cancellation flag.  It may be set from any thread, and is
+   * checked with the clock (every clockrows rows) and between cycles.
+   * When it is set, the auction stops as if its time limit had run out,
+   * and AuctMetric::cancelled is set.  The flag is not owned by the
+   * parameters.
+   * @param flag Flag to watch, or NULL for none
+   */
+  void set_cancel (const std::atomic<bool>* flag) { cancelflag = flag; }
+
+  /**
+   * Sets the event trace.  The steps of the solver (see AuctTrace::Event)
+   * are recorded into it, on the thread which runs them, for export as
+   * Chrome trace JSON.  Without one, the only cost is a test of the
+   * pointer at each step.  The trace is not owned by the parameters,
+   * and may be shared by auctions running at the same time.
+   * @param t Trace, or NULL for none
+   */
+  void set_trace (AuctTrace* t) { trace = t; }
+
+  /**
+   * Sets the hardware counters.  A sample is recorded into them at the
+   * end of every epsilon-scaling phase (one for each AuctMetric::phase),
+   * counting from the end of the last; the first also counts the loading
+   * of the payoff.  The counters are not owned by the parameters, and
+   * may not be shared by auctions running at the same time.
+   * @param p Counters, or NULL for none
+   */
+  void set_perf (AuctPerf* p) { perf = p; }
+
+  /**
+   * Sets the telemetry registry.  Each solve through AuctAlg::auction
+   * records its latency and metric into it, under its problem size.
+   * The registry is not owned by the parameters, and may be shared by
+   * auctions running at the same time; AuctTelemetry::global() is the
+   * one for the whole process.
+   * @param t Registry, or NULL for none
+   */
+  void set_telemetry (AuctTelemetry* t) { telemetry = t; }
+
+  /**
+   * Sets the engine.  ENGINE_AUTO (the default) estimates the time of
+   * the auction and of the two JV engines, and runs the cheapest.  The
+   * auction is taken to cost auctcost for every payoff entry in every
+   * epsilon-scaling phase, up to twice that when the payoff range is
+   * small next to the number of bidders (ties make price wars), and more
+   * again on a sparse payoff, in proportion to the number of bidders
+   * over the entries of each.  JV is taken to cost jvcost for every
+   * entry of the dense payoff in every augmentation, of which there are
+   * about the square root of the number of bidders (the others are
+   * short), up to twice that as the density falls.  JV is only
+   * considered when the payoff has at least jvdensity of its entries, as
+   * it works on a dense copy.  The sparse JV engine is taken to cost
+   * jvspcost for every payoff entry, and every level of its heap, in
+   * each of the same number of long augmentations; it suits very sparse
+   * payoffs.  The floating point, distributed, pruned and sharded
+   * auctions are run when asked for, whatever the engine.  So is the
+   * auction when the association matrix already carries prices or
+   * profits (a warm start, e.g. after AuctAssoc::add_row), as the JV
+   * engines would start again from zero, unless the problem has
+   * multiplicities.  The choice, and the reason for it, are recorded
+   * in AuctMetric.
+   * @param e An Engine
+   */
+  void set_engine (int e) { engine = e; }
+
+  /**
+   * Sets the weights of the cost model (see set_engine).  Only their
+   * ratio matters.
+   * @param auction Time per payoff entry per epsilon-scaling phase
+   * @param jv Time per dense payoff entry per augmentation
+   * @param jvsp Time per payoff entry per heap level per augmentation
+   */
+  void set_costmodel (double auction, double jv, double jvsp) {
+    auctcost = auction;
+    jvcost = jv;
+    jvspcost = jvsp;
+  }
+
+  /**
+   * Sets the least density at which the JV engine is considered
+   * @param x Fraction of the payoff entries present (above 1 for never)
+   */
+  void set_jvdensity (double x) { jvdensity = x; }
+
   /**
    * Sets Maximum possible payoff value (usu. set by largest integer)
    * @param n Maximum possible payoff value (usu. set by largest integer)
@@ -178,6 +517,119 @@ class AuctParm {
    */
   void set_epsrelative (bool flag) { epsrel = flag; }
 
+  /**
+   * Sets Flag for the adaptive epsilon-scaling schedule.  When set,
+   * a relative starting epsilon is taken from the payoff range of the
+   * rows (rather than from epsstart), and the reduction factor
+   * (starting at epsfac) is adjusted after each phase, from the number
+   * of bids the phase needed.  The decisions are recorded in AuctMetric.
+   * @param flag True to adapt the epsilon-scaling schedule
+   */
+  void set_epsadaptive (bool flag) { epsadapt = flag; }
+
+  /**
+   * Sets Flag for the floating point auction.  It must be set before
+   * the AuctPay is built, so that the unscaled values are kept.  The
+   * payoff is then auctioned in its own units, with floating point
+   * prices, and res and MAXINT do not matter.  Only single
+   * associations are supported (others fall back to the integer auction).
+   * @param flag True to auction in floating point
+   */
+  void set_floating (bool flag) { floatpt = flag; }
+
+  /**
+   * Sets Flag for the compacted payoff.  The auction of single
+   * associations then bids on a copy of the payoff with 4 bytes to an
+   * entry rather than 8: each value in 16 bits, as quanta below its
+   * row's largest, and each column as a 16 bit step from the last.  A
+   * row whose values span more than 65534 payoff units has a coarser
+   * quantum, and its values are rounded up by less than one; the
+   * largest rounding is reported by AuctMetric::quanterror, and is
+   * counted in AuctMetric::gap.  The other auctions and engines do not
+   * compact. <p>
+   * It only pays on sparse payoffs, with a few scattered entries to a
+   * row, whose bids miss the cache on every row: 15% faster with 10
+   * entries to a row of 20000.  Dense rows are read straight through,
+   * and decoding the steps costs more than the memory saved: 15-25%
+   * slower at 2000x2000 and 4000x4000, dense or at 10%.
+   * @param flag True to bid on the compacted payoff
+   */
+  void set_compact (bool flag) { compactpay = flag; }
+
+  /**
+   * Sets Flag for the reordered payoff.  The auction of single
+   * associations then renumbers the rows and columns of its copy of the
+   * payoff by reverse Cuthill-McKee, so that the rows which share
+   * columns bid one after another and the prices each row reads lie
+   * close together.  The assignment, prices and profits are renumbered
+   * back before they are returned (or handed to the callback).  Worth
+   * it for large sparse payoffs whose columns are in no useful order;
+   * AuctMetric::colspan reports the locality before and after.
+   * @param flag True to reorder the payoff
+   */
+  void set_reorder (bool flag) { reorderpay = flag; }
+
+  /**
+   * Sets Flag for the structural pre-check (on by default).  Before the
+   * auction bids, Hopcroft-Karp on the pattern of the payoff (with its
+   * multiplicities) finds the largest number of associations that can
+   * be made, and the auction stops once it has made them, instead of
+   * bidding up the prices of columns some rows cannot all have until
+   * maxcycles runs out.  AuctMetric::nreachable and shortrow report
+   * what was found.  Only the (single threaded) auctionF checks.
+   * @param flag True to check the pattern first
+   */
+  void set_precheck (bool flag) { precheckpay = flag; }
+
+  /**
+   * Sets Flag for the greedy start of each phase (on by default).  Each
+   * phase of a square single association auction starts with every
+   * row whose best column no earlier row took already given it, rather
+   * than from an empty association, and a cold one is first priced by
+   * a column reduction (each column at its largest payoff).
+   * Neither breaks e-CS.  AuctMetric::nseeded reports how many rows
+   * were so associated.
+   * @param flag True to start each phase greedily
+   */
+  void set_seed (bool flag) { seedpay = flag; }
+
+  /**
+   * Sets number of look-back candidates (0, the default, for none).
+   * The single association auction keeps, for each row with more than
+   * four times as many entries, the columns of its best values when it
+   * last scanned, and the best value it left out.  Prices only rise
+   * within a phase, so while the best of its candidates is still worth
+   * that much, the row bids from them without a scan.  Worth it for
+   * rows of thousands of entries; AuctMetric::nlookback reports the
+   * bids so made.  Not used with a compacted payoff.
+   * @param k Candidates kept for each wide row (4 to 8 is usual)
+   */
+  void set_lookback (int k) { lookbackcand = k; }
+
+  /**
+   * Sets Flag for collapsing identical rows in a price war (on by
+   * default).  Identical rows trade the same columns back and forth,
+   * raising their prices an epsilon at a time, for as many cycles as
+   * the range of the payoff over epsilon.  When a phase of the single
+   * association auction takes several bids a row, identical rows are
+   * looked for, and if there are any they are collapsed into one row
+   * with their number as its multiplicity, whose copies bid together
+   * against the best column beyond those they take.  The cycles then
+   * go with the number of distinct rows.  AuctMetric::nrowgroups
+   * reports it.
+   * @param flag True to collapse identical rows in a price war
+   */
+  void set_collapse (bool flag) { collapsepay = flag; }
+
+  /**
+   * Sets optimality tolerance of the floating point auction.  The final
+   * epsilon is the tolerance divided by the number of associations, so
+   * the total payoff is within the tolerance of the optimum.
+   * @param x Bound on the payoff lost, in payoff units, or 0 for 1e-9
+   *          times the largest payoff magnitude
+   */
+  void set_tolerance (double x) { tolerance = x; }
+
 //
 // ------------------------------------------------------------------
 //
@@ -191,6 +643,21 @@ class AuctParm {
   int maxcycles; //!< Maximum number of auction cycles
   int epsilon;  //!< Bidding increment
   int dcare;  //!< Don't care value for sparsification
+  int prunek;  //!< Number of entries kept per bidder in pruning (0 = off)
+  int nthreads;  //!< Number of threads of the sharded auction
+  double timelimit;  //!< Wall-clock time limit in ms (0 = none)
+  int clockrows;  //!< Rows bid upon between clock checks
+  AuctCallback* callback;  //!< Anytime callback (not owned)
+  AuctTransport* transport;  //!< Distributed auction transport (not owned)
+  const std::atomic<bool>* cancelflag;  //!< Cancellation flag (not owned)
+  AuctTrace* trace;  //!< Event trace (not owned)
+  AuctPerf* perf;  //!< Hardware counters (not owned)
+  AuctTelemetry* telemetry;  //!< Telemetry registry (not owned)
+  int engine;  //!< Engine to be used (an Engine)
+  double auctcost;  //!< Cost model weight of the auction
+  double jvcost;  //!< Cost model weight of the JV engine
+  double jvspcost;  //!< Cost model weight of the sparse JV engine
+  double jvdensity;  //!< Least payoff density for the JV engine
   int MAXINT;  //!< Maximum possible payoff value
   double resolution;  //!< Discretization resolution for payoff matrix
   double epsbegin;  //!< Beginning value of epsilon
@@ -198,6 +665,15 @@ class AuctParm {
   bool debug_flag;  //!< Flag to turn on debugging messages
   bool status_msg_flag;  //!< Flag to turn on status messages
   bool epsrel;  //!< Flag to indicate a problem-relative epsilon (1=optimal)
+  bool epsadapt;  //!< Flag to adapt the epsilon-scaling schedule
+  bool floatpt;  //!< Flag to auction in floating point
+  bool compactpay;  //!< Flag to bid on the compacted payoff
+  bool reorderpay;  //!< Flag to reorder the payoff for locality
+  bool precheckpay;  //!< Flag to find the reachable associations first
+  bool seedpay;  //!< Flag to start each phase from a greedy association
+  int  lookbackcand;  //!< Look-back candidates kept for each wide row
+  bool collapsepay;  //!< Flag to collapse identical rows in a price war
+  double tolerance;  //!< Optimality tolerance of the floating point auction
   int  epsfactor;  //!< Reduction factor for epsilon-scaling
 };
 
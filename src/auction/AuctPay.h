@@ -2,8 +2,12 @@
 #ifndef AuctPay_H
 #define AuctPay_H
 
+#include <iostream>
+#include <cstdlib>
 #include <vector>
 #include <algorithm>
+#include <utility>
+#include "AuctTrace.h"
 
 class AuctPay {
   friend class AuctAlg;
@@ -33,29 +37,38 @@ class AuctPay {
 	   std::vector<T> vals, std::vector<int> rowpt) {
     unsigned int nnz = (unsigned int) shape.nnz();
     double res = Param.get_res();
+    AuctTrace* trace = Param.get_trace();
     sparsified = false;
 
+    if (trace) trace->begin(AuctTrace::INGEST, nnz);
     if (nnz != ind.size() | nnz != vals.size()) { 
-      cerr << "Payoff constructor has inconsistent inputs!";
+      std::cerr << "Payoff constructor has inconsistent inputs!";
       exit(-1);
     }
     numrows = shape.nrows();
     num_non_zeros = nnz;
-    values    = new int [shape.nnz()];
-    col_index = new int [shape.nnz()];
-    rowptr    = new int [shape.nrows()+1];
+    values = col_index = rowptr = 0;
+    fvalues = 0;
+    valcap = rowcap = fvalcap = 0;
+    base = 1;
+    ownval = ownfval = ownind = ownrow = false;
+    floating = Param.floating();
+    reserve (shape.nrows(), shape.nnz());
 
     unsigned int i;
     for (i = 0; i < nnz; i++) {
       values[i] = (int) (vals[i]/res);
+      if (floating) fvalues[i] = (double) vals[i];
     }
     copy (ind.begin(), ind.end(), col_index);
     copy (rowpt.begin(), rowpt.end(), rowptr);
+    if (trace) trace->end(AuctTrace::INGEST, nnz);
   }
 
   /**
    * Constructor: with AssocShape and Dense vector of vectors of doubles.
-   * Vpay is scaled, cast to integer, and sparsified.
+   * Vpay is scaled, cast to integer, and sparsified.  If the parameters
+   * ask for the floating point auction, the unscaled values are kept too.
    *
    * In this case, the Shape number of non-zeros is set by the constructor.
    * @param Param Parameters for Auction
@@ -64,50 +77,206 @@ class AuctPay {
    */
   template <class T>
   AuctPay (AuctParm& Param, AuctShape &shape, std::vector<std::vector<T> > &Vpay) {
+    values = col_index = rowptr = 0;
+    fvalues = 0;
+    valcap = rowcap = fvalcap = 0;
+    base = 1;
+    ownval = ownfval = ownind = ownrow = false;
+    assign (Param, shape, Vpay);
+  }    
+
+  /**
+   * Reload with a new dense vector of vectors, as in the constructor.
+   * The internal arrays are reused, and only reallocated if the new
+   * payoff has more rows or non-zeros than any previous one.
+   * @param Param Parameters for Auction
+   * @param shape Auction "shape", number of non-zeros is set here
+   * @param Vpay an STL vector of vectors specifying the payoff matrix.
+   */
+  template <class T>
+  void assign (AuctParm& Param, AuctShape &shape, 
+	       std::vector<std::vector<T> > &Vpay) {
 
     int nnz = 1;
-    std::vector<int> vals, ind, rowpt;
     double res = Param.get_res();
-    int i;
+    int i, row;
     T dont_care=(T)Param.get_dontcare();
+    AuctTrace* trace = Param.get_trace();
     sparsified = true;
+    floating = Param.floating();
+    if (trace) trace->begin(AuctTrace::INGEST);
+
+    // Count the entries to keep, so that the flat arrays may be sized.
+    typename std::vector<std::vector<T> >::iterator vi;
+    typename std::vector<T>::iterator vj;
+    for (vi = Vpay.begin(); vi < Vpay.end(); vi++) {
+      for (vj = (*vi).begin(); vj < (*vi).end(); vj++) {
+	if (*vj != dont_care) ++nnz;
+      }
+    }
+    shape.set_nnz(nnz);
+    numrows = (int) shape.nrows();
+    num_non_zeros = (int) nnz;
+    reserve (shape.nrows(), shape.nnz());
 
     // The Vpay input is unpacked as a (sparse, integer valued) row
     // oriented matrix.  Values equal to the dont_care value are
     // omitted from the matrix
-    std::vector<std::vector<T> >::iterator vi;
-    std::vector<T>::iterator vj;
-    for (vi = Vpay.begin(); vi < Vpay.end(); vi++) {
-      rowpt.push_back(nnz);
+    nnz = 1;
+    for (row = 0, vi = Vpay.begin(); vi < Vpay.end(); row++, vi++) {
+      rowptr[row] = nnz;
       for (i = 1, vj = (*vi).begin(); vj < (*vi).end(); i++, vj++) {
 	if (*vj != dont_care) {
+	  col_index[nnz-1] = i;
+	  values[nnz-1] = (int)(*vj/res);
+	  if (floating) fvalues[nnz-1] = (double) *vj;
 	  ++nnz;
-	  ind.push_back(i);
-	  vals.push_back((int)(*vj/res));
 	}
       }    
     }
-    rowpt.push_back(nnz);
+    rowptr[row] = nnz;
+    if (trace) trace->end(AuctTrace::INGEST, nnz-1);
+  }    
 
-    // Convert to flat arrays.  (needed for MTL constructor)
+  /**
+   * Constructor: with a subset of the entries of another payoff.
+   * Entry i (a linear index, as in get_value) is kept if keep[i] is
+   * true.  The shape number of non-zeros is set by the constructor.
+   * @param src Payoff to take entries from
+   * @param shape Auction "shape", number of non-zeros is set here
+   * @param keep Flag for each entry of src, true to keep it
+   */
+  AuctPay (AuctPay& src, AuctShape& shape, const std::vector<bool>& keep) {
+    int i, k, nnz = 1;
+    for (k = 0; k < src.get_rowptr(src.numrows)-1; k++) if (keep[k]) nnz++;
     shape.set_nnz(nnz);
-    numrows = (int) shape.nrows();
-    num_non_zeros = (int) nnz;
-    values    = new int [shape.nnz()];
-    col_index = new int [shape.nnz()];
-    rowptr    = new int [shape.nrows()+1];
-    std::copy (vals.begin(), vals.end(), values);
-    std::copy (ind.begin(), ind.end(), col_index);
-    std::copy (rowpt.begin(), rowpt.end(), rowptr);
-  }    
+    numrows = src.numrows;
+    num_non_zeros = nnz;
+    sparsified = src.sparsified;
+    floating = src.floating;
+    values = col_index = rowptr = 0;
+    fvalues = 0;
+    valcap = rowcap = fvalcap = 0;
+    base = 1;
+    ownval = ownfval = ownind = ownrow = false;
+    reserve (numrows, nnz);
+
+    nnz = 1;
+    for (i = 0; i < numrows; i++) {
+      rowptr[i] = nnz;
+      for (k = src.get_rowptr(i)-1; k < src.get_rowptr(i+1)-1; k++) {
+	if (keep[k]) {
+	  values[nnz-1] = src.values ? src.values[k] : 0;
+	  if (floating) fvalues[nnz-1] = src.fvalues[k];
+	  col_index[nnz-1] = src.get_col(k);
+	  nnz++;
+	}
+      }
+    }
+    rowptr[numrows] = nnz;
+  }
+
+  /**
+   * Copy constructor.
+   * @param x Payoff to copy
+   */
+  AuctPay (const AuctPay& x) {
+    numrows = x.numrows;
+    num_non_zeros = x.num_non_zeros;
+    sparsified = x.sparsified;
+    floating = x.floating;
+    values = col_index = rowptr = 0;
+    fvalues = 0;
+    valcap = rowcap = fvalcap = 0;
+    base = 1;
+    ownval = ownfval = ownind = ownrow = false;
+    reserve (numrows, num_non_zeros);
+    base = x.base;
+    if (x.values) {
+      std::copy (x.values, x.values+num_non_zeros, values);
+    } else {
+      delete [] values;
+      values = 0;
+      ownval = false;
+      valcap = 0;
+    }
+    if (floating) std::copy (x.fvalues, x.fvalues+num_non_zeros, fvalues);
+    std::copy (x.col_index, x.col_index+num_non_zeros, col_index);
+    std::copy (x.rowptr, x.rowptr+numrows+1, rowptr);
+  }
 
   /**
-   * Destructor
+   * Constructor: a view of a compressed row payoff held by the caller,
+   * such as the buffers of a SciPy CSR matrix.  The row pointers and
+   * column indices are used in place, not copied, and must outlive the
+   * payoff.  Floating point values are used in place by the floating
+   * point auction (AuctParm::set_floating), and are otherwise scaled
+   * and cast to int, as by the other constructors.  Int values are
+   * used in place if res is 1.  The shape number of non-zeros is set
+   * by the constructor.
+   * @param Param Parameters for Auction
+   * @param shape Auction "shape"
+   * @param rowpt Index of the first entry of each row (nrows+1 long)
+   * @param ind Column of each entry
+   * @param vals Value of each entry (int or double)
+   * @param from Index of the first entry and column: 0 (as in C and
+   *             SciPy) or 1 (as in the other constructors)
+   */
+  template <class T>
+  AuctPay (AuctParm& Param, AuctShape& shape, int* rowpt, int* ind,
+	   T* vals, int from) {
+    numrows = shape.nrows();
+    num_non_zeros = rowpt[numrows] - from;
+    shape.set_nnz(num_non_zeros);
+    sparsified = false;
+    floating = Param.floating();
+    base = from;
+    rowptr = rowpt;
+    col_index = ind;
+    values = 0;
+    fvalues = 0;
+    valcap = rowcap = fvalcap = 0;
+    ownval = ownfval = ownind = ownrow = false;
+    if (Param.get_trace())
+      Param.get_trace()->begin(AuctTrace::INGEST, num_non_zeros);
+    view_values (vals, Param.get_res());
+    if (Param.get_trace())
+      Param.get_trace()->end(AuctTrace::INGEST, num_non_zeros);
+  }
+
+  /**
+   * Constructor: a view of entries already scaled and cast to int,
+   * such as those of another payoff, used in place whatever the
+   * resolution.  The shape number of non-zeros is set by the
+   * constructor.
+   * @param shape Auction "shape"
+   * @param rowpt Index of the first entry of each row (nrows+1 long)
+   * @param ind Column of each entry
+   * @param vals Value of each entry
+   * @param from Index of the first entry and column (0 or 1)
+   */
+  AuctPay (AuctShape& shape, int* rowpt, int* ind, int* vals, int from) {
+    numrows = shape.nrows();
+    num_non_zeros = rowpt[numrows] - from;
+    shape.set_nnz(num_non_zeros);
+    sparsified = floating = false;
+    base = from;
+    rowptr = rowpt;
+    col_index = ind;
+    values = vals;
+    fvalues = 0;
+    valcap = rowcap = fvalcap = 0;
+    ownval = ownfval = ownind = ownrow = false;
+  }
+
+  /**
+   * Destructor.  Arrays held for the caller (see above) are not freed.
    */
   ~AuctPay() {
-    delete [] values;
-    delete [] col_index;
-    delete [] rowptr;
+    if (ownval) delete [] values;
+    if (ownfval) delete [] fvalues;
+    if (ownind) delete [] col_index;
+    if (ownrow) delete [] rowptr;
   }
 
   // ------------------------------------------------------------------
@@ -118,6 +287,12 @@ class AuctPay {
 
  public:
 
+  /**
+   * get number of rows in the sparse payoff matrix
+   * @return Number of rows
+   */
+  inline int nrows() { return numrows; }
+
   /**
    * get value at index i in the sparse payoff matrix
    * @param i Linear index into sparse payoff matrix
@@ -125,27 +300,55 @@ class AuctPay {
    */
   inline int get_value(int i) { return values[i]; }
 
+  /**
+   * get unscaled floating point value at index i in the sparse payoff
+   * matrix.  Only valid if has_fvalues().
+   * @param i Linear index into sparse payoff matrix
+   * @return value at i, in the original payoff units
+   */
+  inline double get_fvalue(int i) { return fvalues[i]; }
+
+  /**
+   * Accessor to flag indicating whether floating point values are kept
+   * (see AuctParm::set_floating).
+   * @return True if get_fvalue may be used
+   */
+  bool has_fvalues() {return floating;}
+
+  /**
+   * Accessor to flag indicating whether int values are kept.  They
+   * always are, except in a view of floating point values made for
+   * the floating point auction, which can then be the only auction
+   * run on it.
+   * @return True if get_value may be used
+   */
+  bool has_values() {return values != 0;}
+
   /**
    * get column index associated w/ linear index i in the sparse payoff matrix
    * @param i Linear index into sparse payoff matrix
    * @return Column index.
    */
-  inline int get_col (int i) { return col_index[i]; }
+  inline int get_col (int i) { return col_index[i] + 1 - base; }
 
   /**
    * get linear index associated w/ first non-zero entry on row i
    * @param i Row index into sparse payoff matrix
    * @return Linear index of 1st non-zero entry.
    */
-  inline int get_rowptr (int i) { return rowptr[i]; }
+  inline int get_rowptr (int i) { return rowptr[i] + 1 - base; }
 
   /**
-   * get value at index i in the sparse payoff matrix
+   * get value at index i in the sparse payoff matrix (and the floating
+   * point value, if kept)
    * @param i Linear index into sparse payoff matrix
    * @param v value at i
    */
   template <class T>
-  inline void set_value (int i, T v) {values[i] = (int)v; }
+  inline void set_value (int i, T v) {
+    values[i] = (int)v;
+    if (floating) fvalues[i] = (double)v;
+  }
 
   /**
    * get column index associated w/ linear index i in the sparse payoff matrix
@@ -161,6 +364,138 @@ class AuctPay {
    */
   inline void set_rowpt (int i, int ptr) {rowptr[i] = ptr; }
 
+  /**
+   * Add a row after the last one, with the given entries.  Storage
+   * grows by doubling, so that rows may be added one at a time (a
+   * view, see above, is first copied).  Goes with AuctAssoc::add_row,
+   * which adds the row to the shape.  The shape number of non-zeros
+   * is set here.
+   * @param Param Parameters for Auction (for the resolution)
+   * @param shape Auction "shape"
+   * @param cols Column of each entry, from 0 as in the shape
+   * @param vals Value of each entry
+   * @param count Number of entries
+   */
+  template <class T>
+  void add_row (AuctParm& Param, AuctShape& shape, int* cols, T* vals,
+		int count) {
+    int i, k, end = rowptr[numrows] - base;
+    double res = Param.get_res();
+    std::vector<std::pair<int,int> > order;
+
+    make_room (numrows+1, end+count);
+    for (i = 0; i < count; i++) order.push_back(std::make_pair(cols[i], i));
+    std::sort (order.begin(), order.end());
+    for (k = 0; k < count; k++) {
+      i = order[k].second;
+      put (end+k, cols[i]+1, vals[i], res);
+    }
+    numrows++;
+    rowptr[numrows] = rowptr[numrows-1] + count;
+    num_non_zeros += count;
+    shape.set_nnz(num_non_zeros);
+  }
+
+  /**
+   * Add entries in a new column.  The columns from j up are renumbered
+   * up by one, so with j the index returned by AuctAssoc::add_col the
+   * entries are in the new last column.  The shape number of
+   * non-zeros is set here.
+   * @param Param Parameters for Auction (for the resolution)
+   * @param shape Auction "shape"
+   * @param j Column of the entries, from 0 as in the shape
+   * @param rows Row of each entry (each row at most once)
+   * @param vals Value of each entry
+   * @param count Number of entries
+   */
+  template <class T>
+  void add_col (AuctParm& Param, AuctShape& shape, int j, int* rows, T* vals,
+		int count) {
+    int r, k, c, a, b, e, s = count;
+    double res = Param.get_res();
+    std::vector<int> add(numrows, -1);
+
+    make_room (numrows, rowptr[numrows]-base + count);
+    for (k = 0; k < count; k++) add[rows[k]] = k;
+
+    // Each row is moved up by the number of entries added to it and
+    // the rows before it, from the last row down, so that nothing is
+    // overwritten before it is moved.  The new entry goes in after the
+    // last entry in a column before j.
+    j++;
+    for (r = numrows-1; r >= 0; r--) {
+      b = rowptr[r]-1;
+      e = rowptr[r+1]-1;
+      rowptr[r+1] += s;
+      a = add[r];
+      for (k = e-1; k >= b; k--) {
+	c = col_index[k];
+	if (c >= j) c++;
+	if (a != -1 && c < j) {
+	  put (k+s, j, vals[a], res);
+	  s--;
+	  a = -1;
+	}
+	col_index[k+s] = c;
+	if (values) values[k+s] = values[k];
+	if (floating) fvalues[k+s] = fvalues[k];
+      }
+      if (a != -1) {
+	put (b+s-1, j, vals[a], res);
+	s--;
+      }
+    }
+    num_non_zeros += count;
+    shape.set_nnz(num_non_zeros);
+  }
+
+  /**
+   * Remove a row, and its entries.  The rows after it are renumbered
+   * down by one.  Goes with AuctAssoc::remove_row.  The shape number
+   * of non-zeros is set here.
+   * @param shape Auction "shape"
+   * @param i Row to remove, from 0 as in the shape
+   */
+  void remove_row (AuctShape& shape, int i) {
+    make_room (numrows, rowptr[numrows]-base);
+    int b = rowptr[i]-1, e = rowptr[i+1]-1, end = rowptr[numrows]-1;
+    std::copy (col_index+e, col_index+end, col_index+b);
+    if (values) std::copy (values+e, values+end, values+b);
+    if (floating) std::copy (fvalues+e, fvalues+end, fvalues+b);
+    for (int r = i; r < numrows; r++) rowptr[r] = rowptr[r+1] - (e-b);
+    numrows--;
+    num_non_zeros -= e-b;
+    shape.set_nnz(num_non_zeros);
+  }
+
+  /**
+   * Remove a column, and its entries.  The columns after it are
+   * renumbered down by one.  Goes with AuctAssoc::remove_col.  The
+   * shape number of non-zeros is set here.
+   * @param shape Auction "shape"
+   * @param j Column to remove, from 0 as in the shape
+   */
+  void remove_col (AuctShape& shape, int j) {
+    int r, k, c, w = 0, b = 0, e;
+    make_room (numrows, rowptr[numrows]-base);
+    int end = rowptr[numrows]-1;
+    j++;
+    for (r = 0; r < numrows; r++, b = e) {
+      e = rowptr[r+1]-1;
+      for (k = b; k < e; k++) {
+	c = col_index[k];
+	if (c == j) continue;
+	col_index[w] = (c > j) ? c-1 : c;
+	if (values) values[w] = values[k];
+	if (floating) fvalues[w] = fvalues[k];
+	w++;
+      }
+      rowptr[r+1] = w+1;
+    }
+    num_non_zeros -= end - w;
+    shape.set_nnz(num_non_zeros);
+  }
+
   /** 
    * Accessor to flag indicating whether sparsification was necessary.
    * @return True if sparsification was done, false otherwise
@@ -175,6 +510,12 @@ class AuctPay {
    */
   inline int* get_valpt() {return values;}
 
+  /** 
+   * Accessor to internal floating point value array
+   * @return pointer to the floating point value array (NULL if not kept)
+   */
+  inline double* get_fvalpt() {return fvalues;}
+
   /** 
    * Accessor to column indicies associated with each element
    * @return pointer to the column index array
@@ -187,6 +528,139 @@ class AuctPay {
    */
   inline int* get_rowpt() {return rowptr;}
 
+  /** 
+   * Accessor to the index of the first entry and column
+   * @return 1, or 0 for a view of zero based arrays
+   */
+  inline int get_base() {return base;}
+
+  /**
+   * Use int values in place, scaling them into a private array if the
+   * resolution is not 1.
+   * @param vals Value of each entry
+   * @param res Discretization resolution of the payoff
+   */
+  void view_values (int* vals, double res) {
+    int i;
+    if (res == 1) {
+      values = vals;
+    } else {
+      values = new int [num_non_zeros];
+      ownval = true;
+      for (i = 0; i < num_non_zeros; i++) values[i] = (int)(vals[i]/res);
+    }
+    if (floating) {
+      fvalues = new double [num_non_zeros];
+      ownfval = true;
+      std::copy (vals, vals+num_non_zeros, fvalues);
+    }
+  }
+
+  /**
+   * Use floating point values in place for the floating point auction,
+   * or else scale and cast them into a private array.
+   * @param vals Value of each entry
+   * @param res Discretization resolution of the payoff
+   */
+  void view_values (double* vals, double res) {
+    int i;
+    if (floating) {
+      fvalues = vals;
+      return;
+    }
+    values = new int [num_non_zeros];
+    ownval = true;
+    for (i = 0; i < num_non_zeros; i++) values[i] = (int)(vals[i]/res);
+  }
+
+  /**
+   * Make sure the arrays are owned, index from 1, and can hold a given
+   * number of rows and non-zeros, keeping the entries.  They grow to
+   * at least twice their old size, so that repeated additions are
+   * cheap.
+   * @param nrows Number of rows
+   * @param nnz Number of non-zero entries
+   */
+  void make_room (int nrows, int nnz) {
+    int i, used = rowptr[numrows] - base;
+    bool intvals = values || !floating;  // (an empty view may have none)
+    if (base == 1 && ownind && ownrow && (ownval || !intvals) &&
+	(ownfval || !fvalues) && nnz <= valcap && nrows+1 <= rowcap &&
+	(!fvalues || nnz <= fvalcap))
+      return;
+    int vcap = std::max(nnz, 2*valcap), rcap = std::max(nrows+1, 2*rowcap);
+    int *ind = new int [vcap], *row = new int [rcap];
+    for (i = 0; i < used; i++) ind[i] = col_index[i] + 1 - base;
+    for (i = 0; i <= numrows; i++) row[i] = rowptr[i] + 1 - base;
+    if (intvals) {
+      int *v = new int [vcap];
+      std::copy (values, values+used, v);
+      if (ownval) delete [] values;
+      values = v;
+      ownval = true;
+    }
+    if (fvalues) {
+      double *f = new double [vcap];
+      std::copy (fvalues, fvalues+used, f);
+      if (ownfval) delete [] fvalues;
+      fvalues = f;
+      ownfval = true;
+      fvalcap = vcap;
+    }
+    if (ownind) delete [] col_index;
+    if (ownrow) delete [] rowptr;
+    col_index = ind;
+    rowptr = row;
+    valcap = vcap;
+    rowcap = rcap;
+    ownind = ownrow = true;
+    base = 1;
+  }
+
+  /**
+   * Write an entry, scaling the value as the constructors do.
+   * @param k Linear index of the entry
+   * @param col Column of the entry, from 1
+   * @param v Value of the entry
+   * @param res Discretization resolution of the payoff
+   */
+  template <class T>
+  void put (int k, int col, T v, double res) {
+    col_index[k] = col;
+    if (values) values[k] = (int)(v/res);
+    if (floating) fvalues[k] = (double)v;
+  }
+
+  /** 
+   * Make sure the internal arrays hold a given number of rows and
+   * non-zeros, reallocating them only if they are too small.
+   * @param nrows Number of rows
+   * @param nnz Number of non-zero entries
+   */
+  void reserve (int nrows, int nnz) {
+    if (nnz > valcap) {
+      if (ownval) delete [] values;
+      if (ownind) delete [] col_index;
+      values    = new int [nnz];
+      col_index = new int [nnz];
+      valcap    = nnz;
+      ownval = ownind = true;
+    }
+    if (floating && nnz > fvalcap) {
+      if (ownfval) delete [] fvalues;
+      fvalues = new double [nnz];
+      fvalcap = nnz;
+      ownfval = true;
+    }
+    if (nrows+1 > rowcap) {
+      if (ownrow) delete [] rowptr;
+      rowptr = new int [nrows+1];
+      rowcap = nrows+1;
+      ownrow = true;
+    }
+    base = 1;
+  }
+
 
   // ------------------------------------------------------------------
   //
@@ -230,11 +704,23 @@ class AuctPay {
  private:
 
   int *values;     //!< Array of values in sparse matrix
+  double *fvalues; //!< Array of unscaled values, if floating (else NULL)
   int *col_index;  //!< Array of columns (corrsp. to values) in sparse matrix
   int *rowptr;     //!< Array of pointers to values associated w/ each row
   int numrows;     //!< Total number of rows
   int num_non_zeros; //!< Number of non-zero entries
   bool sparsified; //!< Boolean flag indicating whether input matrix was dense.
+  bool floating;   //!< Are the unscaled floating point values kept?
+  int valcap;      //!< Allocated length of values and col_index
+  int rowcap;      //!< Allocated length of rowptr
+  int fvalcap;     //!< Allocated length of fvalues
+  int base;        //!< Index of the first entry and column (1, or 0 in a view)
+  bool ownval;     //!< Is values owned (not a view of the caller's)?
+  bool ownfval;    //!< Is fvalues owned?
+  bool ownind;     //!< Is col_index owned?
+  bool ownrow;     //!< Is rowptr owned?
+
+  AuctPay& operator= (const AuctPay&); //!< Not implemented
 
 };
 
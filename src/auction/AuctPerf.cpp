@@ -0,0 +1,120 @@
+#include <cstring>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "AuctPerf.h"
+
+// Each counter is opened on its own rather than as a group, so that
+// the ones the processor lacks are simply left out, and so that it can
+// be inherited by the threads of the sharded auction.  The kernel
+// multiplexes them when there are more than the processor has room
+// for; read() scales them back up.
+AuctPerf::AuctPerf () {
+  for (int c = 0; c < NCOUNTERS; c++) {
+    fd[c] = -1;
+    last[c] = -1;
+  }
+#ifdef __linux__
+  static const unsigned int type[NCOUNTERS] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+    PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE };
+  static const unsigned long long config[NCOUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_BRANCH_MISSES };
+  struct perf_event_attr attr;
+
+  for (int c = 0; c < NCOUNTERS; c++) {
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type[c];
+    attr.config = config[c];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+      | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fd[c] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+#endif
+  mark();
+}
+
+AuctPerf::~AuctPerf () {
+  for (int c = 0; c < NCOUNTERS; c++) if (fd[c] >= 0) close(fd[c]);
+}
+
+int AuctPerf::nsupported () {
+  int n = 0;
+  for (int c = 0; c < NCOUNTERS; c++) if (fd[c] >= 0) n++;
+  return n;
+}
+
+const char* AuctPerf::name (int c) {
+  static const char* names[NCOUNTERS] = {
+    "cycles", "instructions", "cache misses", "L1D misses",
+    "branch misses" };
+  return (c >= 0 && c < NCOUNTERS) ? names[c] : "unknown";
+}
+
+double AuctPerf::ipc (const Sample& s) {
+  if (s.count[CYCLES] <= 0 || s.count[INSTRUCTIONS] < 0) return -1;
+  return s.count[INSTRUCTIONS] / s.count[CYCLES];
+}
+
+double AuctPerf::bandwidth (const Sample& s) {
+  if (s.count[CACHE_MISSES] < 0 || s.seconds <= 0) return -1;
+  return LINE * s.count[CACHE_MISSES] / s.seconds;
+}
+
+void AuctPerf::read (double* v) {
+  unsigned long long buf[3];  // value, time enabled, time running
+
+  for (int c = 0; c < NCOUNTERS; c++) {
+    v[c] = -1;
+    if (fd[c] < 0) continue;
+    if (::read(fd[c], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) continue;
+    v[c] = (buf[2] > 0) ? (double)buf[0] * buf[1] / buf[2] : 0;
+  }
+}
+
+void AuctPerf::mark () {
+  AuctPerf::read(last);
+  lasttime = std::chrono::steady_clock::now();
+}
+
+void AuctPerf::lap (const std::string& name) {
+  Sample s;
+  double now[NCOUNTERS];
+  std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+
+  AuctPerf::read(now);
+  s.name = name;
+  s.seconds = std::chrono::duration<double>(t - lasttime).count();
+  for (int c = 0; c < NCOUNTERS; c++)
+    s.count[c] = (now[c] >= 0 && last[c] >= 0) ? now[c] - last[c] : -1;
+  samples.push_back(s);
+  for (int c = 0; c < NCOUNTERS; c++) last[c] = now[c];
+  lasttime = t;
+}
+
+void AuctPerf::print (std::ostream& os, const Sample& s) {
+  bool any = false;
+
+  if (AuctPerf::ipc(s) >= 0) {
+    os << "IPC " << AuctPerf::ipc(s);
+    any = true;
+  }
+  for (int c = CACHE_MISSES; c < NCOUNTERS; c++) {
+    if (s.count[c] < 0) continue;
+    os << (any ? ", " : "") << name(c) << " " << s.count[c];
+    any = true;
+  }
+  if (AuctPerf::bandwidth(s) >= 0)
+    os << ", ~" << AuctPerf::bandwidth(s) / 1e6 << " MB/s";
+  if (!any) os << "no hardware counters";
+}
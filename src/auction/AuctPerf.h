@@ -0,0 +1,185 @@
+
+
+#ifndef AuctPerf_H
+#define AuctPerf_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+class AuctPerf {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Hardware counters read, where the processor and kernel have them. <p>
+   * CYCLES: processor cycles <br>
+   * INSTRUCTIONS: instructions retired <br>
+   * CACHE_MISSES: last level cache misses (each a line from memory) <br>
+   * L1D_MISSES: level 1 data cache read misses <br>
+   * BRANCH_MISSES: mispredicted branches
+   */
+  enum Counter { CYCLES, INSTRUCTIONS, CACHE_MISSES, L1D_MISSES,
+		 BRANCH_MISSES, NCOUNTERS };
+
+  /**
+   * Bytes brought from memory by each last level cache miss, for the
+   * estimate of memory bandwidth.
+   */
+  enum { LINE = 64 };
+
+  /**
+   * The counts of one phase. <p>
+   * std::string name;          // phase <br>
+   * double seconds;            // wall time of the phase <br>
+   * double count[NCOUNTERS];   // counts, or -1 where not supported
+   */
+  typedef struct Sample {
+    std::string name;          // phase
+    double seconds;            // wall time of the phase
+    double count[NCOUNTERS];   // counts, or -1 where not supported
+  } Sample;
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  Opens the counters (with perf_event_open) for this
+   * thread and the threads it starts from now on.  A counter which the
+   * processor, the kernel or its perf_event_paranoid setting does not
+   * allow is left out, and reads as -1.
+   */
+  AuctPerf ();
+
+  /**
+   * Destructor.  Closes the counters.
+   */
+  ~AuctPerf ();
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Is a counter read?
+   * @param c A Counter
+   * @return True if the counter was opened
+   */
+  bool supported (int c) { return fd[c] >= 0; }
+
+  /**
+   * Accesses the number of counters read
+   * @return Counters opened
+   */
+  int nsupported ();
+
+  /**
+   * Accesses the name of a counter
+   * @param c A Counter
+   * @return Name of the counter
+   */
+  static const char* name (int c);
+
+  /**
+   * Accesses number of phases recorded
+   * @return Number of samples
+   */
+  int nsamples () { return samples.size(); }
+
+  /**
+   * Accesses the counts of a phase
+   * @param i Phase, in the order recorded
+   * @return Its sample
+   */
+  Sample& sample (int i) { return samples[i]; }
+
+  /**
+   * Instructions per cycle of a phase
+   * @param s Sample
+   * @return IPC, or -1 if not known
+   */
+  static double ipc (const Sample& s);
+
+  /**
+   * Memory bandwidth of a phase, estimated from its last level cache
+   * misses (LINE bytes each; prefetches and write backs are not seen)
+   * @param s Sample
+   * @return Bytes per second, or -1 if not known
+   */
+  static double bandwidth (const Sample& s);
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Start a phase: the next sample counts from now.
+   */
+  void mark ();
+
+  /**
+   * End a phase, recording the counts since the last mark or lap, and
+   * start the next.
+   * @param name Name of the phase
+   */
+  void lap (const std::string& name);
+
+  /**
+   * Forget the samples recorded.
+   */
+  void clear () { samples.clear(); }
+
+  /**
+   * Print a sample on one line: IPC, the counts which are supported, and
+   * the estimated memory bandwidth.
+   * @param os Stream to print to
+   * @param s Sample
+   */
+  void print (std::ostream& os, const Sample& s);
+
+ private:
+
+  /**
+   * Read the counters, scaled up for the time they were multiplexed out.
+   * @param v Counts (NCOUNTERS long; -1 where not supported)
+   */
+  void read (double* v);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int fd[NCOUNTERS];          //!< Counter file descriptors, or -1
+  double last[NCOUNTERS];     //!< Counts at the last mark or lap
+  std::chrono::steady_clock::time_point lasttime;  //!< Time of last mark
+  std::vector<Sample> samples;  //!< Phases recorded, in order
+
+};
+
+#endif
@@ -0,0 +1,282 @@
+
+
+#ifndef AuctReorder_H
+#define AuctReorder_H
+
+#include <vector>
+#include <algorithm>
+#include "AuctCSR.h"
+#include "AuctAssoc.h"
+#include "AuctWorkspace.h"
+
+class AuctReorder {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  The identity order until built.
+   */
+  AuctReorder () {
+    nr = nc = 0;
+    rownew = rowat = colnew = colat = 0;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the new position of a row
+   * @param i Row, in the payoff's order
+   * @return Row in the reordered payoff
+   */
+  inline int row (int i) { return rownew[i]; }
+
+  /**
+   * Accesses the new position of a column
+   * @param j Column, in the payoff's order
+   * @return Column in the reordered payoff
+   */
+  inline int col (int j) { return colnew[j]; }
+
+  /**
+   * The locality of a payoff: the average over its non-empty rows of
+   * the span of their columns (from the first to the last, inclusive).
+   * It is the stretch of the price array a row's bids read.
+   * @param A Payoff
+   * @return Average column span of a row (0 if the payoff is empty)
+   */
+  static double span (AuctCSR<int>& A) {
+    double sum = 0;
+    int i, k, rows = 0;
+    for (i = 0; i < A.nrows(); i++) {
+      AuctCSR<int>::Row r = A.row(i);
+      if (r.size == 0) continue;
+      int lo = r.col[0], hi = r.col[0];
+      for (k = 1; k < r.size; k++) {
+	lo = std:: min(lo, r.col[k]);
+	hi = std:: max(hi, r.col[k]);
+      }
+      sum += hi - lo + 1;
+      rows++;
+    }
+    return rows ? sum / rows : 0;
+  }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Reorder a payoff into the workspace by reverse Cuthill-McKee on its
+   * rows and columns together.  The rows are numbered breadth first
+   * through the columns they share, lightest first, and each column as
+   * the first row which has it is numbered; both orders are then
+   * reversed.  The rows which bid on a column, and the columns a row
+   * bids on, end up close together, and so do their prices.
+   * @param A Payoff
+   * @param W Workspace which holds the reordered payoff
+   * @return Reordered payoff (each row's columns in order)
+   */
+  AuctCSR<int> build (AuctCSR<int>& A, AuctWorkspace& W) {
+    int i, j, k, r, head, nrow, ncol, start, nnz = A.nnz();
+
+    nr = A.nrows();
+    nc = A.ncols();
+    rownew = W.reserve(AuctWorkspace::ORDROW, nr);
+    rowat = W.reserve(AuctWorkspace::ORDROWAT, nr);
+    colnew = W.reserve(AuctWorkspace::ORDCOL, nc);
+    colat = W.reserve(AuctWorkspace::ORDCOLAT, nc);
+    int *cptr = W.reserve(AuctWorkspace::ORDCPTR, nc+1);
+    int *crow = W.reserve(AuctWorkspace::ORDCROW, nnz+1);
+    int *ptr = A.rowptr(), *ind = A.colind();
+
+    // The rows of each column, to go from a column to its rows.
+    std::fill(cptr, cptr+nc+1, 0);
+    for (k = 0; k < nnz; k++) cptr[ind[k]+1]++;
+    for (j = 0; j < nc; j++) cptr[j+1] += cptr[j];
+    for (j = 0; j < nc; j++) colnew[j] = cptr[j];
+    for (i = 0; i < nr; i++)
+      for (k = ptr[i]; k < ptr[i+1]; k++) crow[colnew[ind[k]]++] = i;
+
+    // Breadth first from the lightest row not yet reached, in turn, so
+    // that each connected part of the payoff is numbered on its own.
+    int *light = W.reserve(AuctWorkspace::SCRATCH, nr);
+    for (i = 0; i < nr; i++) light[i] = i;
+    std::stable_sort(light, light+nr, RowDegree(ptr));
+    std::fill(rownew, rownew+nr, -1);
+    std::fill(colnew, colnew+nc, -1);
+    nrow = ncol = 0;
+    for (start = 0; nrow < nr; start++) {
+      r = light[start];
+      if (rownew[r] != -1) continue;
+      rownew[r] = nrow;
+      rowat[nrow++] = r;
+      for (head = nrow-1; head < nrow; head++) {
+	r = rowat[head];
+	int first = ncol;
+	for (k = ptr[r]; k < ptr[r+1]; k++) {
+	  if (colnew[ind[k]] != -1) continue;
+	  colnew[ind[k]] = ncol;
+	  colat[ncol++] = ind[k];
+	}
+	std::sort(colat+first, colat+ncol, ColDegree(cptr));
+	for (j = first; j < ncol; j++) {
+	  colnew[colat[j]] = j;
+	  int firstrow = nrow;
+	  for (k = cptr[colat[j]]; k < cptr[colat[j]+1]; k++) {
+	    if (rownew[crow[k]] != -1) continue;
+	    rownew[crow[k]] = nrow;
+	    rowat[nrow++] = crow[k];
+	  }
+	  std::sort(rowat+firstrow, rowat+nrow, RowDegree(ptr));
+	}
+      }
+    }
+    for (j = 0; j < nc; j++)
+      if (colnew[j] == -1) colat[ncol++] = j;
+
+    // Reverse both orders.
+    std::reverse(rowat, rowat+nr);
+    std::reverse(colat, colat+nc);
+    for (i = 0; i < nr; i++) rownew[rowat[i]] = i;
+    for (j = 0; j < nc; j++) colnew[colat[j]] = j;
+
+    // The payoff in the new order.
+    int *optr = W.reserve(AuctWorkspace::ORDPTR, nr+1);
+    int *oind = W.reserve(AuctWorkspace::ORDIND, nnz+1);
+    int *oval = W.reserve(AuctWorkspace::ORDVAL, nnz+1);
+    int *val = A.values();
+    optr[0] = 0;
+    for (i = 0; i < nr; i++) {
+      r = rowat[i];
+      optr[i+1] = optr[i] + ptr[r+1] - ptr[r];
+      for (k = ptr[r], j = optr[i]; k < ptr[r+1]; k++, j++) {
+	oind[j] = colnew[ind[k]];
+	oval[j] = val[k];
+      }
+      AuctReorder::sort_row(oind+optr[i], oval+optr[i], optr[i+1]-optr[i]);
+    }
+    return AuctCSR<int> (nr, nc, optr, oind, oval);
+  }
+
+  /**
+   * Carry an association matrix (its assignment, prices and profits)
+   * into the new order.
+   * @param S Association matrix, in the payoff's order
+   * @param W Workspace, for the copies
+   */
+  void apply (AuctAssoc& S, AuctWorkspace& W) {
+    AuctReorder::move(S, W, rownew, colnew);
+  }
+
+  /**
+   * Carry an association matrix back from the new order.
+   * @param S Association matrix, in the new order
+   * @param W Workspace, for the copies
+   */
+  void undo (AuctAssoc& S, AuctWorkspace& W) {
+    AuctReorder::move(S, W, rowat, colat);
+  }
+
+ private:
+
+  /**
+   * Orders columns by the number of rows which have them.
+   */
+  struct ColDegree {
+    int *cptr;
+    ColDegree (int* p) { cptr = p; }
+    bool operator() (int a, int b) const {
+      return cptr[a+1]-cptr[a] < cptr[b+1]-cptr[b];
+    }
+  };
+
+  /**
+   * Orders rows by the number of columns they have.
+   */
+  struct RowDegree {
+    int *ptr;
+    RowDegree (int* p) { ptr = p; }
+    bool operator() (int a, int b) const {
+      return ptr[a+1]-ptr[a] < ptr[b+1]-ptr[b];
+    }
+  };
+
+  /**
+   * Sort a row's entries by column.
+   * @param ind Columns of the row
+   * @param val Values of the row
+   * @param n Number of entries
+   */
+  void sort_row (int* ind, int* val, int n) {
+    int k;
+    pairs.resize(n);
+    for (k = 0; k < n; k++) pairs[k] = std::make_pair(ind[k], val[k]);
+    std::sort(pairs.begin(), pairs.end());
+    for (k = 0; k < n; k++) {
+      ind[k] = pairs[k].first;
+      val[k] = pairs[k].second;
+    }
+  }
+
+  /**
+   * Renumber the rows and columns of an association matrix.
+   * @param S Association matrix
+   * @param W Workspace, for the copies
+   * @param rmap New number of each row
+   * @param cmap New number of each column
+   */
+  void move (AuctAssoc& S, AuctWorkspace& W, int* rmap, int* cmap) {
+    int *cols = W.reserve(AuctWorkspace::ORDCPTR, std:: max(nr, nc));
+    int *vals = W.reserve(AuctWorkspace::ORDCROW, std:: max(nr, nc));
+    int i, j;
+
+    S.get_columns(cols);
+    S.blank();
+    for (i = 0; i < nr; i++)
+      if (cols[i] != -1) S.add(rmap[i], cmap[cols[i]]);
+
+    S.get_prices(cols);
+    for (j = 0; j < nc; j++) vals[cmap[j]] = cols[j];
+    S.set_prices(vals);
+    S.get_profits(cols);
+    for (i = 0; i < nr; i++) vals[rmap[i]] = cols[i];
+    S.set_profits(vals);
+  }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int nr;        //!< Number of rows
+  int nc;        //!< Number of columns
+  int *rownew;   //!< New number of each row (workspace owned)
+  int *rowat;    //!< Row at each new number (workspace owned)
+  int *colnew;   //!< New number of each column (workspace owned)
+  int *colat;    //!< Column at each new number (workspace owned)
+  std::vector<std::pair<int,int> > pairs;  //!< Sorting space for a row
+
+};
+
+#endif
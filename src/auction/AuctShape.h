@@ -4,6 +4,7 @@
 #define AuctShape_H
 
 #include<vector>
+#include<algorithm>
 
 class AuctShape {
 
@@ -22,17 +23,9 @@ class AuctShape {
    * @param num_non_zero Number of Non-zero elements in the payoff matrix
    */
   AuctShape (int nrows, int mcols, int num_non_zero) {
-    n = nrows;
-    m = mcols;
-    Nnz = num_non_zero;
-    rowmult = new int [n];
-    colmult = new int [m];
-    rowptr = new int[n+1];
-    colptr = new int[m+1];
-    int i;
-    for (i = 0; i < n; i++) rowmult[i] = 1;
-    for (i = 0; i < m; i++) colmult[i] = 1;
-    computemaps();
+    rowmult = colmult = rowptr = colptr = 0;
+    rowcap = colcap = 0;
+    reshape (nrows, mcols, num_non_zero);
   };
 
 
@@ -44,21 +37,32 @@ class AuctShape {
    */
   template <class T> 
   AuctShape (std::vector<std::vector<T> > &Vpay) {
-    Nnz = 0; // needs to be set later, probably in the AssocPay constructor
-    n = Vpay.size();
-    m = 0;
-	int i=0;
-    for (i = 0; i < n; i++) {
-      if (Vpay[i].size() > (unsigned int)m) m = Vpay[i].size();
-    }
+    rowmult = colmult = rowptr = colptr = 0;
+    rowcap = colcap = 0;
+    reshape (Vpay);
+  };
 
-    rowmult = new int [n];
-    colmult = new int [m];
-    rowptr = new int[n+1];
-    colptr = new int[m+1];
-    for (i = 0; i < n; i++) rowmult[i] = 1;
-    for (i = 0; i < m; i++) colmult[i] = 1;
-    computemaps();
+  /** 
+   * Copy constructor.
+   * @param x Shape to copy
+   */
+  AuctShape (const AuctShape& x) {
+    n = x.n;
+    m = x.m;
+    Nnz = x.Nnz;
+    compute_flag = x.compute_flag;
+    rowmap = x.rowmap;
+    colmap = x.colmap;
+    rowcap = n+1;
+    colcap = m+1;
+    rowmult = new int [rowcap];
+    colmult = new int [colcap];
+    rowptr  = new int [rowcap];
+    colptr  = new int [colcap];
+    std::copy (x.rowmult, x.rowmult+n, rowmult);
+    std::copy (x.colmult, x.colmult+m, colmult);
+    std::copy (x.rowptr, x.rowptr+n+1, rowptr);
+    std::copy (x.colptr, x.colptr+m+1, colptr);
   };
 
   /**
@@ -221,6 +225,49 @@ class AuctShape {
   //
   // ------------------------------------------------------------------
 
+  /** 
+   * Reset to a given size, with single associations.  The internal
+   * arrays are reused, and only reallocated if they are too small.
+   * @param nrows Number of Rows in the payoff matrix
+   * @param mcols Number of Columns in the payoff matrix
+   * @param num_non_zero Number of Non-zero elements in the payoff matrix
+   */
+  void reshape (int nrows, int mcols, int num_non_zero) {
+    n = nrows;
+    m = mcols;
+    Nnz = num_non_zero;
+    if (n+1 > rowcap) {
+      delete [] rowmult;  delete [] rowptr;
+      rowmult = new int [n+1];
+      rowptr  = new int [n+1];
+      rowcap  = n+1;
+    }
+    if (m+1 > colcap) {
+      delete [] colmult;  delete [] colptr;
+      colmult = new int [m+1];
+      colptr  = new int [m+1];
+      colcap  = m+1;
+    }
+    int i;
+    for (i = 0; i < n; i++) rowmult[i] = 1;
+    for (i = 0; i < m; i++) colmult[i] = 1;
+    computemaps();
+  }
+
+  /** 
+   * Reset to the size of a vector of vectors, as in the constructor.
+   * @param Vpay An STL vector of vectors from which to extract the payoff. 
+   */
+  template <class T> 
+  void reshape (std::vector<std::vector<T> > &Vpay) {
+    int nrows = Vpay.size(), mcols = 0;
+    for (int i = 0; i < nrows; i++) {
+      if (Vpay[i].size() > (unsigned int)mcols) mcols = Vpay[i].size();
+    }
+    // Nnz needs to be set later, probably in the AssocPay constructor
+    reshape (nrows, mcols, 0);
+  }
+
   /**
    * Reset all the rows to have a single association.
    */
@@ -282,6 +329,57 @@ class AuctShape {
     else if (compute_flag == 2) computemult();
   }
 
+  /**
+   * Add a row after the last one.  The other rows and columns keep
+   * their numbers and multiplicities, and storage grows by doubling,
+   * so that rows may be added one at a time.  The number of non-zeros
+   * is left to the payoff (see AuctPay::add_row).
+   * @param mult Number of associations to the new row
+   * @return Index of the new row
+   */
+  int add_row (int mult = 1) {
+    ifcompute();
+    if (n+2 > rowcap) regrow (rowmult, rowptr, rowcap, n, n+2);
+    rowmult[n] = mult;
+    compute_flag = 1;
+    return n++;
+  }
+
+  /**
+   * Add a column after the last one, as add_row.
+   * @param mult Number of associations to the new column
+   * @return Index of the new column
+   */
+  int add_col (int mult = 1) {
+    ifcompute();
+    if (m+2 > colcap) regrow (colmult, colptr, colcap, m, m+2);
+    colmult[m] = mult;
+    compute_flag = 1;
+    return m++;
+  }
+
+  /**
+   * Remove a row.  The rows after it are renumbered down by one.
+   * @param i Row to remove
+   */
+  void remove_row (int i) {
+    ifcompute();
+    std::copy (rowmult+i+1, rowmult+n, rowmult+i);
+    n--;
+    compute_flag = 1;
+  }
+
+  /**
+   * Remove a column, as remove_row.
+   * @param i Column to remove
+   */
+  void remove_col (int i) {
+    ifcompute();
+    std::copy (colmult+i+1, colmult+m, colmult+i);
+    m--;
+    compute_flag = 1;
+  }
+
   /** 
    * Transpose. 
    */
@@ -291,6 +389,7 @@ class AuctShape {
     std::swap (n,m);
     temp = rowmult;  rowmult = colmult;  colmult = temp;
     temp = rowptr;  rowptr = colptr;  colptr = temp;
+    std::swap (rowcap, colcap);
     rowmap.swap(colmap);
   }
 
@@ -316,6 +415,30 @@ class AuctShape {
   int *colmult; //!< Array of col multiples (i.e. number of associations)
   int *rowptr;  //!< Array of row pointers, index to first association given row
   int *colptr;  //!< Array of col multiples, index to first association given col
+  int rowcap;   //!< Allocated length of the row arrays
+  int colcap;   //!< Allocated length of the column arrays
+
+  AuctShape& operator= (const AuctShape&); //!< Not implemented
+
+  /**
+   * Reallocate a pair of row (or column) arrays to at least size
+   * entries, and at least twice their old length, keeping the used
+   * entries.
+   * @param mult Multiplicity array
+   * @param ptr Pointer array
+   * @param cap Allocated length of both, updated
+   * @param used Number of multiplicities to keep
+   * @param size Number of entries needed
+   */
+  static void regrow (int*& mult, int*& ptr, int& cap, int used, int size) {
+    cap = std::max(size, 2*cap);
+    int *nmult = new int [cap], *nptr = new int [cap];
+    std::copy (mult, mult+used, nmult);
+    std::copy (ptr, ptr+used+1, nptr);
+    delete [] mult;  delete [] ptr;
+    mult = nmult;
+    ptr = nptr;
+  }
 
 };
 
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include "AuctShard.h"
+
+void AuctShard::load (int first, int last, int* ptr, int* ind, int* val) {
+  int n = last - first, nnz = ptr[last] - ptr[first];
+  int *sptr, *sind, *sval, i;
+
+  lo = first;
+  hi = last;
+  sptr = ws.reserve(AuctWorkspace::PAYPTR, n+1);
+  sind = ws.reserve(AuctWorkspace::PAYIND, nnz);
+  sval = ws.reserve(AuctWorkspace::PAYVAL, nnz);
+  ws.reserve(AuctWorkspace::BIDOBJ, n);
+  for (i = 0; i <= n; i++) sptr[i] = ptr[first+i] - ptr[first];
+  std::copy (ind+ptr[first], ind+ptr[last], sind);
+  std::copy (val+ptr[first], val+ptr[last], sval);
+  reset();
+}
+
+void AuctShard::reset () {
+  std::fill (ws.get(AuctWorkspace::BIDOBJ),
+	     ws.get(AuctWorkspace::BIDOBJ) + (hi-lo), -1);
+}
+
+// The price of the best object is checked and raised in one step, so
+// that two shards cannot both win it.  The other prices read may be
+// out of date, but as prices only rise, that can only make the bid
+// smaller, and e-CS still holds once it is placed.
+void AuctShard::bid (PackedPrice* price, int epsilon, int neglarge) {
+  int *ptr = ws.get(AuctWorkspace::PAYPTR);
+  int *ind = ws.get(AuctWorkspace::PAYIND);
+  int *val = ws.get(AuctWorkspace::PAYVAL);
+  int *bidobj = ws.get(AuctWorkspace::BIDOBJ);
+  int b, k, j, v, bestj, nextj, bestv, nextv;
+  unsigned long long pv, bestpv = 0;
+
+  for (b = 0; b < hi - lo; b++) {
+    if (bidobj[b] != -1) continue;
+    for (;;) {
+      bestj = nextj = -1;
+      bestv = nextv = neglarge;
+      for (k = ptr[b]; k < ptr[b+1]; k++) {
+	j = ind[k];
+	pv = price[j].load(std::memory_order_relaxed);
+	v = val[k] - price_of(pv);
+	if (bestj == -1 || v > bestv) {
+	  nextj = bestj;  nextv = bestv;
+	  bestj = j;      bestv = v;     bestpv = pv;
+	} else if (nextj == -1 || v > nextv) {
+	  nextj = j;      nextv = v;
+	}
+      }
+      if (bestj == -1) break;   // empty row
+
+      if (price[bestj].compare_exchange_strong
+	  (bestpv, pack(price_of(bestpv) + std::max(bestv - nextv, 0) + epsilon,
+			lo + b), std::memory_order_relaxed)) {
+	bidobj[b] = bestj;
+	break;
+      }
+    }
+  }
+}
+
+int AuctShard::check (PackedPrice* price) {
+  int *bidobj = ws.get(AuctWorkspace::BIDOBJ);
+  int b, nassoc = 0;
+
+  for (b = 0; b < hi - lo; b++) {
+    if (bidobj[b] == -1) continue;
+    if (bidder_of(price[bidobj[b]].load(std::memory_order_relaxed)) != lo + b)
+      bidobj[b] = -1;
+    else
+      nassoc++;
+  }
+  return nassoc;
+}
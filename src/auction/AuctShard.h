@@ -0,0 +1,144 @@
+
+
+#ifndef AuctShard_H
+#define AuctShard_H
+
+#include <atomic>
+#include "AuctWorkspace.h"
+
+class AuctShard {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * The price of an object and the bidder it is associated with,
+   * packed into one word so that both change together.  Prices are in
+   * the high half, and the bidder (+1, so that 0 is none) in the low.
+   */
+  typedef std::atomic<unsigned long long> PackedPrice;
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  The shard is empty until loaded.
+   */
+  AuctShard () { lo = hi = 0; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Pack a price and a bidder.
+   * @param price Object price
+   * @param bidder Bidder associated with the object (-1 if none)
+   * @return Packed value
+   */
+  static inline unsigned long long pack (int price, int bidder) {
+    return ((unsigned long long)(unsigned int)price << 32) |
+      (unsigned int)(bidder + 1);
+  }
+
+  /**
+   * Unpack a price.
+   * @param v Packed value
+   * @return Object price
+   */
+  static inline int price_of (unsigned long long v) {
+    return (int)(unsigned int)(v >> 32);
+  }
+
+  /**
+   * Unpack a bidder.
+   * @param v Packed value
+   * @return Bidder associated with the object (-1 if none)
+   */
+  static inline int bidder_of (unsigned long long v) {
+    return (int)(unsigned int)(v & 0xffffffffULL) - 1;
+  }
+
+  /**
+   * Accesses the number of heap allocations made by the shard.
+   * @return Number of buffer allocations since construction
+   */
+  int nallocs () { return ws.nallocs(); }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Copy a range of bidders of the (zero based, compressed row)
+   * payoff into the shard.  This should be called by the thread which
+   * will bid for the shard, so that its storage is first touched, and
+   * therefore placed, on that thread's memory node.
+   * @param first First bidder (row) of the shard
+   * @param last One past the last bidder of the shard
+   * @param ptr Row pointers of the whole payoff
+   * @param ind Object (column) of each entry of the whole payoff
+   * @param val Value of each entry of the whole payoff
+   */
+  void load (int first, int last, int* ptr, int* ind, int* val);
+
+  /**
+   * Drop all the associations of the shard's bidders.
+   */
+  void reset ();
+
+  /**
+   * One Gauss-Seidel bidding cycle over the unassigned bidders of the
+   * shard, as AuctAlg::auct_cycle_SP1.  Prices are shared with the
+   * other shards, so a bid is only placed if the object's price has not
+   * changed since the bidder looked at it; otherwise the bidder looks
+   * again.  Bidders displaced by a bid are not told: see check().
+   * @param price Packed price and bidder of each object (updated)
+   * @param epsilon Bid increment
+   * @param neglarge Value of a missing second choice
+   */
+  void bid (PackedPrice* price, int epsilon, int neglarge);
+
+  /**
+   * Drop the associations of the bidders who have been outbid since
+   * they bid, by any shard.  Must not run while any shard is bidding.
+   * @param price Packed price and bidder of each object
+   * @return Number of the shard's bidders still associated
+   */
+  int check (PackedPrice* price);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int lo;            //!< First bidder of the shard
+  int hi;            //!< One past the last bidder of the shard
+  AuctWorkspace ws;  //!< Shard payoff and the object of each bidder
+
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include "AuctSocketTransport.h"
+
+AuctSocketTransport::AuctSocketTransport (int myrank,
+					  const std::vector<int>& peers) {
+  me = myrank;
+  broken = false;
+  lostrank = -1;
+  peer = peers;
+  peer[me] = -1;
+  for (unsigned int p = 0; p < peer.size(); p++)
+    if (peer[p] != -1) fcntl(peer[p], F_SETFL, fcntl(peer[p], F_GETFL) | O_NONBLOCK);
+}
+
+AuctSocketTransport::~AuctSocketTransport () {
+  for (unsigned int p = 0; p < peer.size(); p++)
+    if (peer[p] != -1) close(peer[p]);
+}
+
+// One socket pair is made for each pair of processes before forking.
+// Each process then closes all the ends which are not its own.  On
+// failure, the ends made so far are closed, keeping the errno.
+AuctSocketTransport* AuctSocketTransport::fork_local (int nprocs) {
+  int i, j, err, rank = 0, sv[2];
+  std::vector<std::vector<int> > fd(nprocs, std::vector<int>(nprocs, -1));
+  bool failed = false;
+
+  if (nprocs < 1) return 0;
+  for (i = 0; i < nprocs && !failed; i++) {
+    for (j = i+1; j < nprocs && !failed; j++) {
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+	failed = true;
+      } else {
+	fd[i][j] = sv[0];
+	fd[j][i] = sv[1];
+      }
+    }
+  }
+  for (i = 1; i < nprocs && !failed && rank == 0; i++) {
+    pid_t pid = fork();
+    if (pid < 0) failed = true;
+    else if (pid == 0) rank = i;
+  }
+  if (failed) {
+    // The children already forked lose this process, and fail.
+    err = errno;
+    for (i = 0; i < nprocs; i++)
+      for (j = 0; j < nprocs; j++) if (fd[i][j] != -1) close(fd[i][j]);
+    errno = err;
+    return 0;
+  }
+  for (i = 0; i < nprocs; i++)
+    if (i != rank)
+      for (j = 0; j < nprocs; j++) if (fd[i][j] != -1) close(fd[i][j]);
+  return new AuctSocketTransport(rank, fd[rank]);
+}
+
+// Each block goes out as its length, then its ints.  A process keeps
+// writing to and reading from all its peers until every block is
+// through, so no process waits on another which is itself blocked.
+bool AuctSocketTransport::allgather (const std::vector<int>& send,
+				     std::vector<std::vector<int> >& recv) {
+  int n = peer.size(), p, k;
+  int len = send.size();
+  std::vector<size_t> sent(n, 0), got(n, 0);
+  std::vector<int> rlen(n, 0);
+  std::vector<struct pollfd> fds;
+  std::vector<int> who;
+  size_t hdr = sizeof(int), body = len * sizeof(int);
+  ssize_t r;
+  char *buf;
+
+  if (broken) return false;
+  recv.resize(n);
+  recv[me] = send;
+  for (;;) {
+    fds.clear();
+    who.clear();
+    for (p = 0; p < n; p++) {
+      if (p == me) continue;
+      short ev = 0;
+      if (sent[p] < hdr + body) ev |= POLLOUT;
+      if (got[p] < hdr || got[p] < hdr + rlen[p] * sizeof(int)) ev |= POLLIN;
+      if (ev == 0) continue;
+      struct pollfd f;
+      f.fd = peer[p];
+      f.events = ev;
+      f.revents = 0;
+      fds.push_back(f);
+      who.push_back(p);
+    }
+    if (fds.empty()) break;
+    if (poll(&fds[0], fds.size(), -1) < 0) {
+      if (errno == EINTR) continue;
+      lostrank = me;
+      broken = true;
+      return false;
+    }
+
+    for (k = 0; k < (int)fds.size(); k++) {
+      p = who[k];
+      if (fds[k].revents & POLLOUT) {
+	if (sent[p] < hdr) {
+	  buf = (char*)&len + sent[p];
+	  r = ::send(peer[p], buf, hdr - sent[p], MSG_NOSIGNAL);
+	} else {
+	  buf = (char*)&send[0] + (sent[p] - hdr);
+	  r = ::send(peer[p], buf, hdr + body - sent[p], MSG_NOSIGNAL);
+	}
+	if (r < 0 && errno != EAGAIN && errno != EINTR) {
+	  lostrank = p;
+	  broken = true;
+	  return false;
+	}
+	if (r > 0) sent[p] += r;
+      }
+      if (fds[k].revents & (POLLIN | POLLHUP | POLLERR)) {
+	if (got[p] < hdr) {
+	  buf = (char*)&rlen[p] + got[p];
+	  r = read(peer[p], buf, hdr - got[p]);
+	} else {
+	  buf = (char*)&recv[p][0] + (got[p] - hdr);
+	  r = read(peer[p], buf, hdr + rlen[p] * sizeof(int) - got[p]);
+	}
+	if (r == 0 || (r < 0 && errno != EAGAIN && errno != EINTR)) {
+	  lostrank = p;
+	  broken = true;
+	  return false;
+	}
+	if (r > 0) {
+	  got[p] += r;
+	  if (got[p] == hdr) recv[p].resize(rlen[p]);
+	}
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,108 @@
+
+
+#ifndef AuctSocketTransport_H
+#define AuctSocketTransport_H
+
+#include "AuctTransport.h"
+
+class AuctSocketTransport : public AuctTransport {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor, from connected stream sockets to the other processes.
+   * The transport owns the sockets, and closes them when destroyed.
+   * @param myrank Rank of this process
+   * @param peers Socket connected to each process, indexed by rank
+   *              (the entry for this process is ignored)
+   */
+  AuctSocketTransport (int myrank, const std::vector<int>& peers);
+
+  /**
+   * Destructor
+   */
+  ~AuctSocketTransport ();
+
+  /**
+   * Fork this process into nprocs processes on the local host, joined
+   * by Unix domain socket pairs.  The calling process becomes rank 0,
+   * and the children ranks 1 to nprocs-1.  Each returns with its own
+   * transport.  The children return from this call, so the caller
+   * must make them exit when they are done.
+   * @param nprocs Number of processes wanted
+   * @return Transport of the calling process (or child), NULL on failure
+   *         (with errno set by the socketpair or fork which failed)
+   */
+  static AuctSocketTransport* fork_local (int nprocs);
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the number of this process.
+   * @return Rank, from 0 to size()-1
+   */
+  int rank () { return me; }
+
+  /**
+   * Accesses the number of processes.
+   * @return Number of processes
+   */
+  int size () { return peer.size(); }
+
+  /**
+   * Accesses the process whose connection broke the transport.
+   * @return Rank of the process lost (this one's if poll failed), or
+   *         -1 if the transport is not broken
+   */
+  int lost () { return lostrank; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Exchange a block of ints with all the other processes.  Sends and
+   * receives are interleaved with poll(), so that large blocks cannot
+   * deadlock on full socket buffers.  A broken connection breaks the
+   * transport: this and every later exchange fail.
+   * @param send Block sent by this process
+   * @param recv Output, the block sent by each process, indexed by rank
+   * @return True if every block came through
+   */
+  bool allgather (const std::vector<int>& send,
+		  std::vector<std::vector<int> >& recv);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int me;                 //!< Rank of this process
+  std::vector<int> peer;  //!< Socket to each process (-1 for this one)
+  bool broken;            //!< Has a connection failed?
+  int lostrank;           //!< Process whose connection failed, or -1
+
+};
+
+#endif
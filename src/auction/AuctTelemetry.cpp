@@ -0,0 +1,175 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "AuctTelemetry.h"
+
+AuctTelemetry::AuctTelemetry () {
+  clear();
+}
+
+AuctTelemetry& AuctTelemetry::global () {
+  static AuctTelemetry registry;
+  return registry;
+}
+
+int AuctTelemetry::size (long entries) {
+  if (entries < 1000) return SIZE_1K;
+  if (entries < 100000) return SIZE_100K;
+  if (entries < 10000000) return SIZE_10M;
+  return SIZE_HUGE;
+}
+
+const char* AuctTelemetry::name (int s) {
+  static const char* names[NSIZES] = { "1k", "100k", "10M", "huge" };
+  return (s >= 0 && s < NSIZES) ? names[s] : "unknown";
+}
+
+// Latencies below SUB microseconds have a bin each.  Above, the bin is
+// the power of two and the SUBBITS bits after the leading one.
+int AuctTelemetry::bin (long long us) {
+  if (us < SUB) return (us < 0) ? 0 : (int)us;
+  int e = 0;
+  while ((us >> e) >= 2*SUB && e < MAXEXP - SUBBITS) e++;
+  if ((us >> e) >= 2*SUB) return NBINS - 1;
+  return (e + 1) * SUB + (int)(us >> e) - SUB;
+}
+
+long long AuctTelemetry::bin_top (int b) {
+  if (b < SUB) return b;
+  int e = b / SUB - 1;
+  return ((long long)(b % SUB + SUB + 1) << e) - 1;
+}
+
+AuctTelemetry::Bucket AuctTelemetry::bucket (int s) {
+  std::lock_guard<std::mutex> lock(mtx);
+  return buckets[s];
+}
+
+double AuctTelemetry::quantile (int s, double q) {
+  std::lock_guard<std::mutex> lock(mtx);
+  return AuctTelemetry::quantile(buckets[s], q);
+}
+
+double AuctTelemetry::quantile (const Bucket& k, double q) {
+  if (k.solves == 0) return 0;
+  long rank = (long)std::ceil(q * k.solves), seen = 0;
+  if (rank < 1) rank = 1;
+  for (int b = 0; b < NBINS; b++) {
+    seen += k.bins[b];
+    if (seen >= rank)
+      return std::min(bin_top(b) * 1e-6, k.maxseconds);
+  }
+  return k.maxseconds;
+}
+
+void AuctTelemetry::record (AuctMetric& metric, double seconds,
+			    long entries) {
+  std::lock_guard<std::mutex> lock(mtx);
+  Bucket& k = buckets[AuctTelemetry::size(entries)];
+  k.solves++;
+  k.bins[AuctTelemetry::bin((long long)(seconds * 1e6))]++;
+  k.seconds += seconds;
+  if (seconds > k.maxseconds) k.maxseconds = seconds;
+  k.cycles += metric.ncycles();
+  if (metric.timed_out()) k.timeouts++;
+  if (metric.reoriented()) k.reoriented++;
+  if (metric.sparsified()) k.sparsified++;
+  k.allocs += metric.nallocs();
+  k.density += metric.paydensity();
+  k.entries += entries;
+  k.pruned += metric.npruned();
+}
+
+void AuctTelemetry::clear () {
+  std::lock_guard<std::mutex> lock(mtx);
+  memset(buckets, 0, sizeof(buckets));
+}
+
+double AuctTelemetry::ratio (const Bucket& k) {
+  long kept = k.entries - k.pruned;
+  return kept > 0 ? (double)k.pruned / kept : 0;
+}
+
+// The quantiles exported, and their labels.
+static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+static const char* qnames[] = { "0.5", "0.9", "0.99", "0.999" };
+static const int nquantiles = sizeof(quantiles) / sizeof(quantiles[0]);
+
+void AuctTelemetry::write_prometheus (std::ostream& os) {
+  std::lock_guard<std::mutex> lock(mtx);
+  int s, q;
+
+  os << "# HELP auction_solve_seconds Wall time of a solve." << std::endl
+     << "# TYPE auction_solve_seconds summary" << std::endl;
+  for (s = 0; s < NSIZES; s++) {
+    Bucket& k = buckets[s];
+    for (q = 0; q < nquantiles; q++)
+      os << "auction_solve_seconds{size=\"" << name(s) << "\",quantile=\""
+	 << qnames[q] << "\"} " << AuctTelemetry::quantile(k, quantiles[q])
+	 << std::endl;
+    os << "auction_solve_seconds_sum{size=\"" << name(s) << "\"} "
+       << k.seconds << std::endl
+       << "auction_solve_seconds_count{size=\"" << name(s) << "\"} "
+       << k.solves << std::endl;
+  }
+
+  static const char* counters[] = {
+    "cycles", "Auction cycles run.",
+    "timeouts", "Solves stopped by the cycle or time limit.",
+    "reoriented", "Solves whose payoff was transposed.",
+    "sparsified", "Solves whose dense payoff was sparsified.",
+    "allocations", "Workspace allocations made.",
+    "pruned_entries", "Payoff entries pruned before bidding." };
+  for (int c = 0; c < 6; c++) {
+    os << "# HELP auction_" << counters[2*c] << "_total " << counters[2*c+1]
+       << std::endl
+       << "# TYPE auction_" << counters[2*c] << "_total counter" << std::endl;
+    for (s = 0; s < NSIZES; s++) {
+      Bucket& k = buckets[s];
+      long v[6] = { k.cycles, k.timeouts, k.reoriented, k.sparsified,
+		    k.allocs, k.pruned };
+      os << "auction_" << counters[2*c] << "_total{size=\"" << name(s)
+	 << "\"} " << v[c] << std::endl;
+    }
+  }
+
+  os << "# HELP auction_payoff_density Mean payoff density of a solve."
+     << std::endl << "# TYPE auction_payoff_density gauge" << std::endl;
+  for (s = 0; s < NSIZES; s++)
+    os << "auction_payoff_density{size=\"" << name(s) << "\"} "
+       << (buckets[s].solves ? buckets[s].density / buckets[s].solves : 0)
+       << std::endl;
+
+  os << "# HELP auction_sparsification_ratio Payoff entries pruned, over"
+     << " those kept." << std::endl
+     << "# TYPE auction_sparsification_ratio gauge" << std::endl;
+  for (s = 0; s < NSIZES; s++)
+    os << "auction_sparsification_ratio{size=\"" << name(s) << "\"} "
+       << AuctTelemetry::ratio(buckets[s]) << std::endl;
+}
+
+void AuctTelemetry::write_json (std::ostream& os) {
+  std::lock_guard<std::mutex> lock(mtx);
+
+  os << "{\"sizes\":[";
+  for (int s = 0; s < NSIZES; s++) {
+    Bucket& k = buckets[s];
+    double n = k.solves ? (double)k.solves : 1;
+    os << (s ? "," : "") << std::endl
+       << "{\"size\":\"" << name(s) << "\",\"solves\":" << k.solves
+       << ",\"seconds\":{\"sum\":" << k.seconds << ",\"max\":"
+       << k.maxseconds;
+    for (int q = 0; q < nquantiles; q++)
+      os << ",\"p" << quantiles[q] * 100 << "\":"
+	 << AuctTelemetry::quantile(k, quantiles[q]);
+    os << "},\"cycles\":" << k.cycles
+       << ",\"timeout_rate\":" << k.timeouts / n
+       << ",\"reoriented_rate\":" << k.reoriented / n
+       << ",\"sparsified_rate\":" << k.sparsified / n
+       << ",\"allocations\":" << k.allocs
+       << ",\"payoff_density\":" << k.density / n
+       << ",\"pruned_entries\":" << k.pruned
+       << ",\"sparsification_ratio\":" << AuctTelemetry::ratio(k) << "}";
+  }
+  os << std::endl << "]}" << std::endl;
+}
@@ -0,0 +1,213 @@
+
+
+#ifndef AuctTelemetry_H
+#define AuctTelemetry_H
+
+#include <mutex>
+#include <iostream>
+#include "AuctMetric.h"
+
+class AuctTelemetry {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Problem sizes the solves are split by, in payoff entries. <p>
+   * SIZE_1K: fewer than a thousand <br>
+   * SIZE_100K: fewer than a hundred thousand <br>
+   * SIZE_10M: fewer than ten million <br>
+   * SIZE_HUGE: more
+   */
+  enum Size { SIZE_1K, SIZE_100K, SIZE_10M, SIZE_HUGE, NSIZES };
+
+  /**
+   * Shape of the latency histograms.  Latencies are kept in
+   * microseconds, in bins whose width is 1/SUB of the power of two
+   * they lie in (so a quantile is off by less than 1/SUB of itself), up
+   * to 2^MAXEXP microseconds (about 12 days). <p>
+   * SUBBITS: log2 of SUB <br>
+   * SUB: bins per power of two <br>
+   * MAXEXP: largest power of two kept <br>
+   * NBINS: bins per histogram
+   */
+  enum { SUBBITS = 3, SUB = 1 << SUBBITS, MAXEXP = 40,
+	 NBINS = (MAXEXP - SUBBITS + 2) * SUB };
+
+  /**
+   * Everything kept about the solves of one size. <p>
+   * long solves;           // solves recorded <br>
+   * long bins[NBINS];      // latency histogram <br>
+   * double seconds;        // total latency <br>
+   * double maxseconds;     // longest latency <br>
+   * long cycles;           // auction cycles, over all the solves <br>
+   * long timeouts;         // solves which timed out <br>
+   * long reoriented;       // solves whose payoff was transposed <br>
+   * long sparsified;       // solves whose dense payoff was sparsified <br>
+   * long allocs;           // workspace allocations, over all the solves <br>
+   * double density;        // payoff density, over all the solves <br>
+   * long entries;          // payoff entries, over all the solves <br>
+   * long pruned;           // entries pruned, over all the solves
+   */
+  typedef struct Bucket {
+    long solves;           // solves recorded
+    long bins[NBINS];      // latency histogram
+    double seconds;        // total latency
+    double maxseconds;     // longest latency
+    long cycles;           // auction cycles, over all the solves
+    long timeouts;         // solves which timed out
+    long reoriented;       // solves whose payoff was transposed
+    long sparsified;       // solves whose dense payoff was sparsified
+    long allocs;           // workspace allocations, over all the solves
+    double density;        // payoff density, over all the solves
+    long entries;          // payoff entries, over all the solves
+    long pruned;           // entries pruned, over all the solves
+  } Bucket;
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  No solves recorded.
+   */
+  AuctTelemetry ();
+
+  /**
+   * The registry of the process, for auctions anywhere in it to record
+   * into (see AuctParm::set_telemetry) and a service to export.
+   * @return The process-wide registry
+   */
+  static AuctTelemetry& global ();
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the size a problem is counted under
+   * @param entries Payoff entries
+   * @return A Size
+   */
+  static int size (long entries);
+
+  /**
+   * Accesses the name of a size, as exported
+   * @param s A Size
+   * @return Name of the size
+   */
+  static const char* name (int s);
+
+  /**
+   * Accesses the solves of a size recorded so far
+   * @param s A Size
+   * @return A copy of its bucket
+   */
+  Bucket bucket (int s);
+
+  /**
+   * A latency quantile of the solves of a size, from the histogram
+   * @param s A Size
+   * @param q Quantile (0.99 for p99)
+   * @return Latency in seconds, the top of the bin the quantile lies in
+   *         (0 if there are no solves)
+   */
+  double quantile (int s, double q);
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Record a solve.  Safe to call from any thread.
+   * @param metric Metric the solve returned
+   * @param seconds Wall time of the solve
+   * @param entries Payoff entries
+   */
+  void record (AuctMetric& metric, double seconds, long entries);
+
+  /**
+   * Forget every solve.
+   */
+  void clear ();
+
+  /**
+   * Write the counts in the Prometheus text format: the latency of each
+   * size as a summary (its quantiles, sum and count), and the other
+   * counts as counters, each labelled with its size.
+   * @param os Stream to write to
+   */
+  void write_prometheus (std::ostream& os);
+
+  /**
+   * Write the counts as JSON: one object for each size, with its
+   * latency quantiles and rates.
+   * @param os Stream to write to
+   */
+  void write_json (std::ostream& os);
+
+ private:
+
+  /**
+   * The bin of a latency
+   * @param us Latency in microseconds
+   * @return Bin
+   */
+  static int bin (long long us);
+
+  /**
+   * The top of a bin
+   * @param b Bin
+   * @return Largest latency in the bin, in microseconds
+   */
+  static long long bin_top (int b);
+
+  /**
+   * A quantile of a bucket (under the lock)
+   */
+  static double quantile (const Bucket& k, double q);
+
+  /**
+   * The sparsification ratio of a bucket: entries pruned before bidding
+   * (see AuctParm::set_prunek), over those kept
+   * @param k Bucket
+   * @return Ratio (0 if nothing was pruned)
+   */
+  static double ratio (const Bucket& k);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  std::mutex mtx;             //!< Guards the buckets
+  Bucket buckets[NSIZES];     //!< Solves of each size
+
+  AuctTelemetry (const AuctTelemetry&);             //!< Not implemented
+  AuctTelemetry& operator= (const AuctTelemetry&);  //!< Not implemented
+
+};
+
+#endif
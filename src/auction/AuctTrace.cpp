@@ -0,0 +1,115 @@
+#include <fstream>
+#include <algorithm>
+#include <unistd.h>
+#include "AuctTrace.h"
+
+std::atomic<long> AuctTrace::nserial(0);
+
+AuctTrace::AuctTrace (int capacity) {
+  cap = (capacity > 0) ? capacity : 1;
+  serial = nserial++;
+  epoch = std::chrono::steady_clock::now();
+}
+
+AuctTrace::~AuctTrace () {
+  for (unsigned int i = 0; i < rings.size(); i++) delete rings[i];
+}
+
+int AuctTrace::nthreads () {
+  std::lock_guard<std::mutex> lock(mtx);
+  return (int)rings.size();
+}
+
+long AuctTrace::ndropped () {
+  std::lock_guard<std::mutex> lock(mtx);
+  long n = 0;
+  for (unsigned int i = 0; i < rings.size(); i++)
+    n += std::max(rings[i]->head.load() - cap, 0L);
+  return n;
+}
+
+const char* AuctTrace::name (int ev) {
+  static const char* names[NEVENTS] = {
+    "ingest", "scale", "transpose", "phase", "cycles", "hidden_bid",
+    "greedy_fill", "checkecs" };
+  return (ev >= 0 && ev < NEVENTS) ? names[ev] : "unknown";
+}
+
+// The rings are only ever added to while tracing, so that a thread's
+// ring stays where it is for as long as the trace lives.
+AuctTrace::Ring* AuctTrace::attach () {
+  std::lock_guard<std::mutex> lock(mtx);
+  std::thread::id me = std::this_thread::get_id();
+  for (unsigned int i = 0; i < rings.size(); i++)
+    if (rings[i]->owner == me) return rings[i];
+  Ring* r = new Ring;
+  r->rec.resize(cap);
+  r->head.store(0);
+  r->owner = me;
+  r->tid = (int)rings.size();
+  rings.push_back(r);
+  return r;
+}
+
+void AuctTrace::clear () {
+  std::lock_guard<std::mutex> lock(mtx);
+  for (unsigned int i = 0; i < rings.size(); i++) rings[i]->head.store(0);
+}
+
+// Each ring is written out oldest first, from the record after the
+// last overwritten.  A step whose beginning was overwritten has only
+// its end, which the viewers put up with.  The value of a step is
+// named as in Event, and its counters are repeated as counter events,
+// so that the viewers draw them as tracks of the process.
+void AuctTrace::write_json (std::ostream& os) {
+  static const char* values[NEVENTS] = {
+    "entries", "entries", "rows", "epsilon", "cycles", "epsilon",
+    "associations", "epsilon" };
+  std::lock_guard<std::mutex> lock(mtx);
+  int pid = (int)getpid();
+  bool first = true;
+  long h, k;
+  std::streamsize prec = os.precision(15);  // (times to the nanosecond)
+
+  os << "{\"traceEvents\":[";
+  for (unsigned int i = 0; i < rings.size(); i++) {
+    Ring& r = *rings[i];
+    os << (first ? "\n" : ",\n")
+       << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"tid\":" << r.tid << ",\"args\":{\"name\":\"auction thread "
+       << r.tid << "\"}}";
+    first = false;
+    h = r.head.load(std::memory_order_acquire);
+    for (k = std::max(h - cap, 0L); k < h; k++) {
+      Record& x = r.rec[k % cap];
+      double us = x.ns / 1000.0;
+      os << ",\n{\"name\":\"" << name(x.event) << "\",\"cat\":\"auction\""
+	 << ",\"ph\":\"" << (x.begin ? "B" : "E") << "\",\"ts\":" << us
+	 << ",\"pid\":" << pid << ",\"tid\":" << r.tid << ",\"args\":{\""
+	 << values[x.event] << "\":" << x.value;
+      if (x.nfree >= 0) os << ",\"free\":" << x.nfree;
+      if (x.spread >= 0) os << ",\"spread\":" << x.spread;
+      os << "}}";
+      if (x.nfree >= 0)
+	os << ",\n{\"name\":\"free bidders\",\"ph\":\"C\",\"ts\":" << us
+	   << ",\"pid\":" << pid << ",\"args\":{\"free\":" << x.nfree << "}}";
+      if (x.spread >= 0)
+	os << ",\n{\"name\":\"price spread\",\"ph\":\"C\",\"ts\":" << us
+	   << ",\"pid\":" << pid << ",\"args\":{\"spread\":" << x.spread
+	   << "}}";
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":";
+  long n = 0;
+  for (unsigned int i = 0; i < rings.size(); i++)
+    n += std::max(rings[i]->head.load() - cap, 0L);
+  os << n << "}}\n";
+  os.precision(prec);
+}
+
+bool AuctTrace::write_json (const char* path) {
+  std::ofstream out(path);
+  if (!out) return false;
+  write_json(out);
+  return (bool)out;
+}
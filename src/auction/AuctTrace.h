@@ -0,0 +1,232 @@
+
+
+#ifndef AuctTrace_H
+#define AuctTrace_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+class AuctTrace {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Steps of the solver which are traced, and the value each carries. <p>
+   * INGEST: the user's payoff read into AuctPay (entries) <br>
+   * SCALE: the payoff copied into the workspace, scaled and perhaps
+   * transposed (entries) <br>
+   * TRANSPOSE: the shape and associations reoriented (rows before) <br>
+   * PHASE: an epsilon-scaling phase (epsilon) <br>
+   * CYCLES: a batch of cycles, run until every bidder is associated or
+   * the auction stops (cycles run so far) <br>
+   * HIDDEN_BID: the hidden bid at the end of a batch (epsilon) <br>
+   * GREEDY_FILL: the greedy fill of an auction stopped early
+   * (associations) <br>
+   * CHECKECS: the e-CS check of the DEBUG auction (epsilon)
+   */
+  enum Event { INGEST, SCALE, TRANSPOSE, PHASE, CYCLES, HIDDEN_BID,
+	       GREEDY_FILL, CHECKECS, NEVENTS };
+
+  /**
+   * The beginning or end of a step, as kept in a thread's ring.
+   */
+  struct Record {
+    long long ns;   //!< Time since the trace was made, in nanoseconds
+    int event;      //!< An Event
+    bool begin;     //!< Beginning (or end) of the step?
+    int nfree;      //!< Bidders still free (-1 if not known)
+    double spread;  //!< Highest less lowest object price (-1 if not known)
+    double value;   //!< Value of the step (see Event)
+  };
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  Each thread which records into the trace is given a
+   * ring of its own, the first time it does so, and the oldest records
+   * of a full ring are overwritten.
+   * @param capacity Records kept per thread
+   */
+  AuctTrace (int capacity = 65536);
+
+  /**
+   * Destructor.  No auction may be recording into the trace.
+   */
+  ~AuctTrace ();
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the number of records kept per thread
+   * @return Capacity of each ring
+   */
+  int capacity () { return cap; }
+
+  /**
+   * Accesses the number of threads which have recorded into the trace
+   * @return Number of rings
+   */
+  int nthreads ();
+
+  /**
+   * Accesses the number of records lost to full rings
+   * @return Records overwritten, over all the threads
+   */
+  long ndropped ();
+
+  /**
+   * Accesses the name of a step, as exported
+   * @param ev An Event
+   * @return Name of the step
+   */
+  static const char* name (int ev);
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Record the beginning of a step on this thread's ring.  No lock is
+   * taken, except the first time a thread records.
+   * @param ev An Event
+   * @param value Value of the step (see Event)
+   * @param nfree Bidders still free (-1 if not known)
+   * @param spread Spread of the object prices (-1 if not known)
+   */
+  inline void begin (int ev, double value = 0, int nfree = -1,
+		     double spread = -1) {
+    put (ev, true, value, nfree, spread);
+  }
+
+  /**
+   * Record the end of a step on this thread's ring.
+   * @param ev An Event
+   * @param value Value of the step (see Event)
+   * @param nfree Bidders still free (-1 if not known)
+   * @param spread Spread of the object prices (-1 if not known)
+   */
+  inline void end (int ev, double value = 0, int nfree = -1,
+		   double spread = -1) {
+    put (ev, false, value, nfree, spread);
+  }
+
+  /**
+   * Forget every record.  No auction may be recording into the trace.
+   */
+  void clear ();
+
+  /**
+   * Write the records as Chrome trace JSON (which Perfetto and
+   * chrome://tracing load): a begin and an end event for each step,
+   * with its value and counters as arguments, and counter events for
+   * the free bidders and the price spread.  Each thread is a track.
+   * No auction may be recording into the trace.
+   * @param os Stream to write to
+   */
+  void write_json (std::ostream& os);
+
+  /**
+   * Write the records as Chrome trace JSON to a file.
+   * @param path File to write
+   * @return False if the file could not be written
+   */
+  bool write_json (const char* path);
+
+ private:
+
+  /**
+   * The records of one thread.  Only that thread writes them, and it
+   * publishes each by advancing head.
+   */
+  struct Ring {
+    std::vector<Record> rec;   //!< Records, written round and round
+    std::atomic<long> head;    //!< Number of records ever written
+    std::thread::id owner;     //!< Thread which writes the ring
+    int tid;                   //!< Index of the thread, for the export
+  };
+
+  /**
+   * This thread's ring, made on first use.  The last one used is kept
+   * by the thread, so the lock is only taken on its first record, or
+   * when it moves between traces.
+   * @return The ring
+   */
+  inline Ring* ring () {
+    thread_local long cached = -1;
+    thread_local Ring* mine = 0;
+    if (cached != serial) {
+      mine = attach ();
+      cached = serial;
+    }
+    return mine;
+  }
+
+  /**
+   * Find or make this thread's ring (under the lock).
+   * @return The ring
+   */
+  Ring* attach ();
+
+  /**
+   * Record a step on this thread's ring.
+   */
+  inline void put (int ev, bool b, double value, int nfree, double spread) {
+    Ring* r = ring ();
+    long h = r->head.load(std::memory_order_relaxed);
+    Record& x = r->rec[h % cap];
+    x.ns = std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now() - epoch).count();
+    x.event = ev;
+    x.begin = b;
+    x.nfree = nfree;
+    x.spread = spread;
+    x.value = value;
+    r->head.store(h+1, std::memory_order_release);
+  }
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int cap;              //!< Records kept per thread
+  long serial;          //!< Number of this trace, unique in the process
+  std::chrono::steady_clock::time_point epoch;  //!< Time of record 0
+  std::mutex mtx;       //!< Guards rings
+  std::vector<Ring*> rings;  //!< Ring of each thread which has recorded
+  static std::atomic<long> nserial;  //!< Traces made so far
+
+};
+
+#endif
@@ -0,0 +1,67 @@
+
+
+#ifndef AuctTransport_H
+#define AuctTransport_H
+
+#include <vector>
+
+class AuctTransport {
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Destructor
+   */
+  virtual ~AuctTransport () { }
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the number of this process among those of the auction.
+   * @return Rank, from 0 to size()-1
+   */
+  virtual int rank () = 0;
+
+  /**
+   * Accesses the number of processes taking part in the auction.
+   * @return Number of processes
+   */
+  virtual int size () = 0;
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Exchange a block of ints with all the other processes.  Every
+   * process must call this the same number of times; it returns once
+   * this process has the blocks of all the others, or once it cannot
+   * have them.
+   * @param send Block sent by this process (may be empty)
+   * @param recv Output, the block sent by each process, indexed by rank
+   *             (including this one's own); undefined on failure
+   * @return True if every block came through, false if a process was
+   *         lost (the auction then stops, see AuctMetric::failed)
+   */
+  virtual bool allgather (const std::vector<int>& send,
+			  std::vector<std::vector<int> >& recv) = 0;
+
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include "AuctWorkspace.h"
+
+AuctWorkspace::AuctWorkspace() {
+  allocs = 0;
+  for (int i = 0; i < NSLOTS; i++) {
+    buf[i] = 0;
+    cap[i] = 0;
+  }
+  for (int i = 0; i < NDSLOTS; i++) {
+    dbuf[i] = 0;
+    dcap[i] = 0;
+  }
+}
+
+AuctWorkspace::~AuctWorkspace() {
+  release();
+}
+
+long AuctWorkspace::nbytes() {
+  long total = 0;
+  long dtotal = 0;
+  for (int i = 0; i < NSLOTS; i++) total += cap[i];
+  for (int i = 0; i < NDSLOTS; i++) dtotal += dcap[i];
+  return total * sizeof(int) + dtotal * sizeof(double);
+}
+
+// Size everything for the largest problem we expect, the payoff
+// arrays for the oriented matrix and the SM lists for the widest row.
+void AuctWorkspace::presize(int nrows, int ncols, int nnz,
+			    int nfullrows, int nfullcols) {
+  int nmax = std::max(nrows, ncols);
+  int fmax = std::max(nfullrows, nfullcols);
+  reserve(PAYVAL, nnz);
+  reserve(PAYIND, nnz);
+  reserve(PAYPTR, nmax+1);
+  reserve(SCRATCH, std::max(nmax+1, fmax));
+  reserve(USEDCOLS, fmax);
+  reserve(FREEROWS, fmax);
+  reserve(SHOPV, fmax+1);
+  reserve(SHOPJS, fmax+1);
+  reserve(SHOPGRP, fmax+1);
+  reserve(SNAPCOL, fmax);
+  reserve(SNAPPRICE, fmax);
+  reserve(SNAPPROF, fmax);
+}
+
+void AuctWorkspace::release() {
+  for (int i = 0; i < NSLOTS; i++) {
+    free(buf[i]);
+    buf[i] = 0;
+    cap[i] = 0;
+  }
+  for (int i = 0; i < NDSLOTS; i++) {
+    free(dbuf[i]);
+    dbuf[i] = 0;
+    dcap[i] = 0;
+  }
+}
+
+void* AuctWorkspace::allocate(long bytes) {
+  void *p = 0;
+  if (posix_memalign(&p, ALIGN, std::max(bytes, 1L)) != 0)
+    throw std::bad_alloc();
+  return p;
+}
+
+void AuctWorkspace::grow(int slot, int size) {
+  free(buf[slot]);
+  buf[slot] = 0;
+  cap[slot] = 0;
+  buf[slot] = (int*)allocate((long)size * sizeof(int));
+  cap[slot] = size;
+  allocs++;
+}
+
+void AuctWorkspace::dgrow(int slot, int size) {
+  free(dbuf[slot]);
+  dbuf[slot] = 0;
+  dcap[slot] = 0;
+  dbuf[slot] = (double*)allocate((long)size * sizeof(double));
+  dcap[slot] = size;
+  allocs++;
+}
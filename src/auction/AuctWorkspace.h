@@ -0,0 +1,245 @@
+
+
+#ifndef AuctWorkspace_H
+#define AuctWorkspace_H
+
+class AuctWorkspace {
+
+  // ------------------------------------------------------------------
+  //
+  //	Structures, Enumerators and Type Definitions.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Buffer slots owned by the workspace.  Each slot is an int array
+   * which only ever grows, so that once it has reached the high-water
+   * mark for a given problem shape, further solves reuse it. <p>
+   * PAYVAL, PAYIND, PAYPTR: oriented payoff (values, columns, row ptrs) <br>
+   * SCRATCH: general purpose (transpose counts, e-CS price copy) <br>
+   * USEDCOLS, FREEROWS: per-row association lists of the SM cycle <br>
+   * SHOPV, SHOPJS, SHOPGRP: SM cycle shopping list (value, col, group) <br>
+   * SNAPCOL, SNAPPRICE, SNAPPROF: last complete phase (assignment, prices,
+   * profits) <br>
+   * BIDOBJ, OBJBID: floating point auction and JV assignment (object of
+   * each bidder, bidder of each object) <br>
+   * JVCOST: JV dense payoff (one row per payoff row) <br>
+   * JVPRED, JVTODO, JVROWS: JV shortest path tree (bidder before each
+   * object), objects not yet scanned (sparse JV: objects reached), and
+   * bidders scanned <br>
+   * JVHEAP, JVPOS: sparse JV heap of objects, and their positions in it <br>
+   * CMPPTR, CMPTOP, CMPSTEP: compacted payoff rows (first entry, largest
+   * value, quantum) <br>
+   * CMPCOL, CMPVAL: compacted payoff entries (16 bit column steps and
+   * quantized values, two to an int) <br>
+   * ORDROW, ORDROWAT, ORDCOL, ORDCOLAT: reordering of the payoff (new
+   * number of each row, row at each number, and the same for columns) <br>
+   * ORDCPTR, ORDCROW: rows of each column, while reordering <br>
+   * ORDPTR, ORDIND, ORDVAL: reordered payoff (row ptrs, columns, values) <br>
+   * MCFLOW, MCCPTR, MCCROW, MCCENT: structural pre-check (associations
+   * of each entry, and the entries of each column and their rows) <br>
+   * MCREM, MCDIST, MCITER, MCSTACK: structural pre-check (room left,
+   * search distance and next entry of each row then column, and the
+   * search path) <br>
+   * LBENT, LBTHR, LBOK: look-back candidates of each row (entries,
+   * threshold, and whether cached) <br>
+   * CLROW, CLROWAT: collapse of identical rows (full row of each row,
+   * and row at each full row) <br>
+   * CLPTR, CLMULT, CLIND, CLVAL: collapsed payoff (row ptrs,
+   * multiplicities, columns, values) <br>
+   * CLCOPY: collapse, copies of the assignment and profits <br>
+   * PRKEEP, PRBPTR, PRBENT, PROBJ: pruned auction (whether each entry
+   * is kept, and the entries of each bidder and their objects) <br>
+   * PRPTR, PRIND, PRVAL: pruned payoff (row ptrs, columns, values) <br>
+   * PRMATE, PROMATE, PRPOS, PRSEEN, PRSTACK: matching kept by the
+   * pruned auction (entry of each bidder, bidder of each object, next
+   * entry and last search of each bidder, and the search path) <br>
+   * PRPROF, PRASSOC: re-admission (profit of each bidder, and whether
+   * it is associated) <br>
+   * HBASSOC, HBUNASSOC: raw hidden bid (associated and unassociated
+   * objects, sorted by price) <br>
+   * KBMASK: k-best augmentation (objects forbidden to the bidder being
+   * scanned); it also uses the JV shortest path tree and heap, and DDIST
+   */
+  enum Slot { PAYVAL, PAYIND, PAYPTR, SCRATCH, USEDCOLS, FREEROWS,
+	      SHOPV, SHOPJS, SHOPGRP, SNAPCOL, SNAPPRICE, SNAPPROF,
+	      BIDOBJ, OBJBID, JVCOST, JVPRED, JVTODO, JVROWS, JVHEAP, JVPOS,
+	      CMPPTR, CMPTOP, CMPSTEP, CMPCOL, CMPVAL,
+	      ORDROW, ORDROWAT, ORDCOL, ORDCOLAT, ORDCPTR, ORDCROW,
+	      ORDPTR, ORDIND, ORDVAL, MCFLOW, MCCPTR, MCCROW, MCCENT,
+	      MCREM, MCDIST, MCITER, MCSTACK, LBENT, LBTHR, LBOK,
+	      CLROW, CLROWAT, CLPTR, CLMULT, CLIND, CLVAL, CLCOPY,
+	      PRKEEP, PRBPTR, PRBENT, PROBJ, PRPTR, PRIND, PRVAL,
+	      PRMATE, PROMATE, PRPOS, PRSEEN, PRSTACK, PRPROF, PRASSOC,
+	      KBMASK, HBASSOC, HBUNASSOC, NSLOTS };
+
+  /**
+   * Floating point buffer slots, which grow in the same way. <p>
+   * DPAYVAL: oriented payoff values <br>
+   * DPRICE: object prices <br>
+   * DPROFIT, DDIST: JV bidder profits, and shortest path lengths
+   */
+  enum DSlot { DPAYVAL, DPRICE, DPROFIT, DDIST, NDSLOTS };
+
+  /**
+   * Alignment of every buffer, in bytes: a cache line, so that a row of
+   * the payoff starts no further into a line than its offset requires,
+   * and the buffers of different threads never share a line.
+   */
+  enum { ALIGN = 64 };
+
+  // ------------------------------------------------------------------
+  //
+  //	Constructors, Destructors, and Operators.
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Constructor.  No storage is allocated until it is first needed.
+   */
+  AuctWorkspace();
+
+  /**
+   * Destructor
+   */
+  ~AuctWorkspace();
+
+  // ------------------------------------------------------------------
+  //
+  //	Accessor Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Accesses the number of heap allocations made by this workspace.
+   * In steady state (same shaped problems) this stops increasing.
+   * @return Number of buffer allocations since construction
+   */
+  int nallocs() { return allocs; }
+
+  /**
+   * Accesses the total storage currently held by the workspace.
+   * @return Size of all buffers, in bytes
+   */
+  long nbytes();
+
+  /**
+   * Access a buffer without resizing it.
+   * @param slot Buffer to access
+   * @return Pointer to the buffer (NULL if never reserved)
+   */
+  inline int* get(int slot) { return buf[slot]; }
+
+  /**
+   * Capacity of a buffer.
+   * @param slot Buffer to query
+   * @return Number of ints the buffer can hold
+   */
+  inline int capacity(int slot) { return cap[slot]; }
+
+  /**
+   * Access a floating point buffer without resizing it.
+   * @param slot Buffer to access
+   * @return Pointer to the buffer (NULL if never reserved)
+   */
+  inline double* dget(int slot) { return dbuf[slot]; }
+
+  // ------------------------------------------------------------------
+  //
+  //	Action Methods
+  //
+  // ------------------------------------------------------------------
+
+ public:
+
+  /**
+   * Make sure that a buffer holds at least size entries.  The buffer
+   * is reallocated only if it is too small, in which case its contents
+   * are lost.
+   * @param slot Buffer to reserve
+   * @param size Minimum number of entries required
+   * @return Pointer to the buffer
+   */
+  inline int* reserve(int slot, int size) {
+    if (size > cap[slot]) grow(slot, size);
+    return buf[slot];
+  }
+
+  /**
+   * As reserve, for a floating point buffer.
+   * @param slot Buffer to reserve
+   * @param size Minimum number of entries required
+   * @return Pointer to the buffer
+   */
+  inline double* dreserve(int slot, int size) {
+    if (size > dcap[slot]) dgrow(slot, size);
+    return dbuf[slot];
+  }
+
+  /**
+   * Presize all buffers for a problem, so that the first solve does
+   * not need to allocate.
+   * @param nrows Number of rows in the payoff matrix
+   * @param ncols Number of columns in the payoff matrix
+   * @param nnz Number of non-zero entries in the payoff matrix
+   * @param nfullrows Number of row associations
+   * @param nfullcols Number of column associations
+   */
+  void presize(int nrows, int ncols, int nnz, int nfullrows, int nfullcols);
+
+  /**
+   * Free all buffers.  The workspace may still be used afterwards.
+   */
+  void release();
+
+ private:
+
+  /**
+   * Allocate an aligned buffer.
+   * @param bytes Size of the buffer
+   * @return The buffer, to be freed with free()
+   */
+  static void* allocate(long bytes);
+
+  /**
+   * Reallocate a buffer to a given size.
+   * @param slot Buffer to reallocate
+   * @param size New size of the buffer
+   */
+  void grow(int slot, int size);
+
+  /**
+   * Reallocate a floating point buffer to a given size.
+   * @param slot Buffer to reallocate
+   * @param size New size of the buffer
+   */
+  void dgrow(int slot, int size);
+
+//
+// ------------------------------------------------------------------
+//
+//    Data Members.
+//
+// ------------------------------------------------------------------
+//
+
+ private:
+
+  int *buf[NSLOTS]; //!< Buffers, indexed by Slot
+  int cap[NSLOTS];  //!< Capacity of each buffer
+  double *dbuf[NDSLOTS]; //!< Floating point buffers, indexed by DSlot
+  int dcap[NDSLOTS];     //!< Capacity of each floating point buffer
+  int allocs;       //!< Number of allocations made
+
+  AuctWorkspace (const AuctWorkspace&);             //!< Not implemented
+  AuctWorkspace& operator= (const AuctWorkspace&);  //!< Not implemented
+
+};
+
+#endif
@@ -5,15 +5,29 @@
 #include <string>
 #include "AuctAlg.h"
 
+using namespace std;
+
 void adriver_timeprint (clock_t &current, clock_t &total,
-			  clock_t & prev, const string& op="");
+			  clock_t & prev, const string& op="",
+			  AuctPerf* perf=0);
 
 
-int main()
+// With -perf, the hardware counters of each step of the driver, and of
+// each epsilon-scaling phase of the auction, are printed with its times.
+int main(int argc, char** argv)
 {
 
   clock_t prev, total, current;
   int i, j;
+  bool perfon = (argc > 1 && string(argv[1]) == "-perf");
+  AuctPerf *perf = 0, *phaseperf = 0;
+  if (perfon) {
+    perf = new AuctPerf;
+    phaseperf = new AuctPerf;
+    if (perf->nsupported() < AuctPerf::NCOUNTERS)
+      cerr << "Hardware counters: " << perf->nsupported() << " of "
+	   << AuctPerf::NCOUNTERS << " supported" << endl;
+  }
 
   // Read in user input
   char in_file[255], out_file[255], rmult_file[255], cmult_file[255];
@@ -23,7 +37,7 @@ int main()
   cerr << "Number of Rows:        "; cin >> nrow;
   cerr << "Number of Columns:     "; cin >> ncol;
 
-  adriver_timeprint (current, total, prev);
+  adriver_timeprint (current, total, prev, "", perf);
 
   // create a vector of a vector of doubles (row-oriented matrix)
   std::vector<std:: vector<double> > values;
@@ -39,7 +53,7 @@ int main()
   }
   fin.close();
 
-  adriver_timeprint (current, total, prev,  "loading");
+  adriver_timeprint (current, total, prev,  "loading", perf);
 
   int nrmult, ncmult;
   cout << "Number of row multiples (0 to specify file): " ; cin >> nrmult;
@@ -53,6 +67,10 @@ int main()
       cin >> cmult_file;
   }
 
+  // The auction object (and its workspace) is shared by both runs, so
+  // the second run should not need to allocate any solver storage.
+  AuctAlg x;
+
   // NJP - run auction twice so we can test if destructors are working
  for (int zz = 0; zz < 2; zz++) { // NJP - test destructor bug
 
@@ -65,6 +83,10 @@ cout << "The value of ZZ is " << zz << endl;
   Parameters.set_EScale(true);
   Parameters.set_DEBUG(false);
   Parameters.set_MAXINT(1000000);
+  if (phaseperf) {
+    phaseperf->clear();
+    Parameters.set_perf(phaseperf);
+  }
 
   AuctShape Shape (values);
 
@@ -98,14 +120,13 @@ cout << "The value of ZZ is " << zz << endl;
   cout << "Full rows: " << Shape.nfullrows()
        << "    Full cols: " << Shape.nfullcols() << endl;
   cout << "Number of Non-zeros: " << Shape.nnz() << endl;
-  adriver_timeprint (current, total, prev,  "constructing Auction inputs");
+  adriver_timeprint (current, total, prev,  "constructing Auction inputs", perf);
 
   // run the auction
   //
   AuctMetric metric;
-  AuctAlg x;
   metric = x.auction(Payoff, Shape, Associations, Parameters);
-  adriver_timeprint (current, total, prev,  "auction");
+  adriver_timeprint (current, total, prev,  "auction", perf);
 
   // Output metrics to screen
   cout << endl << "Number of cycles: " << metric.ncycles() << ". Results are";
@@ -113,11 +134,15 @@ cout << "The value of ZZ is " << zz << endl;
   cout << " optimal.  Problem is";
   if (!metric.isfeasible()) cout << " not";
   cout << " feasible. " << endl;
+  if (metric.timed_out() && metric.gap() >= 0)
+    cout << "Stopped early, within " << metric.gap()
+	 << " of the optimal payoff" << endl;
 
   cout << "Number associated "
        << metric.nauction_assoc() << " by auction, "
        << metric.ntotal_assoc() << " total, with minassoc ="
        << metric.nmaxassoc() << endl;
+  cout << "Workspace allocations: " << metric.nallocs() << endl;
 
   cout << "Type of auction: ";
   if (!metric.escaling()) cout << "no ";
@@ -128,6 +153,19 @@ cout << "The value of ZZ is " << zz << endl;
   if (!metric.reoriented()) cout << "not";
   cout << " reoriented " << endl;
 
+  for (i = 0; i < metric.nphases(); i++) {
+    AuctMetric::EpsPhase phase = metric.phase(i);
+    cout << "  Epsilon " << phase.epsilon << ": " << phase.cycles
+	 << " cycles, " << phase.bids << " bids";
+    if (phaseperf && i < phaseperf->nsamples()) {
+      AuctPerf::Sample& s = phaseperf->sample(i);
+      if (s.seconds > 0) cout << ", " << phase.bids / s.seconds << " bids/s";
+      cout << endl << "    ";
+      phaseperf->print(cout, s);
+    }
+    cout << endl;
+  }
+
   cout << endl;
   cout << "Total associated payoff: "
        << x.totalpay(Payoff, Shape, Associations)
@@ -184,21 +222,31 @@ cout << "The value of ZZ is " << zz << endl;
 
   fout.close();
 
-  adriver_timeprint (current, total, prev,  "save");
+  adriver_timeprint (current, total, prev,  "save", perf);
   cout << "Total CPU: " << 1000.0*total/CLOCKS_PER_SEC << "ms" << endl;
  }
  // End for(zz) - NJP
 
+  delete perf;
+  delete phaseperf;
   return 0;
 }
 
 void adriver_timeprint (clock_t &current, clock_t &total,
-			  clock_t & prev, const string& op) {
+			  clock_t & prev, const string& op, AuctPerf* perf) {
 
   total = clock(); current = total - prev; prev = total;
 
   if (op.length() > 0) {
   cout << "Done with " << op << ". Operation took ";
   cout << 1000.0*current/CLOCKS_PER_SEC << "ms" << endl;
+  if (perf) {
+    perf->lap(op);
+    cout << "  ";
+    perf->print(cout, perf->sample(perf->nsamples()-1));
+    cout << endl;
+  }
+  } else if (perf) {
+    perf->mark();
   }
 }
@@ -0,0 +1,303 @@
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "AuctAlg.h"
+
+using namespace std;
+
+// Performance regression suite.  Runs a fixed corpus (the cdastest
+// problem shipped with the driver, and generated dense, tied, sparse
+// and multiple row/column problems) and records, for each, the best
+// wall time of the auction over repeated runs, its cycles and bids, the peak resident
+// memory of the run, and the payoff found.
+//
+//   auction_perfsuite -record perf_baseline.dat
+//   auction_perfsuite -check perf_baseline.dat [-noise 0.25]
+//
+// A check fails if the payoff of any problem changes, or if its time,
+// cycles, bids or memory grow by more than the noise fraction over the
+// baseline.  Times are compared in units of a fixed calibration work
+// (a sort), timed between the runs, so that a slower or busier machine
+// is not taken for a slower auction.  Each problem is run in a process
+// of its own, so that its peak memory is its own.
+
+typedef struct PerfResult {
+  double wall;     // best wall time of the auction, in ms
+  double calib;    // best wall time of the calibration work, in ms
+  long cycles;     // auction cycles
+  long bids;       // bids, over all the phases
+  long rss;        // peak resident memory, in KB
+  long payoff;     // total payoff found
+} PerfResult;
+
+static const char* cases[] = {
+  "cdas/auction", "dense1000/auction", "dense1000/auto", "ties600x900/auction",
+  "sparse20000/auction", "sparse20000/auto", "sparse10000x15000/auction",
+  "mult300x200/auction" };
+static const int ncases = sizeof(cases) / sizeof(cases[0]);
+static const int REPS = 5;          // runs of each problem, at least
+static const double BUDGET = 500;   // ms each problem is run for, at least
+
+// A fixed generator, so that the corpus is the same on every platform.
+static unsigned long perf_seed;
+static int perf_rand (int n) {
+  perf_seed = perf_seed * 6364136223846793005UL + 1442695040888963407UL;
+  return (int)((perf_seed >> 33) % n);
+}
+
+// The calibration work: sort a fixed list.
+static double perf_calibrate () {
+  std::vector<int> list(200000);
+  perf_seed = 12345;
+  for (unsigned int i = 0; i < list.size(); i++) list[i] = perf_rand(1000000);
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  std::sort(list.begin(), list.end());
+  return std::chrono::duration<double, std::milli>
+    (std::chrono::steady_clock::now() - t0).count();
+}
+
+// Time the auction on a problem, each run from scratch, and the
+// calibration work between runs.  The best times are kept, of REPS runs
+// or as many as fill the BUDGET: the others were slowed by something
+// else.
+static PerfResult perf_solve (AuctPay& Pay, AuctShape& Sh, AuctParm& Prms) {
+  PerfResult r;
+  AuctAssoc S(Sh);
+  AuctAlg x;
+  AuctMetric metric;
+  double spent = 0;
+  r.wall = r.calib = -1;
+  for (int rep = 0; rep < REPS || spent < BUDGET; rep++) {
+    double cal = perf_calibrate();
+    if (r.calib < 0 || cal < r.calib) r.calib = cal;
+    S.reset(Sh);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    metric = x.auction(Pay, Sh, S, Prms);
+    double ms = std::chrono::duration<double, std::milli>
+      (std::chrono::steady_clock::now() - t0).count();
+    if (r.wall < 0 || ms < r.wall) r.wall = ms;
+    spent += ms + cal;
+  }
+  r.cycles = metric.ncycles();
+  r.bids = 0;
+  for (int i = 0; i < metric.nphases(); i++) r.bids += metric.phase(i).bids;
+  r.payoff = x.totalpay(Pay, Sh, S);
+  r.rss = 0;
+  return r;
+}
+
+static PerfResult perf_dense (int n, int m, int range, int engine,
+			      bool mults) {
+  std::vector<std::vector<double> > values(n, std::vector<double>(m));
+  perf_seed = n * 7919UL + m;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < m; j++) values[i][j] = 1 + perf_rand(range);
+
+  AuctParm Prms;
+  Prms.set_maxcycles(100000000);
+  Prms.set_engine(engine);
+  AuctShape Sh(values);
+  if (mults) {
+    for (int i = 0; i < n; i++) Sh.set_rowmult(i, 1 + perf_rand(3));
+    for (int j = 0; j < m; j++) Sh.set_colmult(j, 1 + perf_rand(3));
+  }
+  Sh.ifcompute();
+  AuctPay Pay(Prms, Sh, values);
+  return perf_solve(Pay, Sh, Prms);
+}
+
+static PerfResult perf_sparse (int n, int m, int k, int range, int engine) {
+  std::vector<int> rowpt(1, 0), ind, val;
+  perf_seed = n * 104729UL + m * 31UL + k;
+  for (int i = 0; i < n; i++) {
+    int first = ind.size(), j;
+    ind.push_back(i % m);  // every row has a partner
+    while ((int)ind.size() - first < k) ind.push_back(perf_rand(m));
+    std::sort(ind.begin() + first, ind.end());
+    ind.erase(std::unique(ind.begin() + first, ind.end()), ind.end());
+    for (j = first; j < (int)ind.size(); j++) val.push_back(1 + perf_rand(range));
+    rowpt.push_back(ind.size());
+  }
+
+  AuctParm Prms;
+  Prms.set_maxcycles(100000000);
+  Prms.set_engine(engine);
+  AuctShape Sh(n, m, ind.size());
+  AuctPay Pay(Prms, Sh, &rowpt[0], &ind[0], &val[0], 0);
+  Sh.ifcompute();
+  return perf_solve(Pay, Sh, Prms);
+}
+
+// The driver's problem, with its multiplicity files and parameters.
+// It is infeasible, so the auction runs out of cycles.
+static PerfResult perf_cdas () {
+  int nrow = 1469, ncol = 6, i, j, mult;
+  std::vector<std::vector<double> > values(nrow, std::vector<double>(ncol));
+  std::ifstream fin("cdastest.dat");
+  for (i = 0; i < nrow; i++) for (j = 0; j < ncol; j++) fin >> values[i][j];
+  if (!fin) {
+    cerr << "Cannot read cdastest.dat" << endl;
+    exit(2);
+  }
+
+  AuctParm Prms;
+  Prms.set_res(1);
+  Prms.set_maxcycles(2000);
+  Prms.set_MAXINT(1000000);
+  Prms.set_engine(AuctParm::ENGINE_AUCTION);
+  AuctShape Sh(values);
+  std::ifstream rmfin("cdasrm.dat"), cmfin("cdascm.dat");
+  for (i = 0; i < nrow && rmfin >> mult; i++) Sh.set_rowmult(i, mult);
+  for (j = 0; j < ncol && cmfin >> mult; j++) Sh.set_colmult(j, mult);
+  Sh.ifcompute();
+  AuctPay Pay(Prms, Sh, values);
+  return perf_solve(Pay, Sh, Prms);
+}
+
+static PerfResult perf_case (int c) {
+  switch (c) {
+  case 0: return perf_cdas();
+  case 1: return perf_dense(1000, 1000, 1000, AuctParm::ENGINE_AUCTION, false);
+  case 2: return perf_dense(1000, 1000, 1000, AuctParm::ENGINE_AUTO, false);
+  case 3: return perf_dense(600, 900, 20, AuctParm::ENGINE_AUCTION, false);
+  case 4: return perf_sparse(20000, 20000, 10, 1000, AuctParm::ENGINE_AUCTION);
+  case 5: return perf_sparse(20000, 20000, 10, 1000, AuctParm::ENGINE_AUTO);
+  case 6: return perf_sparse(10000, 15000, 5, 100000, AuctParm::ENGINE_AUCTION);
+  default: return perf_dense(300, 200, 100, AuctParm::ENGINE_AUCTION, true);
+  }
+}
+
+// Run a problem in a child process, which sends back its result.
+static bool perf_run (int c, PerfResult& r) {
+  int fd[2], status;
+  struct rusage usage;
+  if (pipe(fd) != 0) return false;
+  pid_t pid = fork();
+  if (pid < 0) return false;
+  if (pid == 0) {
+    close(fd[0]);
+    r = perf_case(c);
+    ssize_t n = write(fd[1], &r, sizeof(r));
+    _exit(n == (ssize_t)sizeof(r) ? 0 : 1);
+  }
+  close(fd[1]);
+  ssize_t n = read(fd[0], &r, sizeof(r));
+  close(fd[0]);
+  if (wait4(pid, &status, 0, &usage) != pid) return false;
+  r.rss = usage.ru_maxrss;
+  return n == (ssize_t)sizeof(r) && WIFEXITED(status)
+    && WEXITSTATUS(status) == 0;
+}
+
+// Has a metric grown beyond the noise?  Small absolute changes (timer
+// resolution, a page or two of memory) are never counted.
+static bool perf_worse (double now, double base, double noise, double slack) {
+  return now > base * (1 + noise) && now - base > slack;
+}
+
+int main (int argc, char** argv) {
+  string mode, file;
+  double noise = 0.25;
+  int i, fails = 0;
+
+  for (i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-record" || arg == "-check") && i+1 < argc) {
+      mode = arg;
+      file = argv[++i];
+    } else if (arg == "-noise" && i+1 < argc) {
+      noise = atof(argv[++i]);
+    } else {
+      mode = "";
+      break;
+    }
+  }
+  if (mode == "") {
+    cerr << "usage: " << argv[0] << " -record FILE | -check FILE"
+	 << " [-noise FRACTION]" << endl;
+    return 2;
+  }
+
+  // The baseline: one line per problem, after a comment.
+  std::map<string, PerfResult> base;
+  if (mode == "-check") {
+    std::ifstream bin(file.c_str());
+    string line, name;
+    if (!bin) {
+      cerr << "Cannot read baseline " << file << endl;
+      return 2;
+    }
+    while (std::getline(bin, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream in(line);
+      PerfResult b;
+      if (in >> name >> b.wall >> b.calib >> b.cycles >> b.bids >> b.rss
+	  >> b.payoff)
+	base[name] = b;
+    }
+  }
+
+  std::ostringstream out;
+  out << "# auction_perfsuite baseline" << endl
+      << "# case wall_ms calib_ms cycles bids rss_kb payoff" << endl;
+  for (int c = 0; c < ncases; c++) {
+    PerfResult r;
+    if (!perf_run(c, r)) {
+      cout << cases[c] << ": FAILED to run" << endl;
+      fails++;
+      continue;
+    }
+    out << cases[c] << " " << r.wall << " " << r.calib << " " << r.cycles << " " << r.bids
+	<< " " << r.rss << " " << r.payoff << endl;
+    cout << cases[c] << ": " << r.wall << "ms (" << r.wall / r.calib
+	 << " calibrations), " << r.cycles << " cycles, "
+	 << r.bids << " bids, " << r.rss << "KB, payoff " << r.payoff;
+    if (mode == "-check") {
+      if (base.find(cases[c]) == base.end()) {
+	cout << " (not in baseline)" << endl;
+	continue;
+      }
+      PerfResult& b = base[cases[c]];
+      std::ostringstream why;
+      if (r.payoff != b.payoff) why << " payoff was " << b.payoff << ";";
+      double scale = r.calib / b.calib;  // speed of the machine
+      if (perf_worse(r.wall / scale, b.wall, noise, 1))
+	why << " time x" << r.wall / scale / b.wall << ";";
+      if (perf_worse(r.cycles, b.cycles, noise, 0))
+	why << " cycles x" << (double)r.cycles / b.cycles << ";";
+      if (perf_worse(r.bids, b.bids, noise, 0))
+	why << " bids x" << (double)r.bids / b.bids << ";";
+      if (perf_worse(r.rss, b.rss, noise, 1024))
+	why << " memory x" << (double)r.rss / b.rss << ";";
+      if (why.str().empty()) {
+	cout << " ok";
+      } else {
+	cout << " REGRESSED:" << why.str();
+	fails++;
+      }
+    }
+    cout << endl;
+  }
+
+  if (mode == "-record") {
+    std::ofstream bout(file.c_str());
+    bout << out.str();
+    if (!bout) {
+      cerr << "Cannot write baseline " << file << endl;
+      return 2;
+    }
+    cout << "Baseline written to " << file << endl;
+  } else {
+    cout << fails << " of " << ncases << " problems regressed (noise "
+	 << noise << ")" << endl;
+  }
+  return fails ? 1 : 0;
+}
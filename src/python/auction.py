@@ -0,0 +1,79 @@
+"""Python interface to the auction assignment solver.
+
+    from auction import auction
+    assign, prices, metric = auction(payoff)
+
+The payoff is a scipy.sparse matrix or a 2-D NumPy array, and the
+assignment maximizes the total payoff.  A CSR matrix with int32
+indices and float64 (or int32) data is passed to the solver without
+copying; other inputs are converted first.
+"""
+
+import numpy as np
+import _auction
+
+PHASE_DTYPE = np.dtype([('epsilon', np.float64), ('cycles', np.int32),
+                        ('bids', np.int32), ('epsfac', np.int32),
+                        ('decision', np.int32)])
+
+ENGINES = ['auto', 'auction', 'jv', 'jvsp']
+ENGINE_REASONS = ['requested', 'cost', 'density', 'options']
+
+
+def _csr_buffers(payoff, dontcare):
+    """Return (nrows, ncols, indptr, indices, data) of a zero based CSR
+    payoff, as contiguous int32/int32/(float64 or int32) arrays, which
+    are views of the input wherever its types allow."""
+    if hasattr(payoff, 'tocsr'):                    # scipy.sparse
+        csr = payoff.tocsr()
+        nrows, ncols = csr.shape
+        indptr, indices, data = csr.indptr, csr.indices, csr.data
+    else:
+        dense = np.asarray(payoff)
+        if dense.ndim != 2:
+            raise ValueError("payoff must be 2-D")
+        nrows, ncols = dense.shape
+        keep = dense != dontcare
+        indptr = np.concatenate(([0], np.cumsum(keep.sum(axis=1))))
+        indices = np.nonzero(keep)[1]
+        data = dense[keep]
+    indptr = np.ascontiguousarray(indptr, dtype=np.int32)
+    indices = np.ascontiguousarray(indices, dtype=np.int32)
+    if data.dtype != np.int32:
+        data = np.ascontiguousarray(data, dtype=np.float64)
+    else:
+        data = np.ascontiguousarray(data)
+    return nrows, ncols, indptr, indices, data
+
+
+def auction(payoff, dontcare=0, **params):
+    """Find the assignment of rows to columns with the largest payoff.
+
+    payoff   -- scipy.sparse matrix (entries not stored are excluded), or
+                2-D array (entries equal to dontcare are excluded)
+    dontcare -- value of the excluded entries of a dense payoff
+    params   -- AuctParm settings: maxcycles, epsstart, epsfac, res,
+                escale, adaptive, floating, tolerance, prunek, nthreads,
+                timelimit (ms), engine ('auto', 'auction', 'jv' or 'jvsp').  A
+                float payoff is auctioned in floating point unless
+                floating=False.
+
+    Returns (assign, prices, metric): the column of each row (-1 if
+    none), the prices of the columns (or of the rows, if
+    metric['reoriented']) in payoff units, and the AuctMetric as a
+    dict, with its epsilon-scaling phases as a structured array, and
+    the engine run and the reason for it by name.
+    The GIL is released while the auction runs.
+    """
+    nrows, ncols, indptr, indices, data = _csr_buffers(payoff, dontcare)
+    if isinstance(params.get('engine'), str):
+        params['engine'] = ENGINES.index(params['engine'])
+    assign = np.empty(nrows, dtype=np.int32)
+    prices = np.zeros(max(nrows, ncols), dtype=np.float64)
+    metric = _auction.solve(nrows, ncols, indptr, indices, data,
+                            assign, prices, **params)
+    prices = prices[:nrows if metric['reoriented'] else ncols]
+    metric['phases'] = np.array(metric['phases'], dtype=PHASE_DTYPE)
+    metric['engine'] = ENGINES[metric['engine']]
+    metric['engine_reason'] = ENGINE_REASONS[metric['engine_reason']]
+    return assign, prices, metric
@@ -0,0 +1,204 @@
+// Python extension module "_auction", the C++ side of auction.py.
+//
+// The payoff is passed as the three buffers of a zero based compressed
+// row matrix (as in scipy.sparse.csr_matrix), which are wrapped by an
+// AuctPay view and not copied.  The results are written into output
+// buffers allocated by the caller.  Only the buffer protocol is used,
+// so the module does not need NumPy to build.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "AuctAlg.h"
+
+// A contiguous buffer, released when it goes out of scope.
+class PyBuf {
+ public:
+  Py_buffer view;
+  bool held;
+
+  PyBuf () { held = false; }
+  ~PyBuf () { if (held) PyBuffer_Release(&view); }
+
+  // Get the buffer of obj.  Its items must be of kind 'i' (int32) or
+  // 'd' (float64), or either if kind is 0.
+  bool get (PyObject* obj, char kind, bool writable, const char* name) {
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+    if (writable) flags |= PyBUF_WRITABLE;
+    if (PyObject_GetBuffer(obj, &view, flags) != 0) return false;
+    held = true;
+    if ((kind == 0 && type() == 0) || (kind != 0 && type() != kind)) {
+      PyErr_Format(PyExc_TypeError, "%s must be a contiguous %s array", name,
+		   kind == 'i' ? "int32" : kind == 'd' ? "float64"
+		   : "int32 or float64");
+      return false;
+    }
+    return true;
+  }
+
+  // The kind of the items: 'i', 'd', or 0 if neither.
+  char type () {
+    const char* f = view.format ? view.format : "B";
+    if (f[0] == '<' || f[0] == '=' || f[0] == '@') f++;
+    if (view.itemsize == 4 && (f[0] == 'i' || f[0] == 'l')) return 'i';
+    if (view.itemsize == 8 && f[0] == 'd') return 'd';
+    return 0;
+  }
+
+  Py_ssize_t len () { return view.len / view.itemsize; }
+};
+
+static PyObject* metric_dict (AuctMetric& m) {
+  PyObject* phases = PyList_New(m.nphases());
+  for (int i = 0; i < m.nphases(); i++) {
+    AuctMetric::EpsPhase p = m.phase(i);
+    PyList_SET_ITEM(phases, i, Py_BuildValue("(diiii)", p.epsilon, p.cycles,
+					     p.bids, p.epsfac, p.decision));
+  }
+  return Py_BuildValue("{s:i,s:i,s:i,s:i,s:O,s:O,s:O,s:O,s:O,s:d,s:i,s:i,s:i,"
+		       "s:i,s:i,s:N}",
+		       "cycles", m.ncycles(),
+		       "nassoc", m.ntotal_assoc(),
+		       "nmaxassoc", m.nmaxassoc(),
+		       "nauction_assoc", m.nauction_assoc(),
+		       "optimal", m.isoptimal() ? Py_True : Py_False,
+		       "timed_out", m.timed_out() ? Py_True : Py_False,
+		       "expired", m.expired() ? Py_True : Py_False,
+		       "failed", m.failed() ? Py_True : Py_False,
+		       "reoriented", m.reoriented() ? Py_True : Py_False,
+		       "gap", m.gap(),
+		       "npruned", m.npruned(),
+		       "nreadmitted", m.nreadmitted(),
+		       "nallocs", m.nallocs(),
+		       "engine", m.engine(),
+		       "engine_reason", m.engine_reason(),
+		       "phases", phases);
+}
+
+PyDoc_STRVAR(solve_doc,
+"solve(nrows, ncols, indptr, indices, data, assign, prices, **params)\n\n"
+"Run the auction on a zero based CSR payoff (int32 indptr and indices,\n"
+"float64 or int32 data), used in place.  The column of each row is\n"
+"written to assign (int32, nrows long, -1 if none), and the prices of\n"
+"the columns, or of the rows if the auction was reoriented, to prices\n"
+"(float64, at least max(nrows, ncols) long), in payoff units.  The\n"
+"keyword parameters are those of AuctParm.  The GIL is released while\n"
+"the auction runs.  Returns the AuctMetric as a dict.");
+
+static PyObject* solve (PyObject* self, PyObject* args, PyObject* kwds) {
+  static const char* kwlist[] = {"nrows", "ncols", "indptr", "indices", "data",
+				 "assign", "prices", "maxcycles", "epsstart",
+				 "epsfac", "res", "escale", "adaptive",
+				 "floating", "tolerance", "prunek", "nthreads",
+				 "timelimit", "engine", NULL};
+  int N, M, i;
+  PyObject *optr, *oind, *oval, *oassign, *oprice;
+  int maxcycles = 1000000, epsfac = 5, prunek = 0, nthreads = 1;
+  int engine = AuctParm::ENGINE_AUTO;
+  double epsstart = 5, res = 1, tolerance = 0, timelimit = 0;
+  int escale = 1, adaptive = 0, floating = -1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "iiOOOOO|ididpppdiidi",
+				   (char**)kwlist, &N, &M, &optr, &oind, &oval,
+				   &oassign, &oprice, &maxcycles, &epsstart,
+				   &epsfac, &res, &escale, &adaptive,
+				   &floating, &tolerance, &prunek, &nthreads,
+				   &timelimit, &engine))
+    return NULL;
+
+  PyBuf ptr, ind, val, assign, price;
+  if (!ptr.get(optr, 'i', false, "indptr") ||
+      !ind.get(oind, 'i', false, "indices") ||
+      !val.get(oval, 0, false, "data") ||
+      !assign.get(oassign, 'i', true, "assign") ||
+      !price.get(oprice, 'd', true, "prices"))
+    return NULL;
+
+  int *rowpt = (int*)ptr.view.buf, *cols = (int*)ind.view.buf;
+  if (N < 0 || M < 0 || ptr.len() != N+1 || rowpt[0] != 0 ||
+      ind.len() < rowpt[N] || val.len() < rowpt[N]) {
+    PyErr_SetString(PyExc_ValueError, "inconsistent CSR payoff");
+    return NULL;
+  }
+  for (i = 0; i < N; i++) {
+    if (rowpt[i] > rowpt[i+1]) {
+      PyErr_SetString(PyExc_ValueError, "indptr must not decrease");
+      return NULL;
+    }
+  }
+  for (i = 0; i < rowpt[N]; i++) {
+    if (cols[i] < 0 || cols[i] >= M) {
+      PyErr_SetString(PyExc_ValueError, "column index out of range");
+      return NULL;
+    }
+  }
+  if (assign.len() < N || price.len() < std::max(N, M)) {
+    PyErr_SetString(PyExc_ValueError, "output arrays are too short");
+    return NULL;
+  }
+
+  // Float payoffs are auctioned in floating point unless asked not to.
+  AuctParm P;
+  P.set_maxcycles(maxcycles);
+  P.set_epsstart(epsstart);
+  P.set_epsfac(epsfac);
+  P.set_res(res);
+  if (!escale) P.set_EScale(false);
+  P.set_epsadaptive(adaptive);
+  P.set_floating(floating == -1 ? val.type() == 'd' : floating);
+  P.set_tolerance(tolerance);
+  P.set_prunek(prunek);
+  P.set_nthreads(nthreads);
+  P.set_timelimit(timelimit);
+  P.set_engine(engine);
+
+  AuctShape Sh(N, M, rowpt[N]);
+  AuctPay *Pay;
+  if (val.type() == 'd')
+    Pay = new AuctPay(P, Sh, rowpt, cols, (double*)val.view.buf, 0);
+  else
+    Pay = new AuctPay(P, Sh, rowpt, cols, (int*)val.view.buf, 0);
+  Sh.ifcompute();
+  AuctAssoc S(Sh);
+  AuctAlg alg;
+  AuctMetric metric;
+
+  Py_BEGIN_ALLOW_THREADS
+  metric = alg.auction(*Pay, Sh, S, P);
+  Py_END_ALLOW_THREADS
+
+  // The floating point auction leaves its prices in the workspace; the
+  // others leave them in S, in internal units, as the column prices or
+  // (if reoriented) the row profits.
+  int *out = (int*)assign.view.buf;
+  double *prices = (double*)price.view.buf;
+  int nobj = metric.reoriented() ? N : M;
+  for (i = 0; i < N; i++) out[i] = S.col(i);
+  if (P.floating() && Pay->has_fvalues() &&
+      alg.workspace().dget(AuctWorkspace::DPRICE)) {
+    std::copy (alg.workspace().dget(AuctWorkspace::DPRICE),
+	       alg.workspace().dget(AuctWorkspace::DPRICE) + nobj, prices);
+  } else if (N > 0 && M > 0) {
+    std::vector<int> p(nobj);
+    if (metric.reoriented()) S.get_profits(&p[0]);
+    else S.get_prices(&p[0]);
+    for (i = 0; i < nobj; i++) prices[i] = p[i] * res / (std::min(N, M) + 1);
+  }
+  delete Pay;
+
+  return metric_dict(metric);
+}
+
+static PyMethodDef methods[] = {
+  {"solve", (PyCFunction)(void(*)(void))solve, METH_VARARGS | METH_KEYWORDS,
+   solve_doc},
+  {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef module = {
+  PyModuleDef_HEAD_INIT, "_auction",
+  "Auction assignment solver (see auction.py).", -1, methods
+};
+
+PyMODINIT_FUNC PyInit__auction (void) {
+  return PyModule_Create(&module);
+}
@@ -0,0 +1,20 @@
+# Build the Python bindings in place:
+#     python3 setup.py build_ext --inplace
+
+from setuptools import setup, Extension
+
+lib = ['AssocMatrix.cpp', 'AuctAssoc.cpp', 'AuctAlg.cpp', 'AuctWorkspace.cpp',
+       'AuctKBest.cpp', 'AuctShard.cpp', 'AuctSocketTransport.cpp',
+       'AuctTrace.cpp', 'AuctPerf.cpp', 'AuctTelemetry.cpp']
+
+setup(name='auction',
+      version='0.1',
+      description='Auction assignment solver',
+      py_modules=['auction'],
+      ext_modules=[Extension('_auction',
+                             sources=['auctionmodule.cpp'] +
+                             ['../auction/' + f for f in lib],
+                             include_dirs=['../auction'],
+                             extra_compile_args=['-pthread'],
+                             extra_link_args=['-pthread'],
+                             language='c++')])